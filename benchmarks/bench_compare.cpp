@@ -0,0 +1,326 @@
+// bench_compare.cpp — Statistical regression check between two result files
+//
+// Compares a baseline and a candidate result file metric by metric and exits
+// non-zero when any metric regressed, so it can gate pre-merge scripts:
+//
+//   bench_compare base.json cand.json [--threshold 5] [--alpha 0.05]
+//                 [--metric-threshold throughput_jobs_per_s=3,jain_fairness_index=1]
+//                 [--metrics a,b,c] [--out report.json]
+//
+// Accepted inputs:
+//   * job_system benchmark JSON: {"directions": {...}, "runs": [{"metrics": {...}}]}
+//     (loadgen and the other standalone benchmarks); each run is one sample.
+//   * Google Benchmark JSON (job_system_microbench --benchmark_out=...);
+//     repetitions of the same benchmark are samples, aggregates are ignored.
+//
+// For each metric the tool reports the baseline and candidate medians, the
+// relative change with a 95% bootstrap confidence interval, and a two-sided
+// Mann-Whitney U p-value. A metric regresses when it moves in its "worse"
+// direction by more than its threshold and — when the sample sizes can reach
+// --alpha at all — the change is significant at --alpha. With fewer samples
+// (e.g. 3 vs 3, whose smallest p is ~0.08) only the threshold applies.
+//
+// Exit codes: 0 = no regression, 1 = regression detected, 2 = usage/input error.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+
+using bench::Json;
+
+namespace {
+
+enum class Direction { HIGHER, LOWER, INFO };
+
+struct MetricSamples {
+    Direction direction{Direction::LOWER};
+    std::vector<double> values;
+};
+
+using SampleSet = std::map<std::string, MetricSamples>;
+
+Direction infer_direction(const std::string& name) {
+    static const char* higher[] = {"per_s", "throughput", "goodput", "jain",
+                                   "fairness", "items_per_second",
+                                   "bytes_per_second", "speedup", "efficiency"};
+    for (const char* h : higher)
+        if (name.find(h) != std::string::npos) return Direction::HIGHER;
+    return Direction::LOWER;
+}
+
+Direction parse_direction(const std::string& s, const std::string& name) {
+    if (s == "higher") return Direction::HIGHER;
+    if (s == "lower")  return Direction::LOWER;
+    if (s == "info")   return Direction::INFO;
+    return infer_direction(name);
+}
+
+// job_system benchmark format
+void load_runs(const Json& doc, SampleSet& out) {
+    const Json* directions = doc.find("directions");
+    for (const auto& run : doc.at("runs").as_array()) {
+        for (const auto& [name, value] : run.at("metrics").as_object()) {
+            if (!value.is_number()) continue;
+            auto& m = out[name];
+            m.direction = directions && directions->find(name)
+                              ? parse_direction(directions->at(name).as_string(), name)
+                              : infer_direction(name);
+            m.values.push_back(value.as_number());
+        }
+    }
+}
+
+// Google Benchmark format: one sample per repetition of each benchmark
+void load_google_benchmark(const Json& doc, SampleSet& out) {
+    for (const auto& b : doc.at("benchmarks").as_array()) {
+        if (b.string_or("run_type", "iteration") != "iteration") continue;
+        const std::string name = b.string_or("run_name", b.at("name").as_string());
+        auto add = [&](const std::string& key, Direction dir) {
+            if (const Json* v = b.find(key); v && v->is_number()) {
+                auto& m = out[name + ":" + key];
+                m.direction = dir;
+                m.values.push_back(v->as_number());
+            }
+        };
+        add("real_time", Direction::LOWER);
+        add("cpu_time", Direction::LOWER);
+        add("items_per_second", Direction::HIGHER);
+        add("bytes_per_second", Direction::HIGHER);
+    }
+}
+
+SampleSet load_samples(const std::string& path) {
+    Json doc = Json::parse_file(path);
+    SampleSet out;
+    if (doc.contains("runs")) {
+        load_runs(doc, out);
+    } else if (doc.contains("benchmarks")) {
+        load_google_benchmark(doc, out);
+    } else {
+        throw std::runtime_error(path + ": neither \"runs\" nor \"benchmarks\" found");
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------------
+
+double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+double relative_change(double base, double cand) {
+    if (base == 0.0) return cand == 0.0 ? 0.0 : (cand > 0 ? INFINITY : -INFINITY);
+    return (cand - base) / std::fabs(base);
+}
+
+// 95% percentile-bootstrap interval of the relative change of medians
+std::pair<double, double> bootstrap_ci(const std::vector<double>& a,
+                                       const std::vector<double>& b) {
+    constexpr int RESAMPLES = 2000;
+    std::mt19937_64 rng(0x5eed);
+    std::vector<double> diffs;
+    diffs.reserve(RESAMPLES);
+    std::vector<double> ra(a.size()), rb(b.size());
+    std::uniform_int_distribution<size_t> pick_a(0, a.size() - 1), pick_b(0, b.size() - 1);
+    for (int r = 0; r < RESAMPLES; ++r) {
+        for (auto& x : ra) x = a[pick_a(rng)];
+        for (auto& x : rb) x = b[pick_b(rng)];
+        diffs.push_back(relative_change(median(ra), median(rb)));
+    }
+    std::sort(diffs.begin(), diffs.end());
+    return {diffs[static_cast<size_t>(0.025 * (RESAMPLES - 1))],
+            diffs[static_cast<size_t>(0.975 * (RESAMPLES - 1))]};
+}
+
+// Two-sided Mann-Whitney U test, normal approximation with tie correction
+double mann_whitney_p(const std::vector<double>& a, const std::vector<double>& b) {
+    const size_t n1 = a.size(), n2 = b.size();
+    std::vector<std::pair<double, int>> all;
+    for (double x : a) all.emplace_back(x, 0);
+    for (double x : b) all.emplace_back(x, 1);
+    std::sort(all.begin(), all.end());
+
+    double rank_sum_a = 0.0, tie_term = 0.0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) ++j;
+        const double avg_rank = 0.5 * static_cast<double>(i + j + 1); // 1-based
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        for (size_t k = i; k < j; ++k)
+            if (all[k].second == 0) rank_sum_a += avg_rank;
+        i = j;
+    }
+
+    const double dn1 = static_cast<double>(n1), dn2 = static_cast<double>(n2);
+    const double n = dn1 + dn2;
+    const double u = rank_sum_a - dn1 * (dn1 + 1) / 2.0;
+    const double mean_u = dn1 * dn2 / 2.0;
+    const double var_u = dn1 * dn2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+    if (var_u <= 0.0) return 1.0; // all samples identical
+    const double z = (std::fabs(u - mean_u) - 0.5) / std::sqrt(var_u); // continuity
+    return std::erfc(std::max(0.0, z) / std::sqrt(2.0));
+}
+
+// Smallest p mann_whitney_p() can return for these sample sizes: complete
+// separation, no ties
+double mann_whitney_min_p(size_t n1, size_t n2) {
+    const double dn1 = static_cast<double>(n1), dn2 = static_cast<double>(n2);
+    const double sd_u = std::sqrt(dn1 * dn2 * (dn1 + dn2 + 1) / 12.0);
+    if (sd_u <= 0.0) return 1.0;
+    return std::erfc(std::max(0.0, (dn1 * dn2 / 2.0 - 0.5) / sd_u) / std::sqrt(2.0));
+}
+
+std::map<std::string, double> parse_thresholds(const std::string& spec) {
+    std::map<std::string, double> out;
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t comma = spec.find(',', start);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string item = spec.substr(start, comma - start);
+        const size_t eq = item.find('=');
+        if (eq == std::string::npos)
+            throw std::invalid_argument("bad --metric-threshold entry: " + item);
+        out[item.substr(0, eq)] = std::stod(item.substr(eq + 1));
+        start = comma + 1;
+    }
+    return out;
+}
+
+std::set<std::string> parse_list(const std::string& spec) {
+    std::set<std::string> out;
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t comma = spec.find(',', start);
+        if (comma == std::string::npos) comma = spec.size();
+        if (comma > start) out.insert(spec.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    if (args.positional().size() != 2) {
+        std::cerr << "usage: bench_compare <baseline.json> <candidate.json>"
+                     " [--threshold pct] [--alpha p] [--metric-threshold m=pct,...]"
+                     " [--metrics m1,m2] [--out report.json]\n";
+        return 2;
+    }
+
+    SampleSet base, cand;
+    std::map<std::string, double> per_metric;
+    std::set<std::string> only;
+    try {
+        base = load_samples(args.positional()[0]);
+        cand = load_samples(args.positional()[1]);
+        per_metric = parse_thresholds(args.get("metric-threshold"));
+        only = parse_list(args.get("metrics"));
+    } catch (const std::exception& e) {
+        std::cerr << "bench_compare: " << e.what() << "\n";
+        return 2;
+    }
+    const double default_threshold = args.get_double("threshold", 5.0) / 100.0;
+    const double alpha = args.get_double("alpha", 0.05);
+
+    std::cout << "\n=== Benchmark Comparison (threshold " << default_threshold * 100
+              << "%, alpha " << alpha << ") ===\n\n";
+    std::cout << std::left << std::setw(44) << "Metric" << std::right
+              << std::setw(5) << "n"
+              << std::setw(14) << "Base med"
+              << std::setw(14) << "Cand med"
+              << std::setw(10) << "Change"
+              << std::setw(22) << "95% CI"
+              << std::setw(9) << "p"
+              << "  Verdict\n";
+    std::cout << std::string(128, '-') << "\n";
+
+    Json report = Json::object();
+    report["baseline"]  = args.positional()[0];
+    report["candidate"] = args.positional()[1];
+    report["metrics"]   = Json::object();
+    int regressions = 0;
+
+    for (const auto& [name, b] : base) {
+        if (!only.empty() && !only.contains(name)) continue;
+        auto it = cand.find(name);
+        if (it == cand.end() || b.values.empty() || it->second.values.empty()) continue;
+        const auto& c = it->second;
+
+        const double med_b = median(b.values);
+        const double med_c = median(c.values);
+        const double change = relative_change(med_b, med_c);
+        const auto [ci_lo, ci_hi] = bootstrap_ci(b.values, c.values);
+        // A test that cannot reach alpha would veto every verdict
+        const bool testable = mann_whitney_min_p(b.values.size(), c.values.size()) < alpha;
+        const double p = testable ? mann_whitney_p(b.values, c.values) : 1.0;
+        const double threshold = per_metric.contains(name) ? per_metric[name] / 100.0
+                                                           : default_threshold;
+
+        // Positive `worse` means the candidate moved in the bad direction
+        const double worse = b.direction == Direction::HIGHER ? -change : change;
+        std::string verdict = "ok";
+        if (b.direction == Direction::INFO) {
+            verdict = "info";
+        } else if (worse > threshold && (!testable || p < alpha)) {
+            verdict = "REGRESSION";
+            ++regressions;
+        } else if (-worse > threshold && (!testable || p < alpha)) {
+            verdict = "improved";
+        } else if (std::fabs(worse) > threshold) {
+            verdict = "noise";
+        }
+
+        std::ostringstream ci;
+        ci << std::fixed << std::setprecision(1) << "[" << ci_lo * 100 << "%, "
+           << ci_hi * 100 << "%]";
+        std::cout << std::left << std::setw(44) << name.substr(0, 43) << std::right
+                  << std::setw(5) << std::min(b.values.size(), c.values.size())
+                  << std::setw(14) << std::setprecision(4) << std::defaultfloat << med_b
+                  << std::setw(14) << med_c
+                  << std::setw(9) << std::fixed << std::setprecision(1) << change * 100 << "%"
+                  << std::setw(22) << ci.str()
+                  << std::setw(9) << std::setprecision(3)
+                  << (testable ? p : std::nan(""))
+                  << "  " << verdict << "\n";
+
+        Json m = Json::object();
+        m["direction"] = b.direction == Direction::HIGHER  ? "higher"
+                         : b.direction == Direction::LOWER ? "lower"
+                                                           : "info";
+        m["baseline_samples"]  = b.values.size();
+        m["candidate_samples"] = c.values.size();
+        m["baseline_median"]   = med_b;
+        m["candidate_median"]  = med_c;
+        m["relative_change"]   = change;
+        m["ci95_low"]          = ci_lo;
+        m["ci95_high"]         = ci_hi;
+        m["p_value"]           = testable ? Json(p) : Json(nullptr);
+        m["threshold"]         = threshold;
+        m["verdict"]           = verdict;
+        report["metrics"][name] = std::move(m);
+    }
+
+    report["regressions"] = regressions;
+    std::cout << "\n" << regressions << " regression(s)\n";
+    if (args.has("out")) report.write_file(args.get("out"));
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+// bench_util.h — Small helpers shared by the standalone benchmark programs:
+// command-line parsing, busy-wait work simulation and name ↔ enum mapping.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "job_system/client_state.h"
+#include "job_system/drr_policy.h"
+#include "job_system/job.h"
+#include "job_system/scheduling_policy.h"
+#include "job_system/wrr_policy.h"
+
+namespace bench {
+
+// ---------------------------------------------------------------------------
+// Command line: --key value, --key=value and bare --flag
+// ---------------------------------------------------------------------------
+class Args {
+public:
+    Args(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a.rfind("--", 0) != 0) {
+                positional_.push_back(a);
+                continue;
+            }
+            a.erase(0, 2);
+            auto eq = a.find('=');
+            if (eq != std::string::npos) {
+                values_[a.substr(0, eq)] = a.substr(eq + 1);
+            } else if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                values_[a] = argv[++i];
+            } else {
+                values_[a] = "";
+            }
+        }
+    }
+
+    bool has(const std::string& key) const { return values_.contains(key); }
+
+    std::string get(const std::string& key, const std::string& fallback = "") const {
+        auto it = values_.find(key);
+        return it == values_.end() ? fallback : it->second;
+    }
+
+    double get_double(const std::string& key, double fallback) const {
+        auto it = values_.find(key);
+        return it == values_.end() || it->second.empty() ? fallback
+                                                         : std::stod(it->second);
+    }
+
+    int64_t get_int(const std::string& key, int64_t fallback) const {
+        auto it = values_.find(key);
+        return it == values_.end() || it->second.empty() ? fallback
+                                                         : std::stoll(it->second);
+    }
+
+    // Comma-separated integer list, e.g. --workers 1,2,4,8
+    std::vector<int64_t> get_int_list(const std::string& key,
+                                      std::vector<int64_t> fallback) const {
+        auto it = values_.find(key);
+        if (it == values_.end() || it->second.empty()) return fallback;
+        std::vector<int64_t> out;
+        size_t start = 0;
+        const std::string& s = it->second;
+        while (start <= s.size()) {
+            size_t comma = s.find(',', start);
+            if (comma == std::string::npos) comma = s.size();
+            if (comma > start) out.push_back(std::stoll(s.substr(start, comma - start)));
+            start = comma + 1;
+        }
+        return out;
+    }
+
+    const std::vector<std::string>& positional() const { return positional_; }
+
+private:
+    std::unordered_map<std::string, std::string> values_;
+    std::vector<std::string> positional_;
+};
+
+// ---------------------------------------------------------------------------
+// Work simulation
+// ---------------------------------------------------------------------------
+
+// Busy-waits for `d` to simulate compute-bound work of a known duration
+inline void spin_for(std::chrono::nanoseconds d) {
+    const auto end = std::chrono::steady_clock::now() + d;
+    while (std::chrono::steady_clock::now() < end) {
+        // busy wait
+    }
+}
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// ---------------------------------------------------------------------------
+// Name ↔ enum mapping
+// ---------------------------------------------------------------------------
+
+inline std::string lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+inline std::unique_ptr<job_system::ISchedulingPolicy>
+make_policy(const std::string& name, uint32_t drr_quantum = 100) {
+    const std::string n = lower(name);
+    if (n == "wrr") return std::make_unique<job_system::WeightedRoundRobinPolicy>();
+    if (n == "drr") return std::make_unique<job_system::DeficitRoundRobinPolicy>(drr_quantum);
+    throw std::invalid_argument("Unknown policy: " + name);
+}
+
+inline job_system::OverflowStrategy parse_overflow(const std::string& name) {
+    using job_system::OverflowStrategy;
+    const std::string n = lower(name);
+    if (n == "reject")      return OverflowStrategy::REJECT;
+    if (n == "block")       return OverflowStrategy::BLOCK;
+    if (n == "drop_oldest") return OverflowStrategy::DROP_OLDEST;
+    if (n == "drop_newest") return OverflowStrategy::DROP_NEWEST;
+    if (n == "caller_runs") return OverflowStrategy::CALLER_RUNS;
+    throw std::invalid_argument("Unknown overflow strategy: " + name);
+}
+
+inline const char* overflow_name(job_system::OverflowStrategy s) {
+    using job_system::OverflowStrategy;
+    switch (s) {
+    case OverflowStrategy::REJECT:      return "REJECT";
+    case OverflowStrategy::BLOCK:       return "BLOCK";
+    case OverflowStrategy::DROP_OLDEST: return "DROP_OLDEST";
+    case OverflowStrategy::DROP_NEWEST: return "DROP_NEWEST";
+    case OverflowStrategy::CALLER_RUNS: return "CALLER_RUNS";
+    }
+    return "?";
+}
+
+inline job_system::Priority parse_priority(const std::string& name) {
+    using job_system::Priority;
+    const std::string n = lower(name);
+    if (n == "low")      return Priority::LOW;
+    if (n == "normal")   return Priority::NORMAL;
+    if (n == "high")     return Priority::HIGH;
+    if (n == "critical") return Priority::CRITICAL;
+    throw std::invalid_argument("Unknown priority: " + name);
+}
+
+inline const char* priority_name(job_system::Priority p) {
+    static const char* names[] = {"LOW", "NORMAL", "HIGH", "CRITICAL"};
+    return names[static_cast<size_t>(p)];
+}
+
+// Jain index over arbitrary samples: (Σx)² / (n·Σx²)
+inline double jain_index(const std::vector<double>& xs) {
+    double sum = 0.0, sum_sq = 0.0;
+    for (double x : xs) {
+        sum += x;
+        sum_sq += x * x;
+    }
+    if (xs.empty() || sum_sq == 0.0) return 1.0;
+    return (sum * sum) / (static_cast<double>(xs.size()) * sum_sq);
+}
+
+} // namespace bench
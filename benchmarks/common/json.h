@@ -0,0 +1,352 @@
+#pragma once
+
+// json.h — Minimal JSON value, parser and writer for benchmark configs and
+// machine-readable results. Header-only; not part of the job_system library.
+//
+// Objects keep insertion order so emitted results read in the order they
+// were produced. Numbers are stored as double.
+
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace bench {
+
+class Json {
+public:
+    using Array  = std::vector<Json>;
+    using Object = std::vector<std::pair<std::string, Json>>;
+
+    Json() = default;
+    Json(std::nullptr_t) {}
+    Json(bool b) : value_(b) {}
+    Json(double d) : value_(d) {}
+    Json(int i) : value_(static_cast<double>(i)) {}
+    Json(long i) : value_(static_cast<double>(i)) {}
+    Json(long long i) : value_(static_cast<double>(i)) {}
+    Json(unsigned i) : value_(static_cast<double>(i)) {}
+    Json(unsigned long i) : value_(static_cast<double>(i)) {}
+    Json(unsigned long long i) : value_(static_cast<double>(i)) {}
+    Json(const char* s) : value_(std::string(s)) {}
+    Json(std::string s) : value_(std::move(s)) {}
+    Json(Array a) : value_(std::move(a)) {}
+    Json(Object o) : value_(std::move(o)) {}
+
+    static Json array() { return Json(Array{}); }
+    static Json object() { return Json(Object{}); }
+
+    bool is_null() const   { return std::holds_alternative<std::monostate>(value_); }
+    bool is_bool() const   { return std::holds_alternative<bool>(value_); }
+    bool is_number() const { return std::holds_alternative<double>(value_); }
+    bool is_string() const { return std::holds_alternative<std::string>(value_); }
+    bool is_array() const  { return std::holds_alternative<Array>(value_); }
+    bool is_object() const { return std::holds_alternative<Object>(value_); }
+
+    bool as_bool() const { return get<bool>("bool"); }
+    double as_number() const { return get<double>("number"); }
+    const std::string& as_string() const { return get<std::string>("string"); }
+    const Array& as_array() const { return get<Array>("array"); }
+    Array& as_array() { return get<Array>("array"); }
+    const Object& as_object() const { return get<Object>("object"); }
+    Object& as_object() { return get<Object>("object"); }
+
+    // Object access. operator[] inserts (converting null to an object).
+    Json& operator[](const std::string& key) {
+        if (is_null()) value_ = Object{};
+        auto& obj = as_object();
+        for (auto& [k, v] : obj)
+            if (k == key) return v;
+        obj.emplace_back(key, Json{});
+        return obj.back().second;
+    }
+
+    const Json* find(const std::string& key) const {
+        if (!is_object()) return nullptr;
+        for (const auto& [k, v] : as_object())
+            if (k == key) return &v;
+        return nullptr;
+    }
+
+    bool contains(const std::string& key) const { return find(key) != nullptr; }
+
+    const Json& at(const std::string& key) const {
+        if (const Json* v = find(key)) return *v;
+        throw std::runtime_error("JSON: missing key '" + key + "'");
+    }
+
+    // Typed lookups with defaults for optional config fields
+    double number_or(const std::string& key, double fallback) const {
+        const Json* v = find(key);
+        return v && v->is_number() ? v->as_number() : fallback;
+    }
+    std::string string_or(const std::string& key, std::string fallback) const {
+        const Json* v = find(key);
+        return v && v->is_string() ? v->as_string() : fallback;
+    }
+
+    void push_back(Json v) {
+        if (is_null()) value_ = Array{};
+        as_array().push_back(std::move(v));
+    }
+
+    size_t size() const {
+        if (is_array()) return as_array().size();
+        if (is_object()) return as_object().size();
+        return 0;
+    }
+
+    // ── Serialization ───────────────────────────────────────────────────────
+    std::string dump(int indent = 2) const {
+        std::string out;
+        write(out, indent, 0);
+        return out;
+    }
+
+    static Json parse(const std::string& text) {
+        Parser p{text, 0};
+        Json v = p.parse_value();
+        p.skip_ws();
+        if (p.pos != text.size()) p.fail("trailing characters");
+        return v;
+    }
+
+    static Json parse_file(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open JSON file: " + path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return parse(ss.str());
+    }
+
+    void write_file(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) throw std::runtime_error("Cannot write JSON file: " + path);
+        out << dump() << '\n';
+    }
+
+private:
+    template <typename T>
+    const T& get(const char* what) const {
+        if (auto* p = std::get_if<T>(&value_)) return *p;
+        throw std::runtime_error(std::string("JSON: value is not a ") + what);
+    }
+    template <typename T>
+    T& get(const char* what) {
+        if (auto* p = std::get_if<T>(&value_)) return *p;
+        throw std::runtime_error(std::string("JSON: value is not a ") + what);
+    }
+
+    static void write_string(std::string& out, const std::string& s) {
+        out += '"';
+        for (char c : s) {
+            switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    static void newline(std::string& out, int indent, int depth) {
+        if (indent <= 0) return;
+        out += '\n';
+        out.append(static_cast<size_t>(indent * depth), ' ');
+    }
+
+    void write(std::string& out, int indent, int depth) const {
+        if (is_null()) {
+            out += "null";
+        } else if (is_bool()) {
+            out += as_bool() ? "true" : "false";
+        } else if (is_number()) {
+            double d = as_number();
+            if (!std::isfinite(d)) {
+                out += "null";
+            } else if (d == std::floor(d) && std::fabs(d) < 1e15) {
+                out += std::to_string(static_cast<long long>(d));
+            } else {
+                char buf[32];
+                std::snprintf(buf, sizeof(buf), "%.15g", d);
+                out += buf;
+            }
+        } else if (is_string()) {
+            write_string(out, as_string());
+        } else if (is_array()) {
+            const auto& arr = as_array();
+            out += '[';
+            for (size_t i = 0; i < arr.size(); ++i) {
+                if (i) out += ',';
+                newline(out, indent, depth + 1);
+                arr[i].write(out, indent, depth + 1);
+            }
+            if (!arr.empty()) newline(out, indent, depth);
+            out += ']';
+        } else {
+            const auto& obj = as_object();
+            out += '{';
+            for (size_t i = 0; i < obj.size(); ++i) {
+                if (i) out += ',';
+                newline(out, indent, depth + 1);
+                write_string(out, obj[i].first);
+                out += indent > 0 ? ": " : ":";
+                obj[i].second.write(out, indent, depth + 1);
+            }
+            if (!obj.empty()) newline(out, indent, depth);
+            out += '}';
+        }
+    }
+
+    struct Parser {
+        const std::string& text;
+        size_t pos;
+
+        [[noreturn]] void fail(const char* msg) const {
+            throw std::runtime_error("JSON parse error at offset " +
+                                     std::to_string(pos) + ": " + msg);
+        }
+
+        void skip_ws() {
+            while (pos < text.size() &&
+                   std::isspace(static_cast<unsigned char>(text[pos])))
+                ++pos;
+        }
+
+        bool consume(const char* lit) {
+            size_t n = std::char_traits<char>::length(lit);
+            if (text.compare(pos, n, lit) != 0) return false;
+            pos += n;
+            return true;
+        }
+
+        Json parse_value() {
+            skip_ws();
+            if (pos >= text.size()) fail("unexpected end of input");
+            char c = text[pos];
+            if (c == '{') return parse_object();
+            if (c == '[') return parse_array();
+            if (c == '"') return Json(parse_string());
+            if (consume("true")) return Json(true);
+            if (consume("false")) return Json(false);
+            if (consume("null")) return Json(nullptr);
+            return parse_number();
+        }
+
+        Json parse_object() {
+            ++pos; // '{'
+            Object obj;
+            skip_ws();
+            if (pos < text.size() && text[pos] == '}') { ++pos; return Json(std::move(obj)); }
+            while (true) {
+                skip_ws();
+                if (pos >= text.size() || text[pos] != '"') fail("expected key");
+                std::string key = parse_string();
+                skip_ws();
+                if (pos >= text.size() || text[pos] != ':') fail("expected ':'");
+                ++pos;
+                obj.emplace_back(std::move(key), parse_value());
+                skip_ws();
+                if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+                if (pos < text.size() && text[pos] == '}') { ++pos; break; }
+                fail("expected ',' or '}'");
+            }
+            return Json(std::move(obj));
+        }
+
+        Json parse_array() {
+            ++pos; // '['
+            Array arr;
+            skip_ws();
+            if (pos < text.size() && text[pos] == ']') { ++pos; return Json(std::move(arr)); }
+            while (true) {
+                arr.push_back(parse_value());
+                skip_ws();
+                if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+                if (pos < text.size() && text[pos] == ']') { ++pos; break; }
+                fail("expected ',' or ']'");
+            }
+            return Json(std::move(arr));
+        }
+
+        std::string parse_string() {
+            ++pos; // opening quote
+            std::string out;
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+                if (c != '\\') { out += c; continue; }
+                if (pos >= text.size()) fail("bad escape");
+                char e = text[pos++];
+                switch (e) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos + 4 > text.size()) fail("bad \\u escape");
+                    unsigned cp = static_cast<unsigned>(
+                        std::stoul(text.substr(pos, 4), nullptr, 16));
+                    pos += 4;
+                    // Benchmarks only emit ASCII; encode BMP code points as UTF-8
+                    if (cp < 0x80) {
+                        out += static_cast<char>(cp);
+                    } else if (cp < 0x800) {
+                        out += static_cast<char>(0xC0 | (cp >> 6));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (cp >> 12));
+                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default: fail("bad escape");
+                }
+            }
+            if (pos >= text.size()) fail("unterminated string");
+            ++pos; // closing quote
+            return out;
+        }
+
+        Json parse_number() {
+            size_t start = pos;
+            if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) ++pos;
+            while (pos < text.size() &&
+                   (std::isdigit(static_cast<unsigned char>(text[pos])) ||
+                    text[pos] == '.' || text[pos] == 'e' || text[pos] == 'E' ||
+                    text[pos] == '-' || text[pos] == '+'))
+                ++pos;
+            if (start == pos) fail("unexpected character");
+            try {
+                return Json(std::stod(text.substr(start, pos - start)));
+            } catch (const std::exception&) {
+                fail("bad number");
+            }
+        }
+    };
+
+    std::variant<std::monostate, bool, double, std::string, Array, Object> value_;
+};
+
+} // namespace bench
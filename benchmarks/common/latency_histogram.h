@@ -0,0 +1,130 @@
+#pragma once
+
+// latency_histogram.h — Lock-free log-linear histogram for latency samples.
+//
+// Values below 64 are exact; above that each power-of-two range is split into
+// 32 sub-buckets, so any reported percentile is within ~3% of the true value.
+// record() is a single relaxed fetch_add and is safe from any thread.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/json.h"
+
+namespace bench {
+
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS    = 5;
+    static constexpr uint64_t SUB_BUCKETS = 1u << SUB_BITS;           // 32
+    // Two exact groups below 64, then one group per power of two up to 2^63
+    static constexpr size_t   NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value) {
+        buckets_[index_of(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (value > prev &&
+               !max_.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+    }
+
+    // Adds every sample of `other` into this histogram (not thread-safe
+    // against concurrent record() on `other`).
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            uint64_t c = other.buckets_[i].load(std::memory_order_relaxed);
+            if (c) buckets_[i].fetch_add(c, std::memory_order_relaxed);
+        }
+        count_.fetch_add(other.count(), std::memory_order_relaxed);
+        sum_.fetch_add(other.sum_.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+        uint64_t m = other.max();
+        uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (m > prev &&
+               !max_.compare_exchange_weak(prev, m, std::memory_order_relaxed)) {}
+    }
+
+    void reset() {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    double mean() const {
+        uint64_t n = count();
+        return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                       static_cast<double>(n)
+                 : 0.0;
+    }
+
+    // q in [0, 1]. Returns the midpoint of the bucket holding the q-quantile,
+    // clamped to the observed maximum.
+    uint64_t percentile(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(n - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t lo = lower_bound_of(i);
+                // The last bucket ends at 2^64, which does not fit
+                uint64_t hi = i + 1 < NUM_BUCKETS ? lower_bound_of(i + 1) : UINT64_MAX;
+                uint64_t width = hi - lo;
+                return std::min(lo + width / 2, max());
+            }
+        }
+        return max();
+    }
+
+    // {"count","mean","p50","p90","p99","p999","max"}; values are multiplied
+    // by `scale` (e.g. 1e-3 to report nanosecond samples in microseconds)
+    Json summary(double scale = 1.0) const {
+        auto at = [&](double q) {
+            return static_cast<double>(percentile(q)) * scale;
+        };
+        Json j = Json::object();
+        j["count"] = count();
+        j["mean"]  = mean() * scale;
+        j["p50"]   = at(0.50);
+        j["p90"]   = at(0.90);
+        j["p99"]   = at(0.99);
+        j["p999"]  = at(0.999);
+        j["max"]   = static_cast<double>(max()) * scale;
+        return j;
+    }
+
+    // Every uint64_t maps below NUM_BUCKETS
+    static constexpr size_t index_of(uint64_t v) {
+        if (v < 2 * SUB_BUCKETS) return static_cast<size_t>(v);
+        unsigned shift = static_cast<unsigned>(std::bit_width(v)) - 1 - SUB_BITS;
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS +
+                                   ((v >> shift) - SUB_BUCKETS));
+    }
+
+    static uint64_t lower_bound_of(size_t idx) {
+        if (idx < 2 * SUB_BUCKETS) return idx;
+        uint64_t shift = idx / SUB_BUCKETS - 1;
+        uint64_t mantissa = idx % SUB_BUCKETS + SUB_BUCKETS;
+        return mantissa << shift;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+static_assert(LatencyHistogram::index_of(UINT64_MAX) == LatencyHistogram::NUM_BUCKETS - 1);
+
+} // namespace bench
@@ -0,0 +1,70 @@
+#pragma once
+
+// memory_stats.h — Process memory probes for the standalone benchmarks.
+//
+// rss_bytes()/peak_rss_bytes() read the kernel's view of the process;
+// heap_in_use_bytes() asks the allocator (glibc mallinfo2) and is the more
+// precise measure for per-object costs. Probes that are unavailable on the
+// current platform return 0.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace bench {
+
+// Current resident set size
+inline uint64_t rss_bytes() {
+#if defined(__linux__)
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    const int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    if (n != 2) return 0;
+    return static_cast<uint64_t>(resident) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// High-water resident set size since process start
+inline uint64_t peak_rss_bytes() {
+#if defined(__linux__)
+    struct rusage ru {};
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return static_cast<uint64_t>(ru.ru_maxrss) * 1024; // KiB on Linux
+#else
+    return 0;
+#endif
+}
+
+// Bytes currently allocated through malloc/new (excludes allocator overhead
+// and free lists)
+inline uint64_t heap_in_use_bytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return static_cast<uint64_t>(mallinfo2().uordblks);
+#elif defined(__GLIBC__)
+    return static_cast<uint64_t>(static_cast<unsigned>(mallinfo().uordblks));
+#else
+    return 0;
+#endif
+}
+
+// Returns freed memory at the top of the heap to the OS so RSS deltas between
+// phases are meaningful
+inline void trim_heap() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+} // namespace bench
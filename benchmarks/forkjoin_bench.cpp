@@ -0,0 +1,501 @@
+// forkjoin_bench.cpp — Recursive spawning: jobs that submit jobs
+//
+// Classic task-parallel kernels where every task submits its children from
+// inside a running job:
+//   fib        — fib(n) with a serial cutoff, results joined up the tree
+//   mergesort  — parallel mergesort, merge runs as the join continuation
+//   tree       — sum over an implicit complete binary tree
+//   uts        — unbalanced tree search (binomial tree, one job per node)
+//
+// Workers must never block waiting for children (that would deadlock a pool
+// with fewer workers than the recursion depth), so joins are continuations:
+// a Join counts outstanding children and the last one to finish runs the
+// parent's continuation inline. UTS instead uses a global outstanding-task
+// counter, as the reference implementation does.
+//
+// Every kernel runs on three executors:
+//   serial — a single-threaded LIFO stack (the work baseline; no locks)
+//   naive  — a textbook pool: one mutex, one deque, one condition variable
+//   sched  — Scheduler::submit + ThreadPool, one client
+// and reports wall time, spawns/s, speedup over serial and overhead per spawn,
+// estimated as (wall × workers − serial) / spawns.
+//
+// Usage:
+//   forkjoin_bench [--kernels fib,mergesort,tree,uts] [--workers 1,2,4]
+//                  [--executors naive,sched] [--repeat 3] [--out r.json]
+//                  [--fib-n 30] [--fib-cutoff 12] [--sort-n 2000000]
+//                  [--sort-cutoff 2048] [--tree-depth 20] [--tree-leaf 8]
+//                  [--uts-b0 2000] [--uts-q 0.195] [--uts-m 5]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Executors
+// ---------------------------------------------------------------------------
+
+class Executor {
+public:
+    virtual ~Executor() = default;
+    virtual void spawn(std::function<void()> task) = 0;
+    // Calls `root` (which spawns the kernel) and returns once `done` is set
+    virtual void run(const std::function<void()>& root, std::atomic<bool>& done) = 0;
+};
+
+class SerialExecutor final : public Executor {
+public:
+    void spawn(std::function<void()> task) override {
+        ++spawns_;
+        stack_.push_back(std::move(task));
+    }
+
+    void run(const std::function<void()>& root, std::atomic<bool>& done) override {
+        root();
+        while (!stack_.empty()) {
+            auto task = std::move(stack_.back());
+            stack_.pop_back();
+            task();
+        }
+        if (!done.load()) throw std::logic_error("kernel finished without completing");
+    }
+
+    uint64_t spawns() const { return spawns_; }
+
+private:
+    std::vector<std::function<void()>> stack_;
+    uint64_t spawns_{0};
+};
+
+// Single shared queue under one mutex — the baseline every scheduler should beat
+class NaivePool final : public Executor {
+public:
+    explicit NaivePool(size_t workers) {
+        for (size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back([this](std::stop_token st) {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock lock(mutex_);
+                        cv_.wait(lock, st, [this] { return !queue_.empty(); });
+                        if (queue_.empty()) return; // stop requested
+                        task = std::move(queue_.front());
+                        queue_.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~NaivePool() override {
+        for (auto& t : threads_) t.request_stop();
+    }
+
+    void spawn(std::function<void()> task) override {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    void run(const std::function<void()>& root, std::atomic<bool>& done) override {
+        root();
+        done.wait(false);
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::jthread> threads_;
+};
+
+class SchedulerExecutor final : public Executor {
+public:
+    explicit SchedulerExecutor(size_t workers) {
+        sched_.register_client(CLIENT);
+        pool_ = std::make_unique<ThreadPool>(sched_, workers);
+    }
+
+    ~SchedulerExecutor() override { pool_->shutdown(); }
+
+    void spawn(std::function<void()> task) override {
+        sched_.submit(CLIENT, std::move(task));
+    }
+
+    void run(const std::function<void()>& root, std::atomic<bool>& done) override {
+        root();
+        done.wait(false);
+    }
+
+private:
+    static constexpr const char* CLIENT = "forkjoin";
+    Scheduler sched_;
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+void finish(std::atomic<bool>& done) {
+    done.store(true);
+    done.notify_all();
+}
+
+// Counts outstanding children; the last to arrive runs the continuation
+struct Join {
+    Join(int n, std::function<void()> k) : pending(n), cont(std::move(k)) {}
+    std::atomic<int> pending;
+    std::function<void()> cont;
+
+    void arrive() {
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) cont();
+    }
+};
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// ---------------------------------------------------------------------------
+// Kernels — each returns a checksum compared against the serial run
+// ---------------------------------------------------------------------------
+
+struct KernelParams {
+    int      fib_n{30};
+    int      fib_cutoff{12};
+    size_t   sort_n{2'000'000};
+    size_t   sort_cutoff{2048};
+    int      tree_depth{20};
+    int      tree_leaf{8}; // subtrees this deep are summed serially
+    uint64_t uts_b0{2000};
+    double   uts_q{0.195};
+    uint64_t uts_m{5};
+};
+
+// Only the spawn/execute phase is timed; input generation is excluded
+struct KernelResult {
+    uint64_t checksum{0};
+    double   ms{0.0};
+};
+
+double timed_run(Executor& ex, const std::function<void()>& root, std::atomic<bool>& done) {
+    const auto t0 = steady_clock::now();
+    ex.run(root, done);
+    return duration<double, std::milli>(steady_clock::now() - t0).count();
+}
+
+uint64_t fib_serial(int n) { return n < 2 ? static_cast<uint64_t>(n) : fib_serial(n - 1) + fib_serial(n - 2); }
+
+void fib_task(Executor& ex, int n, int cutoff, uint64_t* out, std::function<void()> k) {
+    if (n < cutoff) {
+        *out = fib_serial(n);
+        k();
+        return;
+    }
+    auto r = std::make_shared<std::array<uint64_t, 2>>();
+    auto join = std::make_shared<Join>(2, [r, out, k = std::move(k)] {
+        *out = (*r)[0] + (*r)[1];
+        k();
+    });
+    ex.spawn([&ex, n, cutoff, r, join] {
+        fib_task(ex, n - 1, cutoff, &(*r)[0], [join] { join->arrive(); });
+    });
+    ex.spawn([&ex, n, cutoff, r, join] {
+        fib_task(ex, n - 2, cutoff, &(*r)[1], [join] { join->arrive(); });
+    });
+}
+
+KernelResult run_fib(Executor& ex, const KernelParams& p, std::atomic<bool>& done) {
+    uint64_t result = 0;
+    const double ms = timed_run(ex, [&] {
+        fib_task(ex, p.fib_n, p.fib_cutoff, &result, [&done] { finish(done); });
+    }, done);
+    return {result, ms};
+}
+
+void sort_task(Executor& ex, uint32_t* data, uint32_t* tmp, size_t lo, size_t hi,
+               size_t cutoff, std::function<void()> k) {
+    if (hi - lo <= cutoff) {
+        std::sort(data + lo, data + hi);
+        k();
+        return;
+    }
+    const size_t mid = lo + (hi - lo) / 2;
+    auto join = std::make_shared<Join>(2, [=, k = std::move(k)] {
+        std::merge(data + lo, data + mid, data + mid, data + hi, tmp + lo);
+        std::copy(tmp + lo, tmp + hi, data + lo);
+        k();
+    });
+    ex.spawn([&ex, data, tmp, lo, mid, cutoff, join] {
+        sort_task(ex, data, tmp, lo, mid, cutoff, [join] { join->arrive(); });
+    });
+    ex.spawn([&ex, data, tmp, mid, hi, cutoff, join] {
+        sort_task(ex, data, tmp, mid, hi, cutoff, [join] { join->arrive(); });
+    });
+}
+
+KernelResult run_mergesort(Executor& ex, const KernelParams& p, std::atomic<bool>& done) {
+    std::vector<uint32_t> data(p.sort_n), tmp(p.sort_n);
+    std::mt19937 rng(7);
+    for (auto& v : data) v = rng();
+    const double ms = timed_run(ex, [&] {
+        sort_task(ex, data.data(), tmp.data(), 0, data.size(), p.sort_cutoff,
+                  [&done] { finish(done); });
+    }, done);
+    uint64_t check = std::is_sorted(data.begin(), data.end()) ? 1 : 0;
+    for (size_t i = 0; i < data.size(); i += data.size() / 64 + 1) check = check * 31 + data[i];
+    return {check, ms};
+}
+
+// Implicit complete binary tree: node i has children 2i+1 and 2i+2
+uint64_t tree_sum_serial(const std::vector<uint64_t>& v, size_t i) {
+    if (i >= v.size()) return 0;
+    return v[i] + tree_sum_serial(v, 2 * i + 1) + tree_sum_serial(v, 2 * i + 2);
+}
+
+void tree_task(Executor& ex, const std::vector<uint64_t>& v, size_t i, int depth_left,
+               int leaf, uint64_t* out, std::function<void()> k) {
+    if (depth_left <= leaf) {
+        *out = tree_sum_serial(v, i);
+        k();
+        return;
+    }
+    auto r = std::make_shared<std::array<uint64_t, 2>>();
+    auto join = std::make_shared<Join>(2, [&v, i, r, out, k = std::move(k)] {
+        *out = v[i] + (*r)[0] + (*r)[1];
+        k();
+    });
+    for (size_t c = 0; c < 2; ++c) {
+        ex.spawn([&ex, &v, i, c, depth_left, leaf, r, join] {
+            tree_task(ex, v, 2 * i + 1 + c, depth_left - 1, leaf, &(*r)[c],
+                      [join] { join->arrive(); });
+        });
+    }
+}
+
+KernelResult run_tree(Executor& ex, const KernelParams& p, std::atomic<bool>& done) {
+    std::vector<uint64_t> values((size_t{1} << p.tree_depth) - 1);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = splitmix64(i) & 0xFFFF;
+    uint64_t result = 0;
+    const double ms = timed_run(ex, [&] {
+        tree_task(ex, values, 0, p.tree_depth, p.tree_leaf, &result, [&done] { finish(done); });
+    }, done);
+    return {result, ms};
+}
+
+// UTS binomial tree: the root has b0 children; every other node has m
+// children with probability q, else none. Node identity is a hash chain, so
+// the tree is identical on every executor.
+struct UtsState {
+    Executor* ex;
+    const KernelParams* p;
+    std::atomic<int64_t> outstanding{0};
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<bool>* done;
+};
+
+void uts_spawn(UtsState& s, uint64_t id, bool root);
+
+void uts_visit(UtsState& s, uint64_t id, bool root) {
+    s.nodes.fetch_add(1, std::memory_order_relaxed);
+    uint64_t children = 0;
+    if (root) {
+        children = s.p->uts_b0;
+    } else if (static_cast<double>(splitmix64(id) >> 11) * 0x1.0p-53 < s.p->uts_q) {
+        children = s.p->uts_m;
+    }
+    for (uint64_t c = 0; c < children; ++c) uts_spawn(s, splitmix64(id ^ (c + 1) * 0x2545F4914F6CDD1DULL), false);
+    if (s.outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) finish(*s.done);
+}
+
+void uts_spawn(UtsState& s, uint64_t id, bool root) {
+    s.outstanding.fetch_add(1, std::memory_order_relaxed);
+    s.ex->spawn([&s, id, root] { uts_visit(s, id, root); });
+}
+
+KernelResult run_uts(Executor& ex, const KernelParams& p, std::atomic<bool>& done) {
+    UtsState s{&ex, &p, {}, {}, &done};
+    const double ms = timed_run(ex, [&] { uts_spawn(s, 0x5EED, true); }, done);
+    return {s.nodes.load(), ms};
+}
+
+// `done` is owned by the caller and outlives the executor, so the worker that
+// sets it may still be inside notify_all() when the kernel returns
+using KernelFn = KernelResult (*)(Executor&, const KernelParams&, std::atomic<bool>&);
+
+KernelFn kernel_by_name(const std::string& name) {
+    if (name == "fib")       return run_fib;
+    if (name == "mergesort") return run_mergesort;
+    if (name == "tree")      return run_tree;
+    if (name == "uts")       return run_uts;
+    throw std::invalid_argument("Unknown kernel: " + name);
+}
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = std::min(s.find(',', start), s.size());
+        if (comma > start) out.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    KernelParams p;
+    p.fib_n       = static_cast<int>(args.get_int("fib-n", p.fib_n));
+    p.fib_cutoff  = static_cast<int>(args.get_int("fib-cutoff", p.fib_cutoff));
+    p.sort_n      = static_cast<size_t>(args.get_int("sort-n", static_cast<int64_t>(p.sort_n)));
+    p.sort_cutoff = static_cast<size_t>(args.get_int("sort-cutoff", static_cast<int64_t>(p.sort_cutoff)));
+    p.tree_depth  = static_cast<int>(args.get_int("tree-depth", p.tree_depth));
+    p.tree_leaf   = static_cast<int>(args.get_int("tree-leaf", p.tree_leaf));
+    p.uts_b0      = static_cast<uint64_t>(args.get_int("uts-b0", static_cast<int64_t>(p.uts_b0)));
+    p.uts_q       = args.get_double("uts-q", p.uts_q);
+    p.uts_m       = static_cast<uint64_t>(args.get_int("uts-m", static_cast<int64_t>(p.uts_m)));
+    const auto workers = args.get_int_list("workers", {1, 2, 4});
+    const int repeat = static_cast<int>(args.get_int("repeat", 3));
+    const auto kernels = split_list(args.get("kernels", "fib,mergesort,tree,uts"));
+    const auto executors = split_list(args.get("executors", "naive,sched"));
+    for (const auto& e : executors) {
+        if (e != "naive" && e != "sched") {
+            std::cerr << "forkjoin_bench: unknown executor: " << e << "\n";
+            return 2;
+        }
+    }
+
+    std::cout << "\n=== Fork-Join / Nested Submit (best of " << repeat << ") ===\n\n";
+    std::cout << std::left << std::setw(11) << "Kernel" << std::setw(8) << "Exec"
+              << std::right << std::setw(8) << "Workers"
+              << std::setw(11) << "Wall ms"
+              << std::setw(10) << "Spawns"
+              << std::setw(12) << "Mspawn/s"
+              << std::setw(10) << "Speedup"
+              << std::setw(13) << "ns/spawn" << "\n";
+    std::cout << std::string(83, '-') << "\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "forkjoin_bench";
+    result["config"]["fib_n"]       = p.fib_n;
+    result["config"]["fib_cutoff"]  = p.fib_cutoff;
+    result["config"]["sort_n"]      = p.sort_n;
+    result["config"]["sort_cutoff"] = p.sort_cutoff;
+    result["config"]["tree_depth"]  = p.tree_depth;
+    result["config"]["tree_leaf"]   = p.tree_leaf;
+    result["config"]["uts_b0"]      = p.uts_b0;
+    result["config"]["uts_q"]       = p.uts_q;
+    result["config"]["uts_m"]       = p.uts_m;
+    result["directions"] = Json::object();
+    result["runs"] = Json::array();
+    for (int r = 0; r < repeat; ++r) {
+        Json run = Json::object();
+        run["metrics"] = Json::object();
+        result["runs"].push_back(std::move(run));
+    }
+
+    int failures = 0;
+    for (const auto& kname : kernels) {
+        KernelFn kernel;
+        try {
+            kernel = kernel_by_name(kname);
+        } catch (const std::exception& e) {
+            std::cerr << "forkjoin_bench: " << e.what() << "\n";
+            return 2;
+        }
+
+        // Serial reference: checksum, spawn count and the work baseline
+        double serial_ms = 1e300;
+        uint64_t expect = 0, spawns = 0;
+        for (int r = 0; r < repeat; ++r) {
+            std::atomic<bool> done{false};
+            SerialExecutor serial;
+            const KernelResult res = kernel(serial, p, done);
+            expect = res.checksum;
+            serial_ms = std::min(serial_ms, res.ms);
+            spawns = serial.spawns();
+        }
+        std::cout << std::left << std::setw(11) << kname << std::setw(8) << "serial"
+                  << std::right << std::setw(8) << 1 << std::fixed << std::setprecision(1)
+                  << std::setw(11) << serial_ms << std::setw(10) << spawns
+                  << std::setprecision(2)
+                  << std::setw(12) << static_cast<double>(spawns) / serial_ms / 1e3
+                  << std::setw(10) << 1.0 << std::setw(13) << "-" << "\n";
+
+        for (const auto& ename : executors) {
+            for (int64_t w : workers) {
+                double best_ms = 1e300;
+                for (int r = 0; r < repeat; ++r) {
+                    std::atomic<bool> done{false};
+                    std::unique_ptr<Executor> ex;
+                    if (ename == "naive") ex = std::make_unique<NaivePool>(static_cast<size_t>(w));
+                    else ex = std::make_unique<SchedulerExecutor>(static_cast<size_t>(w));
+
+                    const KernelResult res = kernel(*ex, p, done);
+                    const uint64_t got = res.checksum;
+                    const double ms = res.ms;
+                    if (got != expect) {
+                        std::cerr << "forkjoin_bench: " << kname << " on " << ename
+                                  << " returned " << got << ", expected " << expect << "\n";
+                        ++failures;
+                    }
+                    best_ms = std::min(best_ms, ms);
+
+                    const std::string prefix = kname + "_" + ename + "_w" + std::to_string(w) + "_";
+                    Json& m = result["runs"].as_array()[static_cast<size_t>(r)]["metrics"];
+                    m[prefix + "wall_ms"] = ms;
+                    m[prefix + "spawns_per_s"] = static_cast<double>(spawns) / ms * 1e3;
+                    result["directions"][prefix + "wall_ms"] = "lower";
+                    result["directions"][prefix + "spawns_per_s"] = "higher";
+                }
+
+                const double overhead_ns =
+                    (best_ms * static_cast<double>(w) - serial_ms) * 1e6 /
+                    static_cast<double>(std::max<uint64_t>(spawns, 1));
+                std::cout << std::left << std::setw(11) << kname << std::setw(8) << ename
+                          << std::right << std::setw(8) << w << std::setprecision(1)
+                          << std::setw(11) << best_ms << std::setw(10) << spawns
+                          << std::setprecision(2)
+                          << std::setw(12) << static_cast<double>(spawns) / best_ms / 1e3
+                          << std::setw(10) << serial_ms / best_ms
+                          << std::setprecision(0) << std::setw(13) << overhead_ns << "\n";
+            }
+        }
+    }
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,430 @@
+// jlog_analyze.cpp — Offline analysis of an EventLog (Scheduler::set_event_log)
+//
+// Streams the log once (memory-mapped, pages released behind the cursor), so
+// multi-GB logs are fine. Reports:
+//   * per client: outcome counts, queue wait (SUBMIT → START) and run time
+//     (START → COMPLETE) distributions
+//   * fairness over time: Jain index of completions per window, over the
+//     clients that submitted or completed anything in that window (unweighted
+//     — the log does not carry weights)
+//   * worker utilisation: busy fraction of every thread that ran jobs, per
+//     window and overall
+//   * spawn trees (--trees): jobs submitted from inside running tasks grouped
+//     by root; size, depth and fan-out distributions, end-to-end latency and
+//     the critical path of the --top slowest trees split into queue and run
+//     time. Keeps ~100 bytes per job in memory, hence opt-in.
+//
+// Records from different threads are not in global time order in the file;
+// SUBMIT/START pairs are matched by job id whichever comes first.
+//
+// Results use the benchmark JSON schema, so two logs can be compared with
+// bench_compare.
+//
+// Usage:
+//   jlog_analyze events.bin [--window-ms 100] [--timeline] [--trees [--top 5]]
+//                [--out analysis.json]
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/latency_histogram.h"
+#include "job_system/event_log.h"
+#include "job_system/spawn_tree.h"
+
+using namespace job_system;
+using bench::Json;
+
+namespace {
+
+struct ClientStats {
+    std::array<uint64_t, static_cast<size_t>(EventType::NUM_TYPES)> counts{};
+    bench::LatencyHistogram wait_ns;
+    bench::LatencyHistogram run_ns;
+};
+
+struct Window {
+    std::unordered_map<uint32_t, uint64_t> completions; // client → count
+    std::unordered_map<uint32_t, bool> active;          // client seen in window
+    std::unordered_map<uint32_t, uint64_t> busy_ns;     // worker thread → ns
+};
+
+class Analyzer {
+public:
+    explicit Analyzer(uint64_t window_ns) : window_ns_(window_ns) {}
+
+    void add(const LogEvent& ev) {
+        first_ts_ = std::min(first_ts_, ev.timestamp_ns);
+        last_ts_ = std::max(last_ts_, ev.timestamp_ns);
+        ClientStats& cs = client(ev.client);
+        ++cs.counts[static_cast<size_t>(ev.type)];
+        Window& w = window(ev.timestamp_ns);
+
+        switch (ev.type) {
+        case EventType::SUBMIT: {
+            w.active[ev.client] = true;
+            auto early = started_first_.find(ev.job_id);
+            if (early != started_first_.end()) {
+                cs.wait_ns.record(early->second - std::min(early->second, ev.timestamp_ns));
+                started_first_.erase(early);
+            } else {
+                submitted_.emplace(ev.job_id, ev.timestamp_ns);
+            }
+            break;
+        }
+        case EventType::START: {
+            auto it = submitted_.find(ev.job_id);
+            if (it != submitted_.end()) {
+                cs.wait_ns.record(ev.timestamp_ns - std::min(ev.timestamp_ns, it->second));
+                submitted_.erase(it);
+            } else {
+                started_first_.emplace(ev.job_id, ev.timestamp_ns);
+            }
+            running_[ev.thread] = ev.timestamp_ns;
+            workers_[ev.thread] = true;
+            break;
+        }
+        case EventType::COMPLETE: {
+            w.active[ev.client] = true;
+            ++w.completions[ev.client];
+            auto it = running_.find(ev.thread);
+            if (it != running_.end()) {
+                const uint64_t start = std::min(it->second, ev.timestamp_ns);
+                cs.run_ns.record(ev.timestamp_ns - start);
+                add_busy(ev.thread, start, ev.timestamp_ns);
+                running_.erase(it);
+            }
+            break;
+        }
+        case EventType::DROP:
+        case EventType::EXPIRE:
+        case EventType::CANCEL:
+            submitted_.erase(ev.job_id);
+            break;
+        case EventType::REJECT:
+        case EventType::SPAWN:
+        case EventType::NUM_TYPES:
+            break;
+        }
+    }
+
+    Json report(const std::vector<std::string>& names, bool timeline) const;
+
+private:
+    ClientStats& client(uint32_t idx) {
+        while (clients_.size() <= idx) clients_.push_back(std::make_unique<ClientStats>());
+        return *clients_[idx];
+    }
+
+    Window& window(uint64_t ts) { return windows_[ts / window_ns_]; }
+
+    // Spreads a busy interval over the windows it overlaps
+    void add_busy(uint32_t thread, uint64_t start, uint64_t end) {
+        while (start < end) {
+            const uint64_t boundary = (start / window_ns_ + 1) * window_ns_;
+            const uint64_t upto = std::min(end, boundary);
+            window(start).busy_ns[thread] += upto - start;
+            start = upto;
+        }
+    }
+
+    uint64_t window_ns_;
+    uint64_t first_ts_{UINT64_MAX};
+    uint64_t last_ts_{0};
+    std::vector<std::unique_ptr<ClientStats>> clients_;
+    std::map<uint64_t, Window> windows_;
+    std::unordered_map<uint64_t, uint64_t> submitted_;     // job → SUBMIT ts
+    std::unordered_map<uint64_t, uint64_t> started_first_; // START seen before SUBMIT
+    std::unordered_map<uint32_t, uint64_t> running_;       // thread → START ts
+    std::map<uint32_t, bool> workers_;
+};
+
+Json Analyzer::report(const std::vector<std::string>& names, bool timeline) const {
+    Json run = Json::object();
+    Json metrics = Json::object();
+    Json per_client = Json::object();
+    const double span_s =
+        first_ts_ < last_ts_ ? static_cast<double>(last_ts_ - first_ts_) / 1e9 : 0.0;
+
+    // Per client
+    std::cout << std::right << std::setw(12) << "Client" << std::setw(10) << "Submit"
+              << std::setw(10) << "Done" << std::setw(8) << "Reject" << std::setw(8)
+              << "Drop" << std::setw(8) << "Expire" << std::setw(8) << "Cancel"
+              << std::setw(11) << "Wait p50" << std::setw(11) << "Wait p99"
+              << std::setw(10) << "Run p50" << std::setw(10) << "Run p99" << "  (µs)\n";
+    std::cout << std::string(114, '-') << "\n";
+    bench::LatencyHistogram all_wait, all_run;
+    uint64_t completed = 0;
+    for (size_t i = 0; i < clients_.size(); ++i) {
+        const ClientStats& cs = *clients_[i];
+        auto n = [&](EventType t) { return cs.counts[static_cast<size_t>(t)]; };
+        const std::string& name = i < names.size() ? names[i] : std::to_string(i);
+        std::cout << std::setw(12) << name << std::setw(10) << n(EventType::SUBMIT)
+                  << std::setw(10) << n(EventType::COMPLETE) << std::setw(8)
+                  << n(EventType::REJECT) << std::setw(8) << n(EventType::DROP)
+                  << std::setw(8) << n(EventType::EXPIRE) << std::setw(8)
+                  << n(EventType::CANCEL) << std::fixed << std::setprecision(1)
+                  << std::setw(11) << static_cast<double>(cs.wait_ns.percentile(0.50)) / 1e3
+                  << std::setw(11) << static_cast<double>(cs.wait_ns.percentile(0.99)) / 1e3
+                  << std::setw(10) << static_cast<double>(cs.run_ns.percentile(0.50)) / 1e3
+                  << std::setw(10) << static_cast<double>(cs.run_ns.percentile(0.99)) / 1e3
+                  << "\n";
+
+        Json cj = Json::object();
+        for (size_t t = 0; t < cs.counts.size(); ++t)
+            cj[event_type_name(static_cast<EventType>(t))] = cs.counts[t];
+        cj["wait_us"] = cs.wait_ns.summary(1e-3);
+        cj["run_us"] = cs.run_ns.summary(1e-3);
+        per_client[name] = std::move(cj);
+        all_wait.merge(cs.wait_ns);
+        all_run.merge(cs.run_ns);
+        completed += n(EventType::COMPLETE);
+    }
+
+    // Windows: fairness + utilisation
+    std::vector<double> jains;
+    std::map<uint32_t, uint64_t> busy_total;
+    Json windows = Json::array();
+    if (timeline) {
+        std::cout << "\n" << std::setw(10) << "t (ms)" << std::setw(8) << "Jain"
+                  << std::setw(8) << "Util" << "  per-worker busy %\n";
+    }
+    const uint64_t first_window = windows_.empty() ? 0 : windows_.begin()->first;
+    for (const auto& [idx, w] : windows_) {
+        std::vector<double> shares;
+        for (const auto& [c, _] : w.active) {
+            auto it = w.completions.find(c);
+            shares.push_back(it == w.completions.end() ? 0.0 : static_cast<double>(it->second));
+        }
+        const double jain = bench::jain_index(shares);
+        if (!shares.empty()) jains.push_back(jain);
+
+        uint64_t busy = 0;
+        for (const auto& [t, ns] : w.busy_ns) {
+            busy += ns;
+            busy_total[t] += ns;
+        }
+        const double util = workers_.empty()
+                                ? 0.0
+                                : static_cast<double>(busy) /
+                                      static_cast<double>(window_ns_ * workers_.size());
+
+        Json wj = Json::object();
+        wj["t_ms"] = static_cast<double>((idx - first_window) * window_ns_) / 1e6;
+        wj["jain"] = jain;
+        wj["utilisation"] = util;
+        Json per_worker = Json::object();
+        for (const auto& [t, _] : workers_) {
+            auto it = w.busy_ns.find(t);
+            per_worker[std::to_string(t)] =
+                it == w.busy_ns.end() ? 0.0
+                                      : static_cast<double>(it->second) /
+                                            static_cast<double>(window_ns_);
+        }
+        wj["workers"] = std::move(per_worker);
+
+        if (timeline) {
+            std::cout << std::setw(10) << std::setprecision(0) << wj.at("t_ms").as_number()
+                      << std::setw(8) << std::setprecision(3) << jain << std::setw(7)
+                      << std::setprecision(0) << util * 100 << "% ";
+            for (const auto& [t, v] : wj.at("workers").as_object())
+                std::cout << " " << std::setw(3) << v.as_number() * 100;
+            std::cout << "\n";
+        }
+        windows.push_back(std::move(wj));
+    }
+
+    double jain_mean = 0, jain_min = 1;
+    for (double j : jains) {
+        jain_mean += j;
+        jain_min = std::min(jain_min, j);
+    }
+    if (!jains.empty()) jain_mean /= static_cast<double>(jains.size());
+    std::sort(jains.begin(), jains.end());
+    const double jain_p10 =
+        jains.empty() ? 1.0 : jains[static_cast<size_t>(0.1 * static_cast<double>(jains.size() - 1))];
+
+    std::cout << "\nWorkers: " << workers_.size() << ", utilisation";
+    Json util_json = Json::object();
+    double util_sum = 0;
+    for (const auto& [t, _] : workers_) {
+        const double u = span_s > 0 ? static_cast<double>(busy_total[t]) / (span_s * 1e9) : 0.0;
+        util_sum += u;
+        util_json[std::to_string(t)] = u;
+        std::cout << " " << std::setprecision(0) << u * 100 << "%";
+    }
+    const double util_mean = workers_.empty() ? 0.0 : util_sum / static_cast<double>(workers_.size());
+    std::cout << " (mean " << util_mean * 100 << "%)\n";
+    std::cout << "Fairness over " << jains.size() << " windows: Jain mean "
+              << std::setprecision(3) << jain_mean << ", p10 " << jain_p10 << ", min "
+              << jain_min << "\n";
+
+    metrics["span_s"]               = span_s;
+    metrics["completed"]            = completed;
+    metrics["throughput_jobs_per_s"] = span_s > 0 ? static_cast<double>(completed) / span_s : 0.0;
+    metrics["wait_p50_us"]          = static_cast<double>(all_wait.percentile(0.50)) / 1e3;
+    metrics["wait_p99_us"]          = static_cast<double>(all_wait.percentile(0.99)) / 1e3;
+    metrics["wait_max_us"]          = static_cast<double>(all_wait.percentile(1.0)) / 1e3;
+    metrics["run_p50_us"]           = static_cast<double>(all_run.percentile(0.50)) / 1e3;
+    metrics["run_p99_us"]           = static_cast<double>(all_run.percentile(0.99)) / 1e3;
+    metrics["jain_window_mean"]     = jain_mean;
+    metrics["jain_window_p10"]      = jain_p10;
+    metrics["jain_window_min"]      = jain_min;
+    metrics["worker_utilisation"]   = util_mean;
+    run["metrics"] = std::move(metrics);
+    run["clients"] = std::move(per_client);
+    run["worker_utilisation"] = std::move(util_json);
+    run["windows"] = std::move(windows);
+    return run;
+}
+
+template <typename T>
+T nth_of_sorted(const std::vector<T>& v, double q) {
+    return v.empty() ? T{} : v[static_cast<size_t>(q * static_cast<double>(v.size() - 1))];
+}
+
+// Adds spawn-tree metrics to `metrics` and prints the slowest trees
+void report_trees(const SpawnTreeAnalyzer& trees_in, const std::vector<std::string>& names,
+                  size_t top, Json& metrics) {
+    const std::vector<SpawnTree> trees = trees_in.trees();
+    std::vector<uint32_t> fanouts = trees_in.fanouts();
+    std::sort(fanouts.begin(), fanouts.end());
+
+    std::vector<size_t> sizes, depths;
+    bench::LatencyHistogram latency;
+    double queue_share_sum = 0;
+    for (const auto& t : trees) {
+        sizes.push_back(t.size);
+        depths.push_back(t.depth);
+        latency.record(t.latency_ns());
+        if (t.latency_ns() > 0)
+            queue_share_sum += static_cast<double>(t.path_queue_ns()) /
+                               static_cast<double>(t.latency_ns());
+    }
+    std::sort(sizes.begin(), sizes.end());
+    std::sort(depths.begin(), depths.end());
+    double fanout_mean = 0;
+    for (uint32_t f : fanouts) fanout_mean += f;
+    if (!fanouts.empty()) fanout_mean /= static_cast<double>(fanouts.size());
+    const double queue_share =
+        trees.empty() ? 0.0 : queue_share_sum / static_cast<double>(trees.size());
+
+    std::cout << "\nSpawn trees: " << trees.size() << " (≥2 jobs), size p50/p99/max "
+              << nth_of_sorted(sizes, 0.5) << "/" << nth_of_sorted(sizes, 0.99) << "/"
+              << nth_of_sorted(sizes, 1.0) << ", depth p50/max " << nth_of_sorted(depths, 0.5)
+              << "/" << nth_of_sorted(depths, 1.0) << "\n"
+              << "Fan-out over " << fanouts.size() << " spawning jobs: mean "
+              << std::setprecision(2) << fanout_mean << ", p99 " << nth_of_sorted(fanouts, 0.99)
+              << ", max " << nth_of_sorted(fanouts, 1.0) << "\n"
+              << "End-to-end p50/p99 " << std::setprecision(1)
+              << static_cast<double>(latency.percentile(0.50)) / 1e3 << "/"
+              << static_cast<double>(latency.percentile(0.99)) / 1e3
+              << " µs; critical path spends " << std::setprecision(0) << queue_share * 100
+              << "% of it queued\n";
+
+    for (size_t i = 0; i < std::min(top, trees.size()); ++i) {
+        const SpawnTree& t = trees[i];
+        std::cout << "\n  tree " << t.root_id << ": " << std::setprecision(1)
+                  << static_cast<double>(t.latency_ns()) / 1e3 << " µs, " << t.size
+                  << " jobs, depth " << t.depth << ", max fan-out " << t.max_fanout
+                  << "; path queue " << static_cast<double>(t.path_queue_ns()) / 1e3
+                  << " µs, run " << static_cast<double>(t.path_run_ns()) / 1e3 << " µs\n";
+        for (const auto& step : t.critical_path) {
+            const std::string& name =
+                step.client < names.size() ? names[step.client] : std::to_string(step.client);
+            std::cout << "    job " << std::setw(10) << step.job_id << std::setw(12) << name
+                      << "  queue " << std::setw(9) << static_cast<double>(step.queue_ns) / 1e3
+                      << "  run " << std::setw(9) << static_cast<double>(step.run_ns) / 1e3
+                      << "\n";
+        }
+    }
+
+    metrics["trees"]                 = static_cast<uint64_t>(trees.size());
+    metrics["tree_size_p50"]         = static_cast<uint64_t>(nth_of_sorted(sizes, 0.5));
+    metrics["tree_size_max"]         = static_cast<uint64_t>(nth_of_sorted(sizes, 1.0));
+    metrics["tree_depth_max"]        = static_cast<uint64_t>(nth_of_sorted(depths, 1.0));
+    metrics["fanout_mean"]           = fanout_mean;
+    metrics["fanout_p99"]            = static_cast<uint64_t>(nth_of_sorted(fanouts, 0.99));
+    metrics["fanout_max"]            = static_cast<uint64_t>(nth_of_sorted(fanouts, 1.0));
+    metrics["tree_latency_p50_us"]   = static_cast<double>(latency.percentile(0.50)) / 1e3;
+    metrics["tree_latency_p99_us"]   = static_cast<double>(latency.percentile(0.99)) / 1e3;
+    metrics["critical_queue_share"]  = queue_share;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    if (args.positional().size() != 1) {
+        std::cerr << "usage: jlog_analyze <events.bin> [--window-ms 100] [--timeline]"
+                     " [--trees [--top 5]] [--out analysis.json]\n";
+        return 2;
+    }
+    const double window_ms = args.get_double("window-ms", 100.0);
+    const auto window_ns = static_cast<uint64_t>(std::max(window_ms, 0.001) * 1e6);
+
+    const bool with_trees = args.has("trees");
+    const auto top = static_cast<size_t>(std::max<int64_t>(0, args.get_int("top", 5)));
+
+    Analyzer analyzer(window_ns);
+    SpawnTreeAnalyzer trees;
+    std::unique_ptr<EventLogReader> reader;
+    uint64_t events = 0;
+    try {
+        reader = std::make_unique<EventLogReader>(args.positional()[0]);
+        reader->for_each([&](const LogEvent& ev) {
+            analyzer.add(ev);
+            if (with_trees) trees.add(ev);
+            ++events;
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "jlog_analyze: " << e.what() << "\n";
+        return 2;
+    }
+
+    std::cout << "\n=== Event Log Analysis (" << events << " events, "
+              << reader->clients().size() << " clients, "
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(reader->file_bytes()) / (1024.0 * 1024.0) << " MiB, "
+              << std::setprecision(0) << window_ms << " ms windows) ===\n\n";
+    Json run = analyzer.report(reader->clients(), args.has("timeline"));
+    if (with_trees) report_trees(trees, reader->clients(), top, run["metrics"]);
+
+    Json result = Json::object();
+    result["benchmark"] = "jlog_analyze";
+    result["config"]["log"] = args.positional()[0];
+    result["config"]["window_ms"] = window_ms;
+    result["config"]["events"] = events;
+    result["directions"]["wait_p50_us"] = "lower";
+    result["directions"]["wait_p99_us"] = "lower";
+    result["directions"]["wait_max_us"] = "lower";
+    result["directions"]["jain_window_mean"] = "higher";
+    result["directions"]["jain_window_p10"] = "higher";
+    result["directions"]["jain_window_min"] = "higher";
+    result["directions"]["throughput_jobs_per_s"] = "higher";
+    result["directions"]["tree_latency_p50_us"] = "lower";
+    result["directions"]["tree_latency_p99_us"] = "lower";
+    for (const char* k : {"trees", "tree_size_p50", "tree_size_max", "tree_depth_max",
+                          "fanout_mean", "fanout_p99", "fanout_max", "critical_queue_share"})
+        result["directions"][k] = "info";
+    for (const char* k : {"span_s", "completed", "run_p50_us", "run_p99_us", "worker_utilisation"})
+        result["directions"][k] = "info";
+    result["runs"] = Json::array();
+    result["runs"].push_back(std::move(run));
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
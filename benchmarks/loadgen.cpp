@@ -0,0 +1,558 @@
+// loadgen.cpp — Open-loop load generator with machine-readable JSON results
+//
+// Unlike scaling_bench (closed-loop: pre-submit everything, then start the
+// pool), each client here has its own generator thread that submits jobs on
+// a precomputed arrival schedule while the pool is running. Latency is
+// measured from the *intended* send time, so a stalled submitter (BLOCK
+// backpressure, a slow submit path) shows up as latency rather than being
+// hidden — i.e. the results are free of coordinated omission.
+//
+// Usage:
+//   loadgen --config load.json [--out results.json] [--repeat 5]
+//           [--trace arrivals.bin]   (record run 1 for `replay`)
+//           [--event-log events.bin] (log run 1 for `jlog_analyze`)
+//   loadgen --clients 4 --rate 20000 --arrival poisson --cost-us 5
+//           --workers 4 --policy drr --duration 5 --out results.json
+//
+// Config file (all fields optional except clients):
+//   {
+//     "duration_s": 5, "warmup_s": 1, "workers": 4, "policy": "drr",
+//     "drr_quantum": 100, "seed": 1, "repeat": 1,
+//     "clients": [{
+//       "name": "web", "weight": 2, "rate": 20000,
+//       "arrival": "poisson" | "uniform" | "bursty",
+//       "burst": {"on_ms": 50, "off_ms": 200},
+//       "cost": {"dist": "fixed" | "uniform" | "exponential" | "lognormal",
+//                "us": 5, "min_us": 1, "max_us": 10, "mean_us": 5, "sigma": 1},
+//       "cost_hint_per_us": 1,
+//       "priority": "NORMAL" | {"LOW": 0.1, "NORMAL": 0.8, "HIGH": 0.1},
+//       "deadline_ms": 50, "max_queue_depth": 0, "overflow": "reject"
+//     }]
+//   }
+//
+// "rate" is the mean arrival rate in jobs/s. For bursty clients the rate
+// during an on-period is scaled up so the long-run mean still equals "rate".
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/latency_histogram.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/event_log.h"
+#include "job_system/trace_recorder.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+// ---------------------------------------------------------------------------
+// Configuration
+// ---------------------------------------------------------------------------
+
+enum class Arrival { POISSON, UNIFORM, BURSTY };
+enum class CostDist { FIXED, UNIFORM, EXPONENTIAL, LOGNORMAL };
+
+struct ClientSpec {
+    std::string name;
+    size_t      weight{1};
+    double      rate{1000.0}; // mean jobs/s
+    Arrival     arrival{Arrival::POISSON};
+    double      burst_on_ms{50.0};
+    double      burst_off_ms{200.0};
+    CostDist    cost_dist{CostDist::FIXED};
+    double      cost_a_us{5.0}; // fixed/mean/min
+    double      cost_b_us{0.0}; // max (uniform) or sigma (lognormal)
+    double      cost_hint_per_us{1.0};
+    std::array<double, ClientState::NUM_PRIORITY_LEVELS> priority_weights{0, 1, 0, 0};
+    double      deadline_ms{0.0}; // 0 = none
+    size_t      max_queue_depth{0};
+    OverflowStrategy overflow{OverflowStrategy::REJECT};
+};
+
+struct Config {
+    double      duration_s{5.0};
+    double      warmup_s{1.0};
+    size_t      workers{4};
+    std::string policy{"wrr"};
+    uint32_t    drr_quantum{100};
+    uint64_t    seed{1};
+    int         repeat{1};
+    std::string trace_path;     // empty = no trace
+    std::string event_log_path; // empty = no event log
+    std::vector<ClientSpec> clients;
+};
+
+static Arrival parse_arrival(const std::string& s) {
+    const std::string n = bench::lower(s);
+    if (n == "poisson") return Arrival::POISSON;
+    if (n == "uniform") return Arrival::UNIFORM;
+    if (n == "bursty")  return Arrival::BURSTY;
+    throw std::invalid_argument("Unknown arrival process: " + s);
+}
+
+static const char* arrival_name(Arrival a) {
+    switch (a) {
+    case Arrival::POISSON: return "poisson";
+    case Arrival::UNIFORM: return "uniform";
+    case Arrival::BURSTY:  return "bursty";
+    }
+    return "?";
+}
+
+static CostDist parse_cost_dist(const std::string& s) {
+    const std::string n = bench::lower(s);
+    if (n == "fixed")       return CostDist::FIXED;
+    if (n == "uniform")     return CostDist::UNIFORM;
+    if (n == "exponential") return CostDist::EXPONENTIAL;
+    if (n == "lognormal")   return CostDist::LOGNORMAL;
+    throw std::invalid_argument("Unknown cost distribution: " + s);
+}
+
+static const char* cost_dist_name(CostDist d) {
+    switch (d) {
+    case CostDist::FIXED:       return "fixed";
+    case CostDist::UNIFORM:     return "uniform";
+    case CostDist::EXPONENTIAL: return "exponential";
+    case CostDist::LOGNORMAL:   return "lognormal";
+    }
+    return "?";
+}
+
+static ClientSpec parse_client(const Json& j, size_t index) {
+    ClientSpec c;
+    c.name   = j.string_or("name", "client-" + std::to_string(index));
+    c.weight = static_cast<size_t>(j.number_or("weight", 1));
+    c.rate   = j.number_or("rate", c.rate);
+    c.arrival = parse_arrival(j.string_or("arrival", "poisson"));
+    if (const Json* b = j.find("burst")) {
+        c.burst_on_ms  = b->number_or("on_ms", c.burst_on_ms);
+        c.burst_off_ms = b->number_or("off_ms", c.burst_off_ms);
+    }
+    if (const Json* cost = j.find("cost")) {
+        c.cost_dist = parse_cost_dist(cost->string_or("dist", "fixed"));
+        switch (c.cost_dist) {
+        case CostDist::FIXED:
+            c.cost_a_us = cost->number_or("us", c.cost_a_us);
+            break;
+        case CostDist::UNIFORM:
+            c.cost_a_us = cost->number_or("min_us", 1.0);
+            c.cost_b_us = cost->number_or("max_us", 10.0);
+            break;
+        case CostDist::EXPONENTIAL:
+            c.cost_a_us = cost->number_or("mean_us", c.cost_a_us);
+            break;
+        case CostDist::LOGNORMAL:
+            c.cost_a_us = cost->number_or("mean_us", c.cost_a_us);
+            c.cost_b_us = cost->number_or("sigma", 1.0);
+            break;
+        }
+    }
+    c.cost_hint_per_us = j.number_or("cost_hint_per_us", c.cost_hint_per_us);
+    if (const Json* p = j.find("priority")) {
+        c.priority_weights.fill(0.0);
+        if (p->is_string()) {
+            c.priority_weights[static_cast<size_t>(bench::parse_priority(p->as_string()))] = 1.0;
+        } else {
+            for (const auto& [name, w] : p->as_object())
+                c.priority_weights[static_cast<size_t>(bench::parse_priority(name))] =
+                    w.as_number();
+        }
+    }
+    c.deadline_ms     = j.number_or("deadline_ms", 0.0);
+    c.max_queue_depth = static_cast<size_t>(j.number_or("max_queue_depth", 0));
+    c.overflow        = bench::parse_overflow(j.string_or("overflow", "reject"));
+    return c;
+}
+
+static Config load_config(const bench::Args& args) {
+    Config cfg;
+    if (args.has("config")) {
+        Json j = Json::parse_file(args.get("config"));
+        cfg.duration_s  = j.number_or("duration_s", cfg.duration_s);
+        cfg.warmup_s    = j.number_or("warmup_s", cfg.warmup_s);
+        cfg.workers     = static_cast<size_t>(j.number_or("workers", 4));
+        cfg.policy      = j.string_or("policy", cfg.policy);
+        cfg.drr_quantum = static_cast<uint32_t>(j.number_or("drr_quantum", 100));
+        cfg.seed        = static_cast<uint64_t>(j.number_or("seed", 1));
+        cfg.repeat      = static_cast<int>(j.number_or("repeat", 1));
+        const auto& clients = j.at("clients").as_array();
+        for (size_t i = 0; i < clients.size(); ++i)
+            cfg.clients.push_back(parse_client(clients[i], i));
+    }
+
+    // Command-line values override the config file
+    cfg.duration_s  = args.get_double("duration", cfg.duration_s);
+    cfg.warmup_s    = args.get_double("warmup", cfg.warmup_s);
+    cfg.workers     = static_cast<size_t>(args.get_int("workers", static_cast<int64_t>(cfg.workers)));
+    cfg.policy      = args.get("policy", cfg.policy);
+    cfg.drr_quantum = static_cast<uint32_t>(args.get_int("drr-quantum", cfg.drr_quantum));
+    cfg.seed        = static_cast<uint64_t>(args.get_int("seed", static_cast<int64_t>(cfg.seed)));
+    cfg.repeat      = static_cast<int>(args.get_int("repeat", cfg.repeat));
+    cfg.trace_path  = args.get("trace");
+    cfg.event_log_path = args.get("event-log");
+
+    if (cfg.clients.empty()) {
+        // Quick mode: N identical clients described on the command line
+        const int64_t n = args.get_int("clients", 4);
+        for (int64_t i = 0; i < n; ++i) {
+            ClientSpec c;
+            c.name      = "client-" + std::to_string(i);
+            c.rate      = args.get_double("rate", 10'000.0);
+            c.arrival   = parse_arrival(args.get("arrival", "poisson"));
+            c.cost_dist = parse_cost_dist(args.get("cost-dist", "fixed"));
+            c.cost_a_us = args.get_double("cost-us", 5.0);
+            c.cost_b_us = args.get_double("cost-b", 0.0);
+            c.deadline_ms     = args.get_double("deadline-ms", 0.0);
+            c.max_queue_depth = static_cast<size_t>(args.get_int("max-depth", 0));
+            c.overflow        = bench::parse_overflow(args.get("overflow", "reject"));
+            cfg.clients.push_back(c);
+        }
+    }
+    if (cfg.warmup_s >= cfg.duration_s) {
+        throw std::invalid_argument("warmup must be shorter than duration");
+    }
+    return cfg;
+}
+
+static Json config_to_json(const Config& cfg) {
+    Json j = Json::object();
+    j["duration_s"]  = cfg.duration_s;
+    j["warmup_s"]    = cfg.warmup_s;
+    j["workers"]     = cfg.workers;
+    j["policy"]      = cfg.policy;
+    j["drr_quantum"] = cfg.drr_quantum;
+    j["seed"]        = cfg.seed;
+    j["repeat"]      = cfg.repeat;
+    Json clients = Json::array();
+    for (const auto& c : cfg.clients) {
+        Json cj = Json::object();
+        cj["name"]    = c.name;
+        cj["weight"]  = c.weight;
+        cj["rate"]    = c.rate;
+        cj["arrival"] = arrival_name(c.arrival);
+        if (c.arrival == Arrival::BURSTY) {
+            cj["burst"]["on_ms"]  = c.burst_on_ms;
+            cj["burst"]["off_ms"] = c.burst_off_ms;
+        }
+        cj["cost"]["dist"] = cost_dist_name(c.cost_dist);
+        cj["cost"]["a_us"] = c.cost_a_us;
+        cj["cost"]["b_us"] = c.cost_b_us;
+        cj["cost_hint_per_us"] = c.cost_hint_per_us;
+        for (size_t p = 0; p < c.priority_weights.size(); ++p) {
+            if (c.priority_weights[p] > 0.0)
+                cj["priority"][bench::priority_name(static_cast<Priority>(p))] =
+                    c.priority_weights[p];
+        }
+        cj["deadline_ms"]     = c.deadline_ms;
+        cj["max_queue_depth"] = c.max_queue_depth;
+        cj["overflow"]        = bench::overflow_name(c.overflow);
+        clients.push_back(std::move(cj));
+    }
+    j["clients"] = std::move(clients);
+    return j;
+}
+
+// ---------------------------------------------------------------------------
+// Per-run measurement state
+// ---------------------------------------------------------------------------
+
+struct ClientStats {
+    std::atomic<uint64_t> offered{0};   // arrivals generated in the window
+    std::atomic<uint64_t> rejected{0};  // QueueFullException
+    std::atomic<uint64_t> completed{0}; // finished inside the window
+    bench::LatencyHistogram start_latency_ns; // intended send → task start
+    bench::LatencyHistogram end_latency_ns;   // intended send → task end
+};
+
+// Samples inter-arrival gaps and job costs for one client
+class ArrivalProcess {
+public:
+    ArrivalProcess(const ClientSpec& spec, uint64_t seed)
+        : spec_(spec), rng_(seed),
+          prio_(spec.priority_weights.begin(), spec.priority_weights.end()) {
+        const double period_ms = spec.burst_on_ms + spec.burst_off_ms;
+        on_rate_ = spec.arrival == Arrival::BURSTY
+                       ? spec.rate * period_ms / spec.burst_on_ms
+                       : spec.rate;
+    }
+
+    // Returns the next intended send time strictly after `t` (ns offsets
+    // relative to the run start).
+    int64_t next_arrival(int64_t t) {
+        switch (spec_.arrival) {
+        case Arrival::UNIFORM:
+            return t + static_cast<int64_t>(1e9 / spec_.rate);
+        case Arrival::POISSON:
+            return t + exp_gap(spec_.rate);
+        case Arrival::BURSTY: {
+            const int64_t on_ns  = static_cast<int64_t>(spec_.burst_on_ms * 1e6);
+            const int64_t period = on_ns + static_cast<int64_t>(spec_.burst_off_ms * 1e6);
+            int64_t next = t + exp_gap(on_rate_);
+            // Arrivals that fall in an off-period slide to the next on-period
+            if (next % period >= on_ns) next = (next / period + 1) * period;
+            return next;
+        }
+        }
+        return t;
+    }
+
+    int64_t sample_cost_ns() {
+        double us = spec_.cost_a_us;
+        switch (spec_.cost_dist) {
+        case CostDist::FIXED:
+            break;
+        case CostDist::UNIFORM:
+            us = std::uniform_real_distribution<double>(spec_.cost_a_us, spec_.cost_b_us)(rng_);
+            break;
+        case CostDist::EXPONENTIAL:
+            us = std::exponential_distribution<double>(1.0 / spec_.cost_a_us)(rng_);
+            break;
+        case CostDist::LOGNORMAL: {
+            const double sigma = spec_.cost_b_us;
+            const double mu = std::log(spec_.cost_a_us) - sigma * sigma / 2.0;
+            us = std::lognormal_distribution<double>(mu, sigma)(rng_);
+            break;
+        }
+        }
+        return static_cast<int64_t>(std::max(0.0, us) * 1000.0);
+    }
+
+    Priority sample_priority() { return static_cast<Priority>(prio_(rng_)); }
+
+private:
+    int64_t exp_gap(double rate) {
+        return static_cast<int64_t>(std::exponential_distribution<double>(rate)(rng_) * 1e9);
+    }
+
+    const ClientSpec& spec_;
+    std::mt19937_64 rng_;
+    std::discrete_distribution<int> prio_;
+    double on_rate_{0.0};
+};
+
+// Sleeps until close to `target`, then spins the remainder for precision
+static void wait_until(steady_clock::time_point target) {
+    constexpr auto SPIN_WINDOW = microseconds(100);
+    auto now = steady_clock::now();
+    if (target - now > SPIN_WINDOW) std::this_thread::sleep_until(target - SPIN_WINDOW);
+    while (steady_clock::now() < target) std::this_thread::yield();
+}
+
+// `record`: attach the trace recorder / event log if configured
+static Json run_once(const Config& cfg, uint64_t seed, bool record) {
+    Scheduler sched(bench::make_policy(cfg.policy, cfg.drr_quantum));
+    if (record && !cfg.trace_path.empty()) {
+        sched.set_trace_recorder(std::make_shared<TraceRecorder>(cfg.trace_path));
+    }
+    if (record && !cfg.event_log_path.empty()) {
+        sched.set_event_log(std::make_shared<EventLog>(cfg.event_log_path));
+    }
+    for (const auto& c : cfg.clients)
+        sched.register_client(c.name, c.weight, c.max_queue_depth, c.overflow);
+
+    std::vector<std::unique_ptr<ClientStats>> stats;
+    for (size_t i = 0; i < cfg.clients.size(); ++i)
+        stats.push_back(std::make_unique<ClientStats>());
+
+    const int64_t duration_ns = static_cast<int64_t>(cfg.duration_s * 1e9);
+    const int64_t warmup_ns   = static_cast<int64_t>(cfg.warmup_s * 1e9);
+
+    ThreadPool pool(sched, cfg.workers);
+
+    // Common start a little in the future so all generators begin together
+    const auto t0 = steady_clock::now() + milliseconds(20);
+    const auto window_end   = t0 + nanoseconds(duration_ns);
+
+    std::vector<std::jthread> generators;
+    for (size_t ci = 0; ci < cfg.clients.size(); ++ci) {
+        generators.emplace_back([&, ci] {
+            const ClientSpec& spec = cfg.clients[ci];
+            ClientStats* st = stats[ci].get();
+            ArrivalProcess proc(spec, seed * 7919 + ci);
+
+            for (int64_t t = proc.next_arrival(0); t < duration_ns; t = proc.next_arrival(t)) {
+                const auto intended = t0 + nanoseconds(t);
+                wait_until(intended);
+
+                const bool measured = t >= warmup_ns;
+                const int64_t cost_ns = proc.sample_cost_ns();
+                const auto cost_hint = static_cast<uint32_t>(std::max(
+                    1.0, std::round(static_cast<double>(cost_ns) / 1000.0 * spec.cost_hint_per_us)));
+                const auto deadline = spec.deadline_ms > 0.0
+                    ? intended + duration_cast<steady_clock::duration>(
+                                     duration<double, std::milli>(spec.deadline_ms))
+                    : steady_clock::time_point{};
+
+                if (measured) st->offered.fetch_add(1, std::memory_order_relaxed);
+                try {
+                    sched.submit(spec.name, [st, intended, cost_ns, measured, window_end] {
+                        const auto start = steady_clock::now();
+                        bench::spin_for(nanoseconds(cost_ns));
+                        const auto end = steady_clock::now();
+                        if (!measured) return;
+                        st->start_latency_ns.record(static_cast<uint64_t>(
+                            duration_cast<nanoseconds>(start - intended).count()));
+                        st->end_latency_ns.record(static_cast<uint64_t>(
+                            duration_cast<nanoseconds>(end - intended).count()));
+                        if (end <= window_end)
+                            st->completed.fetch_add(1, std::memory_order_relaxed);
+                    }, cost_hint, proc.sample_priority(), deadline);
+                } catch (const QueueFullException&) {
+                    if (measured) st->rejected.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    generators.clear(); // join
+    pool.shutdown(ShutdownMode::GRACEFUL);
+
+    // ── Aggregate ────────────────────────────────────────────────────────────
+    const double window_s = static_cast<double>(duration_ns - warmup_ns) / 1e9;
+
+    Json run = Json::object();
+    run["seed"] = seed;
+    Json clients = Json::object();
+    bench::LatencyHistogram all_start, all_end;
+    uint64_t offered = 0, completed = 0, rejected = 0, overflow = 0, expired = 0;
+    std::vector<double> normalized; // completions / weight, per client
+
+    for (size_t ci = 0; ci < cfg.clients.size(); ++ci) {
+        const auto& spec = cfg.clients[ci];
+        const auto& st = *stats[ci];
+        const auto m = sched.get_client_metrics(spec.name);
+
+        Json cj = Json::object();
+        cj["offered"]   = st.offered.load();
+        cj["rejected"]  = st.rejected.load();
+        cj["overflow"]  = m.overflow_count;
+        cj["expired"]   = m.expired_count;
+        cj["completed_in_window"] = st.completed.load();
+        cj["throughput_jobs_per_s"] = static_cast<double>(st.completed.load()) / window_s;
+        cj["start_latency_us"] = st.start_latency_ns.summary(1e-3);
+        cj["end_latency_us"]   = st.end_latency_ns.summary(1e-3);
+        clients[spec.name] = std::move(cj);
+
+        all_start.merge(st.start_latency_ns);
+        all_end.merge(st.end_latency_ns);
+        offered   += st.offered.load();
+        completed += st.completed.load();
+        rejected  += st.rejected.load();
+        overflow  += m.overflow_count;
+        expired   += m.expired_count;
+        normalized.push_back(static_cast<double>(st.completed.load()) /
+                             static_cast<double>(spec.weight));
+    }
+
+    Json metrics = Json::object();
+    metrics["offered_jobs_per_s"]    = static_cast<double>(offered) / window_s;
+    metrics["throughput_jobs_per_s"] = static_cast<double>(completed) / window_s;
+    metrics["start_latency_p50_us"]  = static_cast<double>(all_start.percentile(0.50)) / 1e3;
+    metrics["start_latency_p99_us"]  = static_cast<double>(all_start.percentile(0.99)) / 1e3;
+    metrics["start_latency_p999_us"] = static_cast<double>(all_start.percentile(0.999)) / 1e3;
+    metrics["end_latency_p50_us"]    = static_cast<double>(all_end.percentile(0.50)) / 1e3;
+    metrics["end_latency_p99_us"]    = static_cast<double>(all_end.percentile(0.99)) / 1e3;
+    metrics["end_latency_p999_us"]   = static_cast<double>(all_end.percentile(0.999)) / 1e3;
+    metrics["rejected"]              = rejected;
+    metrics["overflow"]              = overflow;
+    metrics["expired"]               = expired;
+    metrics["jain_fairness_index"]   = sched.get_global_metrics().jain_fairness_index;
+    metrics["weighted_jain_index"]   = bench::jain_index(normalized);
+
+    run["metrics"] = std::move(metrics);
+    run["clients"] = std::move(clients);
+    return run;
+}
+
+// Which way is "better" for each run-level metric (consumed by bench_compare)
+static Json metric_directions() {
+    Json d = Json::object();
+    d["offered_jobs_per_s"]    = "info";
+    d["throughput_jobs_per_s"] = "higher";
+    for (const char* k : {"start_latency_p50_us", "start_latency_p99_us",
+                          "start_latency_p999_us", "end_latency_p50_us",
+                          "end_latency_p99_us", "end_latency_p999_us",
+                          "rejected", "overflow", "expired"})
+        d[k] = "lower";
+    d["jain_fairness_index"] = "higher";
+    d["weighted_jain_index"] = "higher";
+    return d;
+}
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    Config cfg;
+    try {
+        cfg = load_config(args);
+    } catch (const std::exception& e) {
+        std::cerr << "loadgen: " << e.what() << "\n";
+        return 2;
+    }
+
+    std::cout << "\n=== Open-Loop Load Generator (" << cfg.clients.size()
+              << " clients, " << cfg.workers << " workers, policy=" << cfg.policy
+              << ", " << cfg.duration_s << "s incl. " << cfg.warmup_s
+              << "s warmup) ===\n\n";
+
+    Json result = Json::object();
+    result["benchmark"]  = "loadgen";
+    result["config"]     = config_to_json(cfg);
+    result["directions"] = metric_directions();
+    result["runs"]       = Json::array();
+
+    for (int r = 0; r < cfg.repeat; ++r) {
+        Json run = run_once(cfg, cfg.seed + static_cast<uint64_t>(r), r == 0);
+        const Json& m = run.at("metrics");
+
+        std::cout << "Run " << (r + 1) << "/" << cfg.repeat << "\n";
+        std::cout << std::left << std::setw(14) << "  Client"
+                  << std::right << std::setw(12) << "Offered/s"
+                  << std::setw(12) << "Done/s"
+                  << std::setw(10) << "Reject"
+                  << std::setw(10) << "Expired"
+                  << std::setw(12) << "Start p50"
+                  << std::setw(12) << "Start p99"
+                  << std::setw(12) << "End p99" << "  (µs)\n";
+        std::cout << "  " << std::string(92, '-') << "\n";
+        const double window_s = cfg.duration_s - cfg.warmup_s;
+        for (const auto& [name, c] : run.at("clients").as_object()) {
+            std::cout << "  " << std::left << std::setw(12) << name << std::right
+                      << std::fixed << std::setprecision(0)
+                      << std::setw(12) << c.at("offered").as_number() / window_s
+                      << std::setw(12) << c.at("throughput_jobs_per_s").as_number()
+                      << std::setw(10) << c.at("rejected").as_number()
+                      << std::setw(10) << c.at("expired").as_number()
+                      << std::setprecision(1)
+                      << std::setw(12) << c.at("start_latency_us").at("p50").as_number()
+                      << std::setw(12) << c.at("start_latency_us").at("p99").as_number()
+                      << std::setw(12) << c.at("end_latency_us").at("p99").as_number()
+                      << "\n";
+        }
+        std::cout << "  Throughput " << std::setprecision(0)
+                  << m.at("throughput_jobs_per_s").as_number() << " jobs/s, start p99 "
+                  << std::setprecision(1) << m.at("start_latency_p99_us").as_number()
+                  << " µs, weighted Jain " << std::setprecision(3)
+                  << m.at("weighted_jain_index").as_number() << "\n\n";
+
+        result["runs"].push_back(std::move(run));
+    }
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "Results written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+// mapreduce_bench.cpp — Word count over generated text with MapReduce
+//
+// Generates --mb of text whose words follow a Zipf distribution over a
+// --vocab word vocabulary, splits it into lines and counts the words with
+// MapReduce<std::string, uint64_t> on one client of a Scheduler + ThreadPool
+// (bulk_chunks = workers + 1: the calling thread helps). Each run is checked
+// against a serial count. Reports input GB/s, the shuffle volume and spills
+// for every combination of worker count, combiner on/off and memory limit.
+//
+// Usage:
+//   mapreduce_bench [--mb 64] [--vocab 50000] [--workers 1,2,4]
+//                   [--combiner off,on] [--limits-kb 0,256] [--repeat 3]
+//                   [--out r.json]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "job_system/map_reduce.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+using WordCount = MapReduce<std::string, uint64_t>;
+
+// Text plus views of its lines; the views point into `text`
+struct Corpus {
+    std::string text;
+    std::vector<std::string_view> lines;
+};
+
+Corpus make_corpus(size_t bytes, size_t vocab, unsigned seed) {
+    std::vector<std::string> words(vocab);
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < vocab; ++i) {
+        const size_t len = 3 + rng() % 8;
+        for (size_t c = 0; c < len; ++c) words[i] += static_cast<char>('a' + rng() % 26);
+        words[i] += std::to_string(i); // distinct
+    }
+    // Zipf(1) by inverse CDF over the vocabulary ranks
+    std::vector<double> cdf(vocab);
+    double total = 0.0;
+    for (size_t i = 0; i < vocab; ++i) cdf[i] = total += 1.0 / static_cast<double>(i + 1);
+    std::uniform_real_distribution<double> u(0.0, total);
+
+    Corpus c;
+    c.text.reserve(bytes + 64);
+    size_t line_len = 0;
+    while (c.text.size() < bytes) {
+        const size_t w = static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+        c.text += words[std::min(w, vocab - 1)];
+        line_len += words[w].size();
+        if (line_len > 80) {
+            c.text += '\n';
+            line_len = 0;
+        } else {
+            c.text += ' ';
+        }
+    }
+    size_t start = 0;
+    while (start < c.text.size()) {
+        const size_t end = std::min(c.text.find('\n', start), c.text.size());
+        c.lines.emplace_back(c.text.data() + start, end - start);
+        start = end + 1;
+    }
+    return c;
+}
+
+template <typename F>
+void for_each_word(std::string_view line, F&& f) {
+    size_t start = 0;
+    while (start < line.size()) {
+        const size_t end = std::min(line.find(' ', start), line.size());
+        if (end > start) f(line.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+std::unordered_map<std::string_view, uint64_t> serial_count(const Corpus& c) {
+    std::unordered_map<std::string_view, uint64_t> counts;
+    for (auto line : c.lines) for_each_word(line, [&](std::string_view w) { ++counts[w]; });
+    return counts;
+}
+
+bool same_counts(const std::vector<std::pair<std::string, uint64_t>>& got,
+                 const std::unordered_map<std::string_view, uint64_t>& expect) {
+    if (got.size() != expect.size()) return false;
+    for (const auto& [word, n] : got) {
+        auto it = expect.find(word);
+        if (it == expect.end() || it->second != n) return false;
+    }
+    return true;
+}
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = std::min(s.find(',', start), s.size());
+        if (comma > start) out.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    const size_t mb = static_cast<size_t>(args.get_int("mb", 64));
+    const size_t vocab = static_cast<size_t>(std::max<int64_t>(1, args.get_int("vocab", 50'000)));
+    const auto workers = args.get_int_list("workers", {1, 2, 4});
+    const auto limits_kb = args.get_int_list("limits-kb", {0, 256});
+    const auto combiners = split_list(args.get("combiner", "off,on"));
+    const int repeat = static_cast<int>(args.get_int("repeat", 3));
+
+    const Corpus corpus = make_corpus(mb << 20, vocab, 42);
+    const auto expect = serial_count(corpus);
+    const double gb = static_cast<double>(corpus.text.size()) / 1e9;
+
+    std::cout << "\n=== MapReduce word count, " << mb << " MB, " << corpus.lines.size()
+              << " lines, " << expect.size() << " distinct words (best of " << repeat
+              << ") ===\n\n";
+    std::cout << std::left << std::setw(9) << "Workers" << std::setw(10) << "Combiner"
+              << std::right << std::setw(10) << "Limit KB" << std::setw(11) << "Wall ms"
+              << std::setw(9) << "GB/s" << std::setw(14) << "Shuffled" << std::setw(9)
+              << "Spills" << "\n";
+    std::cout << std::string(72, '-') << "\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "mapreduce_bench";
+    result["config"]["mb"] = mb;
+    result["config"]["vocab"] = vocab;
+    result["directions"] = Json::object();
+    result["runs"] = Json::array();
+    for (int r = 0; r < repeat; ++r) {
+        Json run = Json::object();
+        run["metrics"] = Json::object();
+        result["runs"].push_back(std::move(run));
+    }
+
+    auto map = [](std::string_view line, WordCount::Emitter& out) {
+        for_each_word(line, [&](std::string_view w) { out.emit(std::string(w), 1); });
+    };
+    auto reduce = [](const std::string&, std::vector<uint64_t>& n) {
+        return std::accumulate(n.begin(), n.end(), uint64_t{0});
+    };
+
+    int failures = 0;
+    for (int64_t w : workers) {
+        Scheduler sched;
+        sched.register_client("mr");
+        ThreadPool pool(sched, static_cast<size_t>(w));
+        const auto cs = sched.get_scheduler("mr").with_bulk_chunks(static_cast<size_t>(w) + 1);
+
+        for (const auto& comb : combiners) {
+            for (int64_t kb : limits_kb) {
+                MapReduceOptions opts;
+                opts.memory_limit_bytes = static_cast<size_t>(kb) << 10;
+                WordCount mr(cs, opts);
+                if (comb == "on") mr.set_combiner([](uint64_t a, uint64_t b) { return a + b; });
+
+                double best_ms = 1e300;
+                for (int r = 0; r < repeat; ++r) {
+                    const auto t0 = steady_clock::now();
+                    const auto counts = mr.run(corpus.lines.begin(), corpus.lines.end(), map, reduce);
+                    const double ms = duration<double, std::milli>(steady_clock::now() - t0).count();
+                    if (!same_counts(counts, expect)) {
+                        std::cerr << "mapreduce_bench: wrong counts (workers=" << w
+                                  << " combiner=" << comb << " limit_kb=" << kb << ")\n";
+                        ++failures;
+                    }
+                    best_ms = std::min(best_ms, ms);
+
+                    const std::string prefix = "w" + std::to_string(w) + "_combiner_" + comb +
+                                               "_limit" + std::to_string(kb) + "k_";
+                    Json& m = result["runs"].as_array()[static_cast<size_t>(r)]["metrics"];
+                    m[prefix + "gb_per_s"] = gb / (ms / 1e3);
+                    m[prefix + "shuffled"] = mr.stats().shuffled;
+                    m[prefix + "spilled_bytes"] = mr.stats().spilled_bytes;
+                    result["directions"][prefix + "gb_per_s"] = "higher";
+                    result["directions"][prefix + "shuffled"] = "lower";
+                    result["directions"][prefix + "spilled_bytes"] = "lower";
+                }
+                std::cout << std::left << std::setw(9) << w << std::setw(10) << comb << std::right
+                          << std::setw(10) << kb << std::fixed << std::setprecision(1)
+                          << std::setw(11) << best_ms << std::setprecision(3) << std::setw(9)
+                          << gb / (best_ms / 1e3) << std::setw(14) << mr.stats().shuffled
+                          << std::setw(9) << mr.stats().spills << "\n";
+            }
+        }
+        pool.shutdown();
+    }
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return failures ? 1 : 0;
+}
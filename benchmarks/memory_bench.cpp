@@ -0,0 +1,284 @@
+// memory_bench.cpp — Memory footprint per queued job and per idle client
+//
+// Measures what a deep queue or a large tenant registry actually costs:
+//   * per queued job  — at several queue depths and captured-closure sizes
+//     (Task keeps closures of up to 24 bytes inline in the Job and
+//     heap-allocates larger ones, so the step between sizes shows where that
+//     happens)
+//   * per idle client — register N clients with nothing queued: unbounded,
+//     bounded BLOCK (max depth 64, which adds the cold ClientLimits block),
+//     and unbounded after each has run one job (its NORMAL-level queue has
+//     been materialised and stays until the client is drained)
+//
+// Each point reports allocator bytes in use (mallinfo2, includes chunk
+// headers), RSS growth, and heap allocations per item (counted by replacing
+// global operator new in this program). The residual heap growth after
+// teardown is reported too — for jobs after a drain (what the emptied queues
+// keep), for clients after the Scheduler is destroyed — so leaks show up as a
+// number rather than an OOM weeks later.
+//
+// Usage:
+//   memory_bench [--depths 1000,100000,1000000] [--closures 0,16,32,64,256]
+//                [--clients 1000,10000,100000] [--client-name-len 8]
+//                [--out r.json]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/memory_stats.h"
+#include "job_system/client_state.h"
+#include "job_system/job.h"
+#include "job_system/scheduler.h"
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+// ---------------------------------------------------------------------------
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+} // namespace
+
+void* operator new(std::size_t n) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+// Over-aligned types (Job is one aligned cache line) come through here
+void* operator new(std::size_t n, std::align_val_t al) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(al);
+    if (void* p = std::aligned_alloc(align, (std::max<std::size_t>(n, 1) + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace job_system;
+using bench::Json;
+
+namespace {
+
+// A task whose closure captures exactly `N` bytes
+template <size_t N>
+Task make_task() {
+    if constexpr (N == 0) {
+        return [] {};
+    } else {
+        std::array<char, N> payload{};
+        payload[0] = 1;
+        return [payload] { (void)payload; };
+    }
+}
+
+using TaskFactory = Task (*)();
+
+TaskFactory task_of_size(int64_t bytes) {
+    switch (bytes) {
+    case 0:   return &make_task<0>;
+    case 8:   return &make_task<8>;
+    case 16:  return &make_task<16>;
+    case 24:  return &make_task<24>;
+    case 32:  return &make_task<32>;
+    case 64:  return &make_task<64>;
+    case 128: return &make_task<128>;
+    case 256: return &make_task<256>;
+    case 512: return &make_task<512>;
+    }
+    throw std::invalid_argument("Unsupported closure size (0/8/16/24/32/64/128/256/512): " +
+                                std::to_string(bytes));
+}
+
+struct Sample {
+    double heap_per_item{0};
+    double rss_per_item{0};
+    double allocs_per_item{0};
+    double residual_bytes{0};
+};
+
+struct Probe {
+    uint64_t heap, rss, allocs;
+    static Probe take() {
+        return {bench::heap_in_use_bytes(), bench::rss_bytes(),
+                g_allocations.load(std::memory_order_relaxed)};
+    }
+};
+
+double per(uint64_t after, uint64_t before, int64_t n) {
+    return (static_cast<double>(after) - static_cast<double>(before)) / static_cast<double>(n);
+}
+
+Sample measure_jobs(const std::string& client, int64_t depth, int64_t closure) {
+    Scheduler sched;
+    sched.register_client(client);
+    const TaskFactory make = task_of_size(closure);
+
+    bench::trim_heap();
+    const Probe p0 = Probe::take();
+    for (int64_t i = 0; i < depth; ++i) sched.submit(client, make());
+    const Probe p1 = Probe::take();
+
+    sched.drain_all_clients();
+    bench::trim_heap();
+    const Probe p2 = Probe::take();
+
+    return {per(p1.heap, p0.heap, depth), per(p1.rss, p0.rss, depth),
+            per(p1.allocs, p0.allocs, depth),
+            static_cast<double>(p2.heap) - static_cast<double>(p0.heap)};
+}
+
+enum class ClientKind { IDLE, BLOCK, USED };
+
+struct ClientKindInfo {
+    ClientKind kind;
+    const char* label;
+    const char* key; // metric key prefix
+};
+
+constexpr std::array<ClientKindInfo, 3> CLIENT_KINDS{{
+    {ClientKind::IDLE, "idle", "client_"},
+    {ClientKind::BLOCK, "block", "client_block_"},
+    {ClientKind::USED, "used", "client_used_"},
+}};
+
+Sample measure_clients(int64_t n, size_t name_len, ClientKind kind) {
+    std::vector<std::string> names;
+    names.reserve(static_cast<size_t>(n));
+    for (int64_t i = 0; i < n; ++i) {
+        std::string name = "c" + std::to_string(i);
+        name.resize(std::max(name.size(), name_len), 'x');
+        names.push_back(std::move(name));
+    }
+
+    bench::trim_heap();
+    const Probe p0 = Probe::take();
+    auto sched = std::make_unique<Scheduler>();
+    for (const auto& name : names) {
+        if (kind == ClientKind::BLOCK) {
+            sched->register_client(name, 1, 64, OverflowStrategy::BLOCK);
+        } else {
+            sched->register_client(name);
+        }
+    }
+    if (kind == ClientKind::USED) {
+        for (const auto& name : names) sched->submit(name, [] {});
+        Job job;
+        while (sched->select_next_job(job)) sched->execute(job);
+    }
+    const Probe p1 = Probe::take();
+
+    // Destroyed rather than unregistered one by one: unregister_client keeps
+    // the registry's slot columns for reuse, so it would leave them behind
+    sched.reset();
+    bench::trim_heap();
+    const Probe p2 = Probe::take();
+
+    return {per(p1.heap, p0.heap, n), per(p1.rss, p0.rss, n), per(p1.allocs, p0.allocs, n),
+            static_cast<double>(p2.heap) - static_cast<double>(p0.heap)};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    const auto depths   = args.get_int_list("depths", {1000, 100000, 1000000});
+    const auto closures = args.get_int_list("closures", {0, 16, 32, 64, 256});
+    const auto clients  = args.get_int_list("clients", {1000, 10000, 100000});
+    const auto name_len = static_cast<size_t>(args.get_int("client-name-len", 8));
+
+    std::string client(name_len, 'c');
+    for (int64_t c : closures) {
+        try {
+            task_of_size(c);
+        } catch (const std::exception& e) {
+            std::cerr << "memory_bench: " << e.what() << "\n";
+            return 2;
+        }
+    }
+
+    Json result = Json::object();
+    result["benchmark"] = "memory_bench";
+    result["config"]["client_name_len"] = name_len;
+    result["config"]["sizeof_job"] = sizeof(Job);
+    result["config"]["sizeof_client_state"] = sizeof(ClientState);
+    result["config"]["sizeof_client_limits"] = sizeof(ClientLimits);
+    result["config"]["sizeof_task"] = sizeof(Task);
+    result["directions"] = Json::object();
+    Json metrics = Json::object();
+    auto put = [&](const std::string& key, double v, const char* dir) {
+        metrics[key] = v;
+        result["directions"][key] = dir;
+    };
+
+    std::cout << "\n=== Memory Footprint (sizeof Job " << sizeof(Job) << " B, ClientState "
+              << sizeof(ClientState) << " B (+" << sizeof(ClientLimits)
+              << " B bounded), Task " << sizeof(Task)
+              << " B; client id " << name_len << " chars) ===\n\n";
+    std::cout << "Per queued job\n";
+    std::cout << std::right << std::setw(10) << "Closure B" << std::setw(10) << "Depth"
+              << std::setw(12) << "Heap B/job" << std::setw(11) << "RSS B/job"
+              << std::setw(12) << "Allocs/job" << std::setw(14) << "Residual B" << "\n";
+    std::cout << std::string(69, '-') << "\n";
+    for (int64_t c : closures) {
+        for (int64_t d : depths) {
+            const Sample s = measure_jobs(client, d, c);
+            std::cout << std::setw(10) << c << std::setw(10) << d << std::fixed
+                      << std::setprecision(1) << std::setw(12) << s.heap_per_item
+                      << std::setw(11) << s.rss_per_item << std::setprecision(2)
+                      << std::setw(12) << s.allocs_per_item << std::setprecision(0)
+                      << std::setw(14) << s.residual_bytes << "\n";
+            const std::string k = "job_c" + std::to_string(c) + "_d" + std::to_string(d) + "_";
+            put(k + "heap_bytes", s.heap_per_item, "lower");
+            put(k + "rss_bytes", s.rss_per_item, "lower");
+            put(k + "allocs", s.allocs_per_item, "lower");
+            put(k + "residual_bytes", s.residual_bytes, "lower");
+        }
+    }
+
+    std::cout << "\nPer idle registered client\n";
+    std::cout << std::right << std::setw(7) << "Kind" << std::setw(10) << "Clients"
+              << std::setw(15) << "Heap B/client"
+              << std::setw(14) << "RSS B/client" << std::setw(15) << "Allocs/client"
+              << std::setw(14) << "Residual B" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+    for (const auto& kind : CLIENT_KINDS) {
+        for (int64_t n : clients) {
+            const Sample s = measure_clients(n, name_len, kind.kind);
+            std::cout << std::setw(7) << kind.label << std::setw(10) << n
+                      << std::setprecision(1) << std::setw(15) << s.heap_per_item
+                      << std::setw(14) << s.rss_per_item << std::setprecision(2)
+                      << std::setw(15) << s.allocs_per_item << std::setprecision(0)
+                      << std::setw(14) << s.residual_bytes << "\n";
+            const std::string k = kind.key + ("n" + std::to_string(n)) + "_";
+            put(k + "heap_bytes", s.heap_per_item, "lower");
+            put(k + "rss_bytes", s.rss_per_item, "lower");
+            put(k + "allocs", s.allocs_per_item, "lower");
+            put(k + "residual_bytes", s.residual_bytes, "lower");
+        }
+    }
+
+    Json run = Json::object();
+    run["metrics"] = std::move(metrics);
+    result["runs"] = Json::array();
+    result["runs"].push_back(std::move(run));
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,624 @@
+// microbench.cpp — Google Benchmark suite for scheduler primitives
+//
+// Single-threaded cost of each Scheduler entry point, plus contended variants
+// across 1–64 threads. Every performance change should be measured against
+// this baseline:
+//
+//   ./job_system_microbench --benchmark_repetitions=5
+//       --benchmark_out=base.json --benchmark_out_format=json
+//
+// Queues are drained outside the timed region so that long runs do not grow
+// memory without bound.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "job_system/clock.h"
+#include "job_system/completion_queue.h"
+#include "job_system/drr_policy.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/submit_buffer.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int64_t DRAIN_EVERY = 4096; // submits between untimed drains
+
+enum PolicyKind : int64_t { WRR = 0, DRR = 1 };
+
+std::unique_ptr<ISchedulingPolicy> make_policy(int64_t kind) {
+    if (kind == DRR) return std::make_unique<DeficitRoundRobinPolicy>();
+    return std::make_unique<WeightedRoundRobinPolicy>();
+}
+
+const char* policy_name(int64_t kind) { return kind == DRR ? "DRR" : "WRR"; }
+
+std::string client_name(int64_t i) { return "client-" + std::to_string(i); }
+
+std::vector<std::string> register_clients(Scheduler& sched, int64_t n,
+                                          size_t max_depth = 0,
+                                          OverflowStrategy strategy =
+                                              OverflowStrategy::REJECT) {
+    std::vector<std::string> ids;
+    ids.reserve(static_cast<size_t>(n));
+    for (int64_t i = 0; i < n; ++i) {
+        ids.push_back(client_name(i));
+        sched.register_client(ids.back(), 1, max_depth, strategy);
+    }
+    return ids;
+}
+
+void noop() {}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// submit
+// ---------------------------------------------------------------------------
+
+// Args: {client count}
+static void BM_Submit(benchmark::State& state) {
+    Scheduler sched;
+    auto ids = register_clients(sched, state.range(0));
+    size_t next = 0;
+    int64_t since_drain = 0;
+
+    for (auto _ : state) {
+        sched.submit(ids[next], noop);
+        if (++next == ids.size()) next = 0;
+        if (++since_drain == DRAIN_EVERY) {
+            state.PauseTiming();
+            sched.drain_all_clients();
+            since_drain = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Submit)->ArgName("clients")->RangeMultiplier(4)->Range(1, 1024);
+
+// Args: {priority level}
+static void BM_SubmitPriority(benchmark::State& state) {
+    Scheduler sched;
+    sched.register_client("A");
+    const auto prio = static_cast<Priority>(state.range(0));
+    int64_t since_drain = 0;
+
+    for (auto _ : state) {
+        sched.submit("A", noop, 1, prio);
+        if (++since_drain == DRAIN_EVERY) {
+            state.PauseTiming();
+            sched.drain_client("A");
+            since_drain = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SubmitPriority)->ArgName("priority")->DenseRange(0, 3);
+
+// Submit into a client that is already at max_queue_depth, so every call
+// takes the overflow path. BLOCK cannot be measured at capacity from a single
+// thread; it is measured one slot below capacity (the admission check only).
+// CALLER_RUNS includes running the displaced no-op inline.
+// Args: {OverflowStrategy}
+static void BM_SubmitOverflow(benchmark::State& state) {
+    constexpr size_t DEPTH = 64;
+    const auto strategy = static_cast<OverflowStrategy>(state.range(0));
+    Scheduler sched;
+    sched.register_client("A", 1, DEPTH, strategy);
+
+    const size_t prefill =
+        strategy == OverflowStrategy::BLOCK ? DEPTH - 1 : DEPTH;
+    auto refill = [&] {
+        sched.drain_client("A");
+        for (size_t i = 0; i < prefill; ++i) sched.submit("A", noop);
+    };
+    refill();
+
+    for (auto _ : state) {
+        switch (strategy) {
+        case OverflowStrategy::REJECT:
+            try {
+                sched.submit("A", noop);
+            } catch (const QueueFullException&) {
+            }
+            break;
+        case OverflowStrategy::BLOCK:
+            sched.submit("A", noop);
+            state.PauseTiming();
+            refill();
+            state.ResumeTiming();
+            break;
+        default:
+            sched.submit("A", noop);
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(strategy == OverflowStrategy::REJECT        ? "REJECT"
+                   : strategy == OverflowStrategy::BLOCK       ? "BLOCK"
+                   : strategy == OverflowStrategy::DROP_OLDEST ? "DROP_OLDEST"
+                   : strategy == OverflowStrategy::DROP_NEWEST ? "DROP_NEWEST"
+                                                               : "CALLER_RUNS");
+}
+BENCHMARK(BM_SubmitOverflow)->ArgName("strategy")->DenseRange(0, 4);
+
+// ---------------------------------------------------------------------------
+// select_next_job
+// ---------------------------------------------------------------------------
+
+// Every client is backlogged; measures one policy step plus the dequeue.
+// Args: {policy, client count}
+static void BM_SelectNextJob(benchmark::State& state) {
+    constexpr int JOBS_PER_CLIENT = 256;
+    Scheduler sched(make_policy(state.range(0)));
+    auto ids = register_clients(sched, state.range(1));
+
+    auto refill = [&] {
+        for (int i = 0; i < JOBS_PER_CLIENT; ++i)
+            for (const auto& id : ids) sched.submit(id, noop);
+    };
+    refill();
+
+    Job job;
+    for (auto _ : state) {
+        if (!sched.select_next_job(job)) {
+            state.PauseTiming();
+            refill();
+            state.ResumeTiming();
+            continue;
+        }
+        benchmark::DoNotOptimize(job.job_id);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(policy_name(state.range(0)));
+}
+BENCHMARK(BM_SelectNextJob)
+    ->ArgNames({"policy", "clients"})
+    ->ArgsProduct({{WRR, DRR}, {1, 16, 256, 1024}});
+
+// Only the last registered client has work, so each call scans the others.
+// Args: {policy, client count}
+static void BM_SelectNextJobSparse(benchmark::State& state) {
+    constexpr int BACKLOG = 4096;
+    Scheduler sched(make_policy(state.range(0)));
+    auto ids = register_clients(sched, state.range(1));
+    const std::string& busy = ids.back();
+
+    auto refill = [&] {
+        for (int i = 0; i < BACKLOG; ++i) sched.submit(busy, noop);
+    };
+    refill();
+
+    Job job;
+    for (auto _ : state) {
+        if (!sched.select_next_job(job)) {
+            state.PauseTiming();
+            refill();
+            state.ResumeTiming();
+            continue;
+        }
+        benchmark::DoNotOptimize(job.job_id);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(policy_name(state.range(0)));
+}
+BENCHMARK(BM_SelectNextJobSparse)
+    ->ArgNames({"policy", "clients"})
+    ->ArgsProduct({{WRR, DRR}, {16, 256, 1024}});
+
+// One ManualExecutor step: select + execute + record_execution on a
+// ManualClock, i.e. the whole per-job scheduling path with no worker threads
+// or wakeups in the measurement. Args: {policy, client count}
+static void BM_ManualStep(benchmark::State& state) {
+    constexpr int JOBS_PER_CLIENT = 256;
+    Scheduler sched(make_policy(state.range(0)), std::make_shared<ManualClock>());
+    auto ids = register_clients(sched, state.range(1));
+    ManualExecutor exec(sched);
+
+    auto refill = [&] {
+        for (int i = 0; i < JOBS_PER_CLIENT; ++i)
+            for (const auto& id : ids) sched.submit(id, noop);
+    };
+    refill();
+
+    for (auto _ : state) {
+        if (exec.step() == 0) {
+            state.PauseTiming();
+            refill();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(policy_name(state.range(0)));
+}
+BENCHMARK(BM_ManualStep)
+    ->ArgNames({"policy", "clients"})
+    ->ArgsProduct({{WRR, DRR}, {1, 16, 256}});
+
+// ---------------------------------------------------------------------------
+// Result harvesting: a batch of jobs submitted, run and collected, with one
+// std::promise per job vs one CompletionQueue harvest per batch.
+// Arg: batch size
+// ---------------------------------------------------------------------------
+
+static void BM_ResultFutures(benchmark::State& state) {
+    const auto batch = static_cast<size_t>(state.range(0));
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("gw");
+    ManualExecutor exec(sched);
+    std::vector<std::future<void>> futures;
+    futures.reserve(batch);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch; ++i) {
+            auto done = std::make_shared<std::promise<void>>();
+            futures.push_back(done->get_future());
+            sched.submit("gw", [done] { done->set_value(); });
+        }
+        exec.run_until_idle();
+        for (auto& f : futures) f.get();
+        futures.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+}
+BENCHMARK(BM_ResultFutures)->ArgName("batch")->RangeMultiplier(8)->Range(1, 512);
+
+static void BM_ResultCompletionQueue(benchmark::State& state) {
+    const auto batch = static_cast<size_t>(state.range(0));
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("gw");
+    ManualExecutor exec(sched);
+    CompletionQueue cq(batch);
+    std::vector<Completion> out(batch);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch; ++i) sched.submit(cq, i, "gw", noop);
+        exec.run_until_idle();
+        benchmark::DoNotOptimize(cq.harvest(out));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+}
+BENCHMARK(BM_ResultCompletionQueue)->ArgName("batch")->RangeMultiplier(8)->Range(1, 512);
+
+// ---------------------------------------------------------------------------
+// Job bodies: a batch of 256 jobs carrying `payload` bytes each, submitted
+// and run, as a closure vs a raw handler with inline payload. Closures
+// capture the payload plus a sink pointer, which Task still stores inline.
+// Arg: payload bytes (multiple of 8, at most Job::RAW_PAYLOAD_BYTES)
+// ---------------------------------------------------------------------------
+
+namespace {
+constexpr size_t BODY_BATCH = 256;
+uint64_t g_body_sink = 0;
+
+template <size_t Words>
+void sum_payload(const std::byte* payload) {
+    const auto words = load_payload<std::array<uint64_t, Words>>(payload);
+    for (uint64_t w : words) g_body_sink += w;
+}
+
+template <size_t Words>
+void run_closure_bodies(benchmark::State& state) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    ManualExecutor exec(sched);
+    uint64_t sink = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < BODY_BATCH; ++i) {
+            std::array<uint64_t, Words> words;
+            words.fill(i);
+            sched.submit("A", [words, &sink] {
+                for (uint64_t w : words) sink += w;
+            });
+        }
+        exec.run_until_idle();
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BODY_BATCH));
+}
+
+template <size_t Words>
+void run_raw_bodies(benchmark::State& state) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    ManualExecutor exec(sched);
+    for (auto _ : state) {
+        for (size_t i = 0; i < BODY_BATCH; ++i) {
+            std::array<uint64_t, Words> words;
+            words.fill(i);
+            sched.submit_raw("A", &sum_payload<Words>, words);
+        }
+        exec.run_until_idle();
+    }
+    benchmark::DoNotOptimize(g_body_sink);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BODY_BATCH));
+}
+} // namespace
+
+static void BM_JobBodyClosure(benchmark::State& state) {
+    switch (state.range(0)) {
+    case 8:  run_closure_bodies<1>(state); break;
+    default: run_closure_bodies<2>(state); break;
+    }
+}
+BENCHMARK(BM_JobBodyClosure)->ArgName("payload")->Arg(8)->Arg(16);
+
+static void BM_JobBodyRaw(benchmark::State& state) {
+    switch (state.range(0)) {
+    case 8:  run_raw_bodies<1>(state); break;
+    default: run_raw_bodies<2>(state); break;
+    }
+}
+BENCHMARK(BM_JobBodyRaw)->ArgName("payload")->Arg(8)->Arg(16);
+
+// ---------------------------------------------------------------------------
+// cancel_job
+// ---------------------------------------------------------------------------
+
+// Unknown id: full scan of every queued job. Args: {queue depth}
+static void BM_CancelJobMiss(benchmark::State& state) {
+    Scheduler sched;
+    sched.register_client("A");
+    for (int64_t i = 0; i < state.range(0); ++i) sched.submit("A", noop);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sched.cancel_job(UINT64_MAX));
+    }
+    state.SetItemsProcessed(state.iterations());
+    sched.drain_client("A");
+}
+BENCHMARK(BM_CancelJobMiss)->ArgName("depth")->RangeMultiplier(8)->Range(1, 32768);
+
+// Hit at the back of the queue (newest job), re-submitted outside the timed
+// region. Args: {queue depth}
+static void BM_CancelJobHit(benchmark::State& state) {
+    Scheduler sched;
+    sched.register_client("A");
+    for (int64_t i = 1; i < state.range(0); ++i) sched.submit("A", noop);
+
+    // Job ids are assigned sequentially from 1
+    uint64_t target = static_cast<uint64_t>(state.range(0));
+    sched.submit("A", noop);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sched.cancel_job(target));
+        state.PauseTiming();
+        sched.submit("A", noop);
+        ++target;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+    sched.drain_client("A");
+}
+BENCHMARK(BM_CancelJobHit)->ArgName("depth")->RangeMultiplier(8)->Range(1, 32768);
+
+// ---------------------------------------------------------------------------
+// record_execution / metrics
+// ---------------------------------------------------------------------------
+
+// Args: {client count}
+static void BM_RecordExecution(benchmark::State& state) {
+    Scheduler sched;
+    auto ids = register_clients(sched, state.range(0));
+    size_t next = 0;
+    uint64_t jid = 0;
+
+    for (auto _ : state) {
+        sched.record_execution(ids[next], ++jid, std::chrono::microseconds(1));
+        if (++next == ids.size()) next = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordExecution)->ArgName("clients")->RangeMultiplier(16)->Range(1, 4096);
+
+// Args: {client count}
+static void BM_GetClientMetrics(benchmark::State& state) {
+    Scheduler sched;
+    auto ids = register_clients(sched, state.range(0));
+    size_t next = 0;
+
+    for (auto _ : state) {
+        auto m = sched.get_client_metrics(ids[next]);
+        benchmark::DoNotOptimize(m);
+        if (++next == ids.size()) next = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetClientMetrics)->ArgName("clients")->RangeMultiplier(16)->Range(1, 4096);
+
+// Jain index is O(clients). Args: {client count}
+static void BM_GetGlobalMetrics(benchmark::State& state) {
+    Scheduler sched;
+    auto ids = register_clients(sched, state.range(0));
+    for (const auto& id : ids)
+        sched.record_execution(id, 0, std::chrono::microseconds(1));
+
+    for (auto _ : state) {
+        auto gm = sched.get_global_metrics();
+        benchmark::DoNotOptimize(gm);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetGlobalMetrics)->ArgName("clients")->RangeMultiplier(16)->Range(1, 4096);
+
+// ---------------------------------------------------------------------------
+// Contended variants (1–64 threads)
+// ---------------------------------------------------------------------------
+//
+// Thread 0 builds the shared scheduler before the timed loop and tears it
+// down afterwards; Google Benchmark synchronizes all threads at both points.
+
+namespace {
+std::unique_ptr<Scheduler> g_sched;
+constexpr int64_t MAX_THREADS = 64;
+} // namespace
+
+// Every thread submits to its own client. Measures registry_mutex_ (shared)
+// and next_job_id_ contention.
+static void BM_SubmitContendedPerClient(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>();
+        register_clients(*g_sched, MAX_THREADS, /*max_depth=*/DRAIN_EVERY,
+                         OverflowStrategy::DROP_OLDEST);
+    }
+    const std::string id = client_name(state.thread_index());
+    for (auto _ : state) {
+        g_sched->submit(id, noop);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) g_sched.reset();
+}
+BENCHMARK(BM_SubmitContendedPerClient)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+// Every thread submits to the same client. Adds ClientState::mutex contention.
+static void BM_SubmitContendedSharedClient(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>();
+        g_sched->register_client("shared", 1, DRAIN_EVERY,
+                                 OverflowStrategy::DROP_OLDEST);
+    }
+    for (auto _ : state) {
+        g_sched->submit("shared", noop);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) g_sched.reset();
+}
+BENCHMARK(BM_SubmitContendedSharedClient)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+// The two variants above through a per-thread SubmitBuffer (default options:
+// flush every 256 jobs). Each thread drains its target client untimed so
+// that flushes keep taking the one-lock splice rather than the overflow path.
+// Thread 0 owns the buffers, like g_sched; they are only touched in the loop.
+namespace {
+std::vector<std::unique_ptr<SubmitBuffer>> g_buffers;
+
+void make_buffers(int threads) {
+    for (int t = 0; t < threads; ++t) g_buffers.push_back(std::make_unique<SubmitBuffer>(*g_sched));
+}
+} // namespace
+
+static void BM_SubmitBufferedPerClient(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>();
+        register_clients(*g_sched, MAX_THREADS);
+        make_buffers(state.threads());
+    }
+    const std::string id = client_name(state.thread_index());
+    int64_t since_drain = 0;
+    for (auto _ : state) {
+        g_buffers[state.thread_index()]->submit(id, noop);
+        if (++since_drain == DRAIN_EVERY) {
+            state.PauseTiming();
+            g_sched->drain_client(id);
+            since_drain = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        g_buffers.clear();
+        g_sched.reset();
+    }
+}
+BENCHMARK(BM_SubmitBufferedPerClient)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_SubmitBufferedSharedClient(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>();
+        g_sched->register_client("shared");
+        make_buffers(state.threads());
+    }
+    int64_t since_drain = 0;
+    for (auto _ : state) {
+        g_buffers[state.thread_index()]->submit("shared", noop);
+        if (++since_drain == DRAIN_EVERY) {
+            state.PauseTiming();
+            g_sched->drain_client("shared");
+            since_drain = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        g_buffers.clear();
+        g_sched.reset();
+    }
+}
+BENCHMARK(BM_SubmitBufferedSharedClient)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+// Worker hot path: select → execute of a no-op, with each thread topping up
+// its own client whenever the scheduler runs dry. Measures rr_mutex_
+// contention.
+// Args: {policy}
+static void BM_SelectContended(benchmark::State& state) {
+    constexpr int REFILL = 64;
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>(make_policy(state.range(0)));
+        register_clients(*g_sched, MAX_THREADS);
+    }
+    const std::string id = client_name(state.thread_index());
+    Job job;
+    for (auto _ : state) {
+        if (!g_sched->select_next_job(job)) {
+            for (int i = 0; i < REFILL; ++i) g_sched->submit(id, noop);
+            continue;
+        }
+        g_sched->execute(job);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(policy_name(state.range(0)));
+    if (state.thread_index() == 0) g_sched.reset();
+}
+BENCHMARK(BM_SelectContended)
+    ->ArgName("policy")
+    ->Arg(WRR)
+    ->Arg(DRR)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+// Metrics readers racing with each other on the registry shared lock.
+static void BM_GetClientMetricsContended(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>();
+        register_clients(*g_sched, MAX_THREADS);
+    }
+    const std::string id = client_name(state.thread_index());
+    for (auto _ : state) {
+        auto m = g_sched->get_client_metrics(id);
+        benchmark::DoNotOptimize(m);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) g_sched.reset();
+}
+BENCHMARK(BM_GetClientMetricsContended)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_RecordExecutionContended(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_sched = std::make_unique<Scheduler>();
+        register_clients(*g_sched, MAX_THREADS);
+    }
+    const std::string id = client_name(state.thread_index());
+    uint64_t jid = 0;
+    for (auto _ : state) {
+        g_sched->record_execution(id, ++jid, std::chrono::microseconds(1));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) g_sched.reset();
+}
+BENCHMARK(BM_RecordExecutionContended)->ThreadRange(1, MAX_THREADS)->UseRealTime();
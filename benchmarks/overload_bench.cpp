@@ -0,0 +1,337 @@
+// overload_bench.cpp — Overflow strategies under sustained overload
+//
+// Drives every client open-loop (Poisson arrivals) at a multiple of the pool's
+// nominal capacity (workers × 1e6 / cost_us jobs/s) and compares the bounded
+// queue's OverflowStrategy choices. For each (strategy, load) point it reports:
+//   * goodput        — jobs completed before their deadline, per second
+//   * accepted latency — intended-send → completion for jobs that ran
+//   * deadline misses — share of dequeued jobs that expired in the queue or
+//                       completed late (rejected/dropped jobs are counted apart)
+//   * memory high-water — peak heap growth and total queue depth, sampled
+//   * producer cost  — QueueFullException/s, time spent inside submit()
+//                      (blocked time for BLOCK, inline runs for CALLER_RUNS),
+//                      dropped jobs and jobs the producers ran inline
+//
+// Latency is measured from the intended send time, so producers stalled by
+// BLOCK show that stall as latency instead of silently lowering the offered
+// rate.
+//
+// Usage:
+//   overload_bench [--strategies reject,block,drop_oldest,drop_newest,caller_runs]
+//                  [--help-while-blocked]
+//                  [--load 1.5,2,3,5] [--workers 2] [--clients 2]
+//                  [--cost-us 50] [--depth 256] [--deadline-us 5000]
+//                  [--duration 2] [--policy wrr] [--repeat 1] [--out r.json]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/latency_histogram.h"
+#include "common/memory_stats.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+struct OverloadConfig {
+    std::string policy{"wrr"};
+    size_t      workers{2};
+    size_t      clients{2};
+    int64_t     cost_us{50};
+    size_t      depth{256};
+    int64_t     deadline_us{5000};
+    double      duration_s{2.0};
+    bool        help_while_blocked{false}; // BLOCK producers run queued jobs
+};
+
+struct Counters {
+    std::atomic<uint64_t> offered{0};
+    std::atomic<uint64_t> accepted{0};   // submit() returned normally
+    std::atomic<uint64_t> rejected{0};   // QueueFullException
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> on_time{0};    // completed within the window and deadline
+    std::atomic<uint64_t> late{0};       // completed after the deadline
+    std::atomic<int64_t>  submit_ns{0};  // total time inside submit()
+    std::atomic<int64_t>  reject_ns{0};  // of which spent in rejected calls
+    bench::LatencyHistogram latency_ns;  // intended → completion
+    bench::LatencyHistogram submit_call_ns;
+};
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = std::min(s.find(',', start), s.size());
+        if (comma > start) out.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+Json run_point(const OverloadConfig& cfg, OverflowStrategy strategy, double load,
+               uint64_t seed) {
+    Scheduler sched(bench::make_policy(cfg.policy));
+    sched.set_help_while_blocked(cfg.help_while_blocked);
+    std::vector<std::string> names;
+    for (size_t c = 0; c < cfg.clients; ++c) {
+        names.push_back("client-" + std::to_string(c));
+        sched.register_client(names.back(), 1, cfg.depth, strategy);
+    }
+
+    const double capacity = static_cast<double>(cfg.workers) * 1e6 /
+                            static_cast<double>(cfg.cost_us);
+    const double rate_per_client = load * capacity / static_cast<double>(cfg.clients);
+    const auto cost = microseconds(cfg.cost_us);
+    const auto deadline_after = microseconds(cfg.deadline_us);
+
+    Counters ctr;
+    bench::trim_heap();
+    const uint64_t heap0 = bench::heap_in_use_bytes();
+
+    ThreadPool pool(sched, cfg.workers);
+    const auto t0 = steady_clock::now() + milliseconds(10);
+    const auto t_end = t0 + duration_cast<nanoseconds>(duration<double>(cfg.duration_s));
+
+    // Memory / queue-depth sampler
+    uint64_t heap_peak = heap0;
+    size_t depth_peak = 0;
+    std::jthread sampler([&](std::stop_token st) {
+        while (!st.stop_requested()) {
+            heap_peak = std::max(heap_peak, bench::heap_in_use_bytes());
+            size_t depth = 0;
+            for (const auto& n : names) depth += sched.get_client_metrics(n).queue_depth;
+            depth_peak = std::max(depth_peak, depth);
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    });
+
+    std::vector<std::jthread> generators;
+    for (size_t c = 0; c < cfg.clients; ++c) {
+        generators.emplace_back([&, c] {
+            std::mt19937_64 rng(seed * 7919 + c);
+            std::exponential_distribution<double> gap(rate_per_client / 1e9);
+            auto intended = t0;
+            while (true) {
+                intended += nanoseconds(static_cast<int64_t>(gap(rng)));
+                if (intended >= t_end) break;
+                if (intended > steady_clock::now()) std::this_thread::sleep_until(intended);
+
+                ctr.offered.fetch_add(1, std::memory_order_relaxed);
+                const auto deadline = intended + deadline_after;
+                const auto s0 = steady_clock::now();
+                bool rejected = false;
+                try {
+                    sched.submit(names[c], [&ctr, intended, deadline, cost, t_end] {
+                        bench::spin_for(cost);
+                        const auto done = steady_clock::now();
+                        ctr.latency_ns.record(static_cast<uint64_t>(
+                            duration_cast<nanoseconds>(done - intended).count()));
+                        ctr.completed.fetch_add(1, std::memory_order_relaxed);
+                        if (done > deadline)
+                            ctr.late.fetch_add(1, std::memory_order_relaxed);
+                        else if (done <= t_end)
+                            ctr.on_time.fetch_add(1, std::memory_order_relaxed);
+                    }, 1, Priority::NORMAL, deadline);
+                    ctr.accepted.fetch_add(1, std::memory_order_relaxed);
+                } catch (const QueueFullException&) {
+                    ctr.rejected.fetch_add(1, std::memory_order_relaxed);
+                    rejected = true;
+                }
+                const int64_t ns = duration_cast<nanoseconds>(steady_clock::now() - s0).count();
+                ctr.submit_ns.fetch_add(ns, std::memory_order_relaxed);
+                if (rejected) ctr.reject_ns.fetch_add(ns, std::memory_order_relaxed);
+                ctr.submit_call_ns.record(static_cast<uint64_t>(ns));
+            }
+        });
+    }
+    generators.clear(); // join
+
+    // Whatever is still queued has either missed its deadline or will be
+    // counted as late; drain it so every point finishes in bounded time
+    pool.shutdown(ShutdownMode::GRACEFUL);
+    sampler.request_stop();
+    sampler.join();
+
+    uint64_t overflow = 0, expired = 0, inline_runs = 0;
+    for (const auto& n : names) {
+        const auto m = sched.get_client_metrics(n);
+        overflow    += m.overflow_count;
+        expired     += m.expired_count;
+        inline_runs += m.helped_jobs;
+    }
+    // DROP_* count evictions in overflow_count; REJECT counts its throws there
+    // too, CALLER_RUNS its inline runs
+    const uint64_t dropped = strategy == OverflowStrategy::DROP_OLDEST ||
+                                     strategy == OverflowStrategy::DROP_NEWEST
+                                 ? overflow
+                                 : 0;
+    const uint64_t reached = ctr.completed.load() + expired;
+    const double secs = cfg.duration_s;
+
+    Json metrics = Json::object();
+    metrics["offered_jobs_per_s"]   = static_cast<double>(ctr.offered.load()) / secs;
+    metrics["goodput_jobs_per_s"]   = static_cast<double>(ctr.on_time.load()) / secs;
+    metrics["accepted"]             = ctr.accepted.load();
+    metrics["completed"]            = ctr.completed.load();
+    metrics["latency_p50_us"]       = static_cast<double>(ctr.latency_ns.percentile(0.50)) / 1e3;
+    metrics["latency_p99_us"]       = static_cast<double>(ctr.latency_ns.percentile(0.99)) / 1e3;
+    metrics["deadline_miss_rate"]   = reached ? static_cast<double>(expired + ctr.late.load()) /
+                                                    static_cast<double>(reached)
+                                              : 0.0;
+    metrics["rejected_per_s"]       = static_cast<double>(ctr.rejected.load()) / secs;
+    metrics["dropped"]              = dropped;
+    metrics["ran_inline"]           = inline_runs;
+    metrics["expired"]              = expired;
+    metrics["submit_p99_us"]        = static_cast<double>(ctr.submit_call_ns.percentile(0.99)) / 1e3;
+    metrics["producer_busy_frac"]   = static_cast<double>(ctr.submit_ns.load()) /
+                                      (secs * 1e9 * static_cast<double>(cfg.clients));
+    metrics["reject_ns_per_call"]   = ctr.rejected.load()
+                                          ? static_cast<double>(ctr.reject_ns.load()) /
+                                                static_cast<double>(ctr.rejected.load())
+                                          : 0.0;
+    metrics["heap_peak_bytes"]      = static_cast<double>(heap_peak - std::min(heap_peak, heap0));
+    metrics["queue_depth_peak"]     = depth_peak;
+    return metrics;
+}
+
+Json metric_directions() {
+    Json d = Json::object();
+    d["offered_jobs_per_s"] = "info";
+    d["goodput_jobs_per_s"] = "higher";
+    d["accepted"]           = "info";
+    d["completed"]          = "info";
+    d["dropped"]            = "info";
+    d["ran_inline"]         = "info";
+    d["rejected_per_s"]     = "info";
+    d["queue_depth_peak"]   = "info";
+    for (const char* k : {"latency_p50_us", "latency_p99_us", "deadline_miss_rate",
+                          "expired", "submit_p99_us", "producer_busy_frac",
+                          "reject_ns_per_call", "heap_peak_bytes"})
+        d[k] = "lower";
+    return d;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    OverloadConfig cfg;
+    cfg.policy      = args.get("policy", cfg.policy);
+    cfg.workers     = static_cast<size_t>(args.get_int("workers", 2));
+    cfg.clients     = static_cast<size_t>(args.get_int("clients", 2));
+    cfg.cost_us     = args.get_int("cost-us", cfg.cost_us);
+    cfg.depth       = static_cast<size_t>(args.get_int("depth", 256));
+    cfg.deadline_us = args.get_int("deadline-us", cfg.deadline_us);
+    cfg.duration_s  = args.get_double("duration", cfg.duration_s);
+    cfg.help_while_blocked = args.has("help-while-blocked");
+    const int repeat = static_cast<int>(args.get_int("repeat", 1));
+
+    std::vector<OverflowStrategy> strategies;
+    std::vector<double> loads;
+    try {
+        for (const auto& s : split_list(args.get("strategies",
+                                                 "reject,block,drop_oldest,drop_newest,"
+                                                 "caller_runs")))
+            strategies.push_back(bench::parse_overflow(s));
+        for (const auto& l : split_list(args.get("load", "1.5,2,3,5")))
+            loads.push_back(std::stod(l));
+    } catch (const std::exception& e) {
+        std::cerr << "overload_bench: " << e.what() << "\n";
+        return 2;
+    }
+
+    const double capacity = static_cast<double>(cfg.workers) * 1e6 /
+                            static_cast<double>(cfg.cost_us);
+    std::cout << "\n=== Overload: Overflow Strategies (" << cfg.clients << " clients, "
+              << cfg.workers << " workers, " << cfg.cost_us << "µs jobs, capacity "
+              << std::fixed << std::setprecision(0) << capacity << " jobs/s, depth "
+              << cfg.depth << ", deadline " << cfg.deadline_us << "µs) ===\n\n";
+    std::cout << std::left << std::setw(13) << "Strategy" << std::right
+              << std::setw(6) << "Load"
+              << std::setw(11) << "Goodput/s"
+              << std::setw(11) << "Lat p50"
+              << std::setw(11) << "Lat p99"
+              << std::setw(8) << "Miss%"
+              << std::setw(11) << "Reject/s"
+              << std::setw(9) << "Dropped"
+              << std::setw(11) << "Heap KiB"
+              << std::setw(8) << "Depth"
+              << std::setw(11) << "Submit p99"
+              << std::setw(8) << "Busy%" << "   (µs)\n";
+    std::cout << std::string(119, '-') << "\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "overload_bench";
+    result["config"]["policy"]      = cfg.policy;
+    result["config"]["workers"]     = cfg.workers;
+    result["config"]["clients"]     = cfg.clients;
+    result["config"]["cost_us"]     = cfg.cost_us;
+    result["config"]["depth"]       = cfg.depth;
+    result["config"]["deadline_us"] = cfg.deadline_us;
+    result["config"]["duration_s"]  = cfg.duration_s;
+    result["config"]["help_while_blocked"] = cfg.help_while_blocked;
+    result["directions"] = Json::object();
+    result["runs"] = Json::array();
+
+    const Json directions = metric_directions();
+    for (int r = 0; r < repeat; ++r) {
+        Json run = Json::object();
+        run["metrics"] = Json::object();
+        for (OverflowStrategy s : strategies) {
+            for (double load : loads) {
+                const Json m = run_point(cfg, s, load, static_cast<uint64_t>(r + 1));
+                std::cout << std::left << std::setw(13) << bench::overflow_name(s) << std::right
+                          << std::setprecision(1) << std::setw(5) << load << "x"
+                          << std::setprecision(0)
+                          << std::setw(11) << m.at("goodput_jobs_per_s").as_number()
+                          << std::setw(11) << m.at("latency_p50_us").as_number()
+                          << std::setw(11) << m.at("latency_p99_us").as_number()
+                          << std::setprecision(1)
+                          << std::setw(8) << 100.0 * m.at("deadline_miss_rate").as_number()
+                          << std::setprecision(0)
+                          << std::setw(11) << m.at("rejected_per_s").as_number()
+                          << std::setw(9) << m.at("dropped").as_number()
+                          << std::setw(11) << m.at("heap_peak_bytes").as_number() / 1024.0
+                          << std::setw(8) << m.at("queue_depth_peak").as_number()
+                          << std::setprecision(1)
+                          << std::setw(11) << m.at("submit_p99_us").as_number()
+                          << std::setw(8) << 100.0 * m.at("producer_busy_frac").as_number()
+                          << "\n";
+
+                // Flattened as <strategy>_x<load>_<metric> for bench_compare
+                std::string load_tag = std::to_string(load);
+                load_tag.erase(load_tag.find_last_not_of('0') + 1);
+                if (load_tag.back() == '.') load_tag.pop_back();
+                const std::string prefix = bench::lower(bench::overflow_name(s)) + "_x" +
+                                           load_tag + "_";
+                for (const auto& [k, v] : m.as_object()) {
+                    run["metrics"][prefix + k] = v;
+                    result["directions"][prefix + k] = directions.at(k);
+                }
+            }
+        }
+        result["runs"].push_back(std::move(run));
+        if (r + 1 < repeat) std::cout << "\n";
+    }
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
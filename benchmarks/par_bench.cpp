@@ -0,0 +1,282 @@
+// par_bench.cpp — job_system::par algorithms vs serial STL and std::execution::par
+//
+// Each algorithm runs on:
+//   serial   — the plain STL algorithm on the calling thread
+//   par      — job_system::par on a Scheduler + ThreadPool, one client,
+//              bulk_chunks = workers + 1 (the calling thread helps)
+//   std_par  — the STL algorithm with std::execution::par, which is not tied
+//              to any client (only built when the toolchain's parallel STL
+//              backend, TBB for libstdc++, is available)
+// and reports wall time and speedup over serial. Results are checked against
+// the serial output.
+//
+// Usage:
+//   par_bench [--algos sort,transform,reduce,scan,for_each] [--workers 1,2,4]
+//             [--n 4000000] [--repeat 3] [--out r.json]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+#include <execution>
+#endif
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "job_system/execution.h"
+#include "job_system/parallel.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+// Per-element work for transform / for_each: a few flops, enough that the
+// loop is not purely memory bound
+double kernel(double x) { return std::sqrt(x * x + 1.0) * 0.5 + x; }
+
+enum class Mode { SERIAL, PAR, STD_PAR };
+
+// Runs one algorithm in the given mode and returns a checksum of its output.
+// Only the algorithm itself is timed.
+struct AlgoResult {
+    double checksum{0.0};
+    double ms{0.0};
+};
+
+using AlgoFn = AlgoResult (*)(Mode, const ClientScheduler*, const std::vector<double>&);
+
+template <typename F>
+double timed(F&& f) {
+    const auto t0 = steady_clock::now();
+    f();
+    return duration<double, std::milli>(steady_clock::now() - t0).count();
+}
+
+double sample_sum(const std::vector<double>& v) {
+    double s = 0.0;
+    for (size_t i = 0; i < v.size(); i += v.size() / 1024 + 1) s += v[i] * static_cast<double>(i % 7 + 1);
+    return s;
+}
+
+AlgoResult run_sort(Mode mode, const ClientScheduler* cs, const std::vector<double>& in) {
+    std::vector<double> v = in;
+    const double ms = timed([&] {
+        switch (mode) {
+        case Mode::SERIAL: std::sort(v.begin(), v.end()); break;
+        case Mode::PAR:    par::sort(*cs, v.begin(), v.end()); break;
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+        case Mode::STD_PAR: std::sort(std::execution::par, v.begin(), v.end()); break;
+#endif
+        default: break;
+        }
+    });
+    return {sample_sum(v) + (std::is_sorted(v.begin(), v.end()) ? 1.0 : 0.0), ms};
+}
+
+AlgoResult run_transform(Mode mode, const ClientScheduler* cs, const std::vector<double>& in) {
+    std::vector<double> out(in.size());
+    const double ms = timed([&] {
+        switch (mode) {
+        case Mode::SERIAL: std::transform(in.begin(), in.end(), out.begin(), kernel); break;
+        case Mode::PAR:    par::transform(*cs, in.begin(), in.end(), out.begin(), kernel); break;
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+        case Mode::STD_PAR:
+            std::transform(std::execution::par, in.begin(), in.end(), out.begin(), kernel);
+            break;
+#endif
+        default: break;
+        }
+    });
+    return {sample_sum(out), ms};
+}
+
+// Integer-valued input, so every grouping of the sum is exact
+AlgoResult run_reduce(Mode mode, const ClientScheduler* cs, const std::vector<double>& in) {
+    double sum = 0.0;
+    const double ms = timed([&] {
+        switch (mode) {
+        case Mode::SERIAL: sum = std::reduce(in.begin(), in.end(), 0.0); break;
+        case Mode::PAR:    sum = par::reduce(*cs, in.begin(), in.end(), 0.0); break;
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+        case Mode::STD_PAR: sum = std::reduce(std::execution::par, in.begin(), in.end(), 0.0); break;
+#endif
+        default: break;
+        }
+    });
+    return {sum, ms};
+}
+
+AlgoResult run_scan(Mode mode, const ClientScheduler* cs, const std::vector<double>& in) {
+    std::vector<double> out(in.size());
+    const double ms = timed([&] {
+        switch (mode) {
+        case Mode::SERIAL: std::inclusive_scan(in.begin(), in.end(), out.begin()); break;
+        case Mode::PAR:    par::inclusive_scan(*cs, in.begin(), in.end(), out.begin()); break;
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+        case Mode::STD_PAR:
+            std::inclusive_scan(std::execution::par, in.begin(), in.end(), out.begin());
+            break;
+#endif
+        default: break;
+        }
+    });
+    return {sample_sum(out), ms};
+}
+
+AlgoResult run_for_each(Mode mode, const ClientScheduler* cs, const std::vector<double>& in) {
+    std::vector<double> v = in;
+    auto f = [](double& x) { x = kernel(x); };
+    const double ms = timed([&] {
+        switch (mode) {
+        case Mode::SERIAL: std::for_each(v.begin(), v.end(), f); break;
+        case Mode::PAR:    par::for_each(*cs, v.begin(), v.end(), f); break;
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+        case Mode::STD_PAR: std::for_each(std::execution::par, v.begin(), v.end(), f); break;
+#endif
+        default: break;
+        }
+    });
+    return {sample_sum(v), ms};
+}
+
+AlgoFn algo_by_name(const std::string& name) {
+    if (name == "sort")      return run_sort;
+    if (name == "transform") return run_transform;
+    if (name == "reduce")    return run_reduce;
+    if (name == "scan")      return run_scan;
+    if (name == "for_each")  return run_for_each;
+    throw std::invalid_argument("Unknown algorithm: " + name);
+}
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = std::min(s.find(',', start), s.size());
+        if (comma > start) out.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+void print_row(const std::string& algo, const std::string& mode, int64_t workers, double ms,
+               double serial_ms) {
+    std::cout << std::left << std::setw(11) << algo << std::setw(9) << mode << std::right
+              << std::setw(8) << workers << std::fixed << std::setprecision(2) << std::setw(11)
+              << ms << std::setw(10) << serial_ms / ms << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    const size_t n = static_cast<size_t>(args.get_int("n", 4'000'000));
+    const auto workers = args.get_int_list("workers", {1, 2, 4});
+    const int repeat = static_cast<int>(args.get_int("repeat", 3));
+    const auto algos = split_list(args.get("algos", "sort,transform,reduce,scan,for_each"));
+
+    std::vector<double> input(n);
+    std::mt19937_64 rng(11);
+    for (auto& x : input) x = static_cast<double>(rng() % 1'000'000);
+
+    std::cout << "\n=== Parallel Algorithms, n=" << n << " (best of " << repeat << ") ===\n\n";
+    std::cout << std::left << std::setw(11) << "Algorithm" << std::setw(9) << "Mode" << std::right
+              << std::setw(8) << "Workers" << std::setw(11) << "Wall ms" << std::setw(10)
+              << "Speedup" << "\n";
+    std::cout << std::string(49, '-') << "\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "par_bench";
+    result["config"]["n"] = n;
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+    result["config"]["std_par"] = true;
+#else
+    result["config"]["std_par"] = false;
+#endif
+    result["directions"] = Json::object();
+    result["runs"] = Json::array();
+    for (int r = 0; r < repeat; ++r) {
+        Json run = Json::object();
+        run["metrics"] = Json::object();
+        result["runs"].push_back(std::move(run));
+    }
+    auto record = [&](int r, const std::string& name, double ms) {
+        result["runs"].as_array()[static_cast<size_t>(r)]["metrics"][name + "_ms"] = ms;
+        result["directions"][name + "_ms"] = "lower";
+    };
+
+    int failures = 0;
+    for (const auto& aname : algos) {
+        AlgoFn algo;
+        try {
+            algo = algo_by_name(aname);
+        } catch (const std::exception& e) {
+            std::cerr << "par_bench: " << e.what() << "\n";
+            return 2;
+        }
+        auto check = [&](const char* mode, double got, double expect) {
+            if (got != expect) {
+                std::cerr << "par_bench: " << aname << " (" << mode << ") checksum " << got
+                          << ", expected " << expect << "\n";
+                ++failures;
+            }
+        };
+
+        double serial_ms = 1e300, expect = 0.0;
+        for (int r = 0; r < repeat; ++r) {
+            const AlgoResult res = algo(Mode::SERIAL, nullptr, input);
+            expect = res.checksum;
+            serial_ms = std::min(serial_ms, res.ms);
+            record(r, aname + "_serial", res.ms);
+        }
+        print_row(aname, "serial", 1, serial_ms, serial_ms);
+
+        for (int64_t w : workers) {
+            Scheduler sched;
+            sched.register_client("par");
+            ThreadPool pool(sched, static_cast<size_t>(w));
+            const auto cs = sched.get_scheduler("par").with_bulk_chunks(static_cast<size_t>(w) + 1);
+            double best_ms = 1e300;
+            for (int r = 0; r < repeat; ++r) {
+                const AlgoResult res = algo(Mode::PAR, &cs, input);
+                check("par", res.checksum, expect);
+                best_ms = std::min(best_ms, res.ms);
+                record(r, aname + "_par_w" + std::to_string(w), res.ms);
+            }
+            pool.shutdown();
+            print_row(aname, "par", w, best_ms, serial_ms);
+        }
+
+#ifdef JOB_SYSTEM_HAVE_STD_PAR
+        double best_ms = 1e300;
+        for (int r = 0; r < repeat; ++r) {
+            const AlgoResult res = algo(Mode::STD_PAR, nullptr, input);
+            check("std_par", res.checksum, expect);
+            best_ms = std::min(best_ms, res.ms);
+            record(r, aname + "_std_par", res.ms);
+        }
+        print_row(aname, "std_par", 0, best_ms, serial_ms);
+#endif
+    }
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,376 @@
+// replay.cpp — Deterministic replay of a recorded arrival trace
+//
+// Re-drives the arrivals captured by TraceRecorder (Scheduler::set_trace_recorder,
+// or `loadgen --trace`) against any policy and worker count. Each job is a
+// spin-job of the execution time recorded for it; jobs that never ran in the
+// original capture (rejected, dropped, expired, cancelled) use their client's
+// mean recorded duration. Client weights and backpressure settings come from
+// the trace.
+//
+// Arrivals keep their recorded offsets (scaled by --speed) and are submitted
+// open-loop from --generators threads, sharded by client, so latency is
+// measured against the intended send time exactly as in loadgen.
+//
+// --manual swaps the threads for a discrete-event simulation: a ManualClock
+// drives the Scheduler, ManualExecutor selects jobs, and each job occupies
+// one of --workers virtual workers for its recorded duration instead of
+// spinning. The result depends only on the trace and the policy, so two
+// policies (or two builds) can be compared from a single run, without timer
+// or OS noise. Simulated wall_s is the makespan; measured execution times in
+// the Scheduler's metrics are zero since no virtual time passes inside a job.
+//
+// Usage:
+//   replay trace.bin [--policy wrr|drr] [--drr-quantum 100] [--workers 4]
+//                    [--speed 1.0] [--generators 4] [--repeat 1] [--manual]
+//                    [--out r.json]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/latency_histogram.h"
+#include "job_system/clock.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/trace_recorder.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+struct Arrival {
+    int64_t  offset_ns;
+    uint32_t client;
+    uint32_t cost_hint;
+    Priority priority;
+    bool     has_deadline;
+    int64_t  deadline_us;
+    int64_t  duration_ns;
+};
+
+struct ClientStats {
+    std::atomic<uint64_t> offered{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> completed{0};
+    bench::LatencyHistogram start_latency_ns;
+    bench::LatencyHistogram end_latency_ns;
+};
+
+struct ReplayConfig {
+    std::string policy{"wrr"};
+    uint32_t    drr_quantum{100};
+    size_t      workers{4};
+    double      speed{1.0};
+    size_t      generators{4};
+    bool        manual{false};
+};
+
+// Resolves every arrival's duration from the execution records
+std::vector<Arrival> build_arrivals(const TraceReader& trace) {
+    std::unordered_map<uint64_t, uint64_t> duration_us;
+    std::vector<uint64_t> sum(trace.clients().size(), 0), count(trace.clients().size(), 0);
+    for (const auto& ev : trace.events()) {
+        if (ev.type != TraceEvent::Type::EXECUTION) continue;
+        duration_us[ev.job_id] = ev.duration_us;
+        sum[ev.client] += ev.duration_us;
+        ++count[ev.client];
+    }
+
+    std::vector<Arrival> out;
+    for (const auto& ev : trace.events()) {
+        if (ev.type != TraceEvent::Type::ARRIVAL) continue;
+        auto it = duration_us.find(ev.job_id);
+        const uint64_t us = it != duration_us.end() ? it->second
+                            : count[ev.client]      ? sum[ev.client] / count[ev.client]
+                                                    : 0;
+        out.push_back({static_cast<int64_t>(ev.timestamp_ns), ev.client, ev.cost_hint,
+                       ev.priority, ev.has_deadline, ev.deadline_us,
+                       static_cast<int64_t>(us) * 1000});
+    }
+    if (!out.empty()) {
+        const int64_t first = out.front().offset_ns;
+        for (auto& a : out) a.offset_ns -= first;
+    }
+    return out;
+}
+
+Json summarize(const std::vector<TraceClient>& clients, const Scheduler& sched,
+               const std::vector<std::unique_ptr<ClientStats>>& stats, double wall_s) {
+    Json run = Json::object();
+    Json per_client = Json::object();
+    bench::LatencyHistogram all_start, all_end;
+    uint64_t completed = 0, rejected = 0, overflow = 0, expired = 0;
+    std::vector<double> normalized;
+    for (size_t ci = 0; ci < clients.size(); ++ci) {
+        const auto& st = *stats[ci];
+        const auto m = sched.get_client_metrics(clients[ci].name);
+        Json cj = Json::object();
+        cj["offered"]   = st.offered.load();
+        cj["completed"] = st.completed.load();
+        cj["rejected"]  = st.rejected.load();
+        cj["overflow"]  = m.overflow_count;
+        cj["expired"]   = m.expired_count;
+        cj["start_latency_us"] = st.start_latency_ns.summary(1e-3);
+        cj["end_latency_us"]   = st.end_latency_ns.summary(1e-3);
+        per_client[clients[ci].name] = std::move(cj);
+
+        all_start.merge(st.start_latency_ns);
+        all_end.merge(st.end_latency_ns);
+        completed += st.completed.load();
+        rejected  += st.rejected.load();
+        overflow  += m.overflow_count;
+        expired   += m.expired_count;
+        normalized.push_back(static_cast<double>(st.completed.load()) /
+                             static_cast<double>(clients[ci].weight));
+    }
+
+    Json metrics = Json::object();
+    metrics["wall_s"]                = wall_s;
+    metrics["throughput_jobs_per_s"] = static_cast<double>(completed) / wall_s;
+    metrics["start_latency_p50_us"]  = static_cast<double>(all_start.percentile(0.50)) / 1e3;
+    metrics["start_latency_p99_us"]  = static_cast<double>(all_start.percentile(0.99)) / 1e3;
+    metrics["end_latency_p50_us"]    = static_cast<double>(all_end.percentile(0.50)) / 1e3;
+    metrics["end_latency_p99_us"]    = static_cast<double>(all_end.percentile(0.99)) / 1e3;
+    metrics["rejected"]              = rejected;
+    metrics["overflow"]              = overflow;
+    metrics["expired"]               = expired;
+    metrics["jain_fairness_index"]   = sched.get_global_metrics().jain_fairness_index;
+    metrics["weighted_jain_index"]   = bench::jain_index(normalized);
+    run["metrics"] = std::move(metrics);
+    run["clients"] = std::move(per_client);
+    return run;
+}
+
+Json run_once(const TraceReader& trace, const std::vector<Arrival>& arrivals,
+              const ReplayConfig& cfg) {
+    const auto& clients = trace.clients();
+    Scheduler sched(bench::make_policy(cfg.policy, cfg.drr_quantum));
+    for (const auto& c : clients)
+        sched.register_client(c.name, c.weight, c.max_queue_depth, c.overflow_strategy);
+
+    std::vector<std::unique_ptr<ClientStats>> stats;
+    for (size_t i = 0; i < clients.size(); ++i) stats.push_back(std::make_unique<ClientStats>());
+
+    ThreadPool pool(sched, cfg.workers);
+    const size_t gens = std::max<size_t>(1, std::min(cfg.generators, clients.size()));
+    const auto t0 = steady_clock::now() + milliseconds(20);
+
+    std::vector<std::jthread> generators;
+    for (size_t g = 0; g < gens; ++g) {
+        generators.emplace_back([&, g] {
+            for (const auto& a : arrivals) {
+                if (a.client % gens != g) continue;
+                const auto intended = t0 + nanoseconds(static_cast<int64_t>(
+                                               static_cast<double>(a.offset_ns) / cfg.speed));
+                if (intended > steady_clock::now()) std::this_thread::sleep_until(intended);
+
+                ClientStats* st = stats[a.client].get();
+                st->offered.fetch_add(1, std::memory_order_relaxed);
+                const auto deadline = a.has_deadline
+                                          ? intended + microseconds(a.deadline_us)
+                                          : steady_clock::time_point{};
+                const int64_t cost_ns = a.duration_ns;
+                try {
+                    sched.submit(clients[a.client].name, [st, intended, cost_ns] {
+                        const auto start = steady_clock::now();
+                        bench::spin_for(nanoseconds(cost_ns));
+                        const auto end = steady_clock::now();
+                        st->start_latency_ns.record(static_cast<uint64_t>(
+                            duration_cast<nanoseconds>(start - intended).count()));
+                        st->end_latency_ns.record(static_cast<uint64_t>(
+                            duration_cast<nanoseconds>(end - intended).count()));
+                        st->completed.fetch_add(1, std::memory_order_relaxed);
+                    }, a.cost_hint, a.priority, deadline);
+                } catch (const QueueFullException&) {
+                    st->rejected.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    generators.clear(); // join
+    pool.shutdown(ShutdownMode::GRACEFUL);
+    const double wall_s = duration<double>(steady_clock::now() - t0).count();
+
+    return summarize(clients, sched, stats, wall_s);
+}
+
+// Discrete-event replay on a ManualClock (see --manual above). Worker w is
+// busy until free_at[w]; the earliest-free worker always acts next, after
+// every arrival up to that instant has been submitted. A BLOCK client with a
+// full queue holds its arrivals back, as its generator thread would, and
+// offers them again whenever a job completes. Jobs a CALLER_RUNS client's
+// producer runs inline take no simulated worker time.
+Json run_simulated(const TraceReader& trace, const std::vector<Arrival>& arrivals,
+                   const ReplayConfig& cfg) {
+    const auto& clients = trace.clients();
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(bench::make_policy(cfg.policy, cfg.drr_quantum), clock);
+    for (const auto& c : clients)
+        sched.register_client(c.name, c.weight, c.max_queue_depth, c.overflow_strategy);
+
+    std::vector<std::unique_ptr<ClientStats>> stats;
+    for (size_t i = 0; i < clients.size(); ++i) stats.push_back(std::make_unique<ClientStats>());
+
+    const auto t0 = clock->now();
+    auto intended_of = [&](const Arrival& a) {
+        return t0 + nanoseconds(static_cast<int64_t>(static_cast<double>(a.offset_ns) / cfg.speed));
+    };
+
+    int64_t ran_cost_ns = 0; // set by the job ManualExecutor just ran
+    auto try_submit = [&](const Arrival& a) {
+        const auto& c = clients[a.client];
+        if (c.overflow_strategy == OverflowStrategy::BLOCK && c.max_queue_depth > 0 &&
+            sched.get_client_metrics(c.name).queue_depth >= c.max_queue_depth) {
+            return false;
+        }
+        ClientStats* st = stats[a.client].get();
+        const auto intended = intended_of(a);
+        const auto deadline = a.has_deadline ? intended + microseconds(a.deadline_us)
+                                             : steady_clock::time_point{};
+        const int64_t cost_ns = a.duration_ns;
+        try {
+            sched.submit(c.name, [st, intended, cost_ns, &clock, &ran_cost_ns] {
+                const auto start = clock->now();
+                st->start_latency_ns.record(static_cast<uint64_t>(
+                    duration_cast<nanoseconds>(start - intended).count()));
+                st->end_latency_ns.record(static_cast<uint64_t>(
+                    duration_cast<nanoseconds>(start - intended).count() + cost_ns));
+                st->completed.fetch_add(1, std::memory_order_relaxed);
+                ran_cost_ns = cost_ns;
+            }, a.cost_hint, a.priority, deadline);
+        } catch (const QueueFullException&) {
+            st->rejected.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    };
+
+    std::vector<std::deque<const Arrival*>> held(clients.size());
+    auto offer = [&](const Arrival& a) {
+        stats[a.client]->offered.fetch_add(1, std::memory_order_relaxed);
+        auto& q = held[a.client];
+        if (!q.empty() || !try_submit(a)) q.push_back(&a);
+    };
+    auto release_held = [&] {
+        bool any = false;
+        for (auto& q : held) {
+            while (!q.empty() && try_submit(*q.front())) {
+                q.pop_front();
+                any = true;
+            }
+        }
+        return any;
+    };
+
+    ManualExecutor exec(sched);
+    std::vector<steady_clock::time_point> free_at(std::max<size_t>(1, cfg.workers), t0);
+    auto makespan = t0;
+    size_t next = 0;
+    while (true) {
+        auto worker = std::min_element(free_at.begin(), free_at.end());
+        clock->advance_to(*worker);
+        for (; next < arrivals.size() && intended_of(arrivals[next]) <= clock->now(); ++next) {
+            clock->advance_to(intended_of(arrivals[next]));
+            offer(arrivals[next]);
+        }
+
+        if (exec.step() == 1) {
+            *worker = clock->now() + nanoseconds(ran_cost_ns);
+            makespan = std::max(makespan, *worker);
+            release_held();
+            continue;
+        }
+        if (next < arrivals.size()) {
+            *worker = intended_of(arrivals[next]); // idle until the next arrival
+            continue;
+        }
+        if (!release_held()) break;
+    }
+
+    const double wall_s = std::max(duration<double>(makespan - t0).count(), 1e-9);
+    return summarize(clients, sched, stats, wall_s);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    if (args.positional().size() != 1) {
+        std::cerr << "usage: replay <trace.bin> [--policy wrr|drr] [--workers N]"
+                     " [--speed X] [--generators N] [--repeat N] [--manual] [--out r.json]\n";
+        return 2;
+    }
+
+    ReplayConfig cfg;
+    cfg.policy      = args.get("policy", cfg.policy);
+    cfg.drr_quantum = static_cast<uint32_t>(args.get_int("drr-quantum", cfg.drr_quantum));
+    cfg.workers     = static_cast<size_t>(args.get_int("workers", 4));
+    cfg.speed       = args.get_double("speed", 1.0);
+    cfg.generators  = static_cast<size_t>(args.get_int("generators", 4));
+    cfg.manual      = args.has("manual");
+    const int repeat = static_cast<int>(args.get_int("repeat", 1));
+
+    std::unique_ptr<TraceReader> trace;
+    try {
+        trace = std::make_unique<TraceReader>(args.positional()[0]);
+    } catch (const std::exception& e) {
+        std::cerr << "replay: " << e.what() << "\n";
+        return 2;
+    }
+    const auto arrivals = build_arrivals(*trace);
+    const double span_s = arrivals.empty()
+                              ? 0.0
+                              : static_cast<double>(arrivals.back().offset_ns) / 1e9;
+
+    std::cout << "\n=== Trace Replay (" << arrivals.size() << " arrivals, "
+              << trace->clients().size() << " clients, " << span_s << "s span, policy="
+              << cfg.policy << ", " << cfg.workers << (cfg.manual ? " simulated" : "")
+              << " workers, speed x" << cfg.speed << ") ===\n\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "replay";
+    result["config"]["trace"]       = args.positional()[0];
+    result["config"]["policy"]      = cfg.policy;
+    result["config"]["drr_quantum"] = cfg.drr_quantum;
+    result["config"]["workers"]     = cfg.workers;
+    result["config"]["speed"]       = cfg.speed;
+    result["config"]["generators"]  = cfg.generators;
+    result["config"]["manual"]      = cfg.manual;
+    result["directions"]["wall_s"]  = "lower";
+    result["runs"] = Json::array();
+
+    for (int r = 0; r < repeat; ++r) {
+        Json run = cfg.manual ? run_simulated(*trace, arrivals, cfg)
+                              : run_once(*trace, arrivals, cfg);
+        const Json& m = run.at("metrics");
+        std::cout << std::fixed << "Run " << (r + 1) << "/" << repeat
+                  << ": throughput " << std::setprecision(0)
+                  << m.at("throughput_jobs_per_s").as_number() << " jobs/s, start p50 "
+                  << std::setprecision(1) << m.at("start_latency_p50_us").as_number()
+                  << " µs, p99 " << m.at("start_latency_p99_us").as_number()
+                  << " µs, end p99 " << m.at("end_latency_p99_us").as_number()
+                  << " µs, expired " << std::setprecision(0) << m.at("expired").as_number()
+                  << ", weighted Jain " << std::setprecision(3)
+                  << m.at("weighted_jain_index").as_number() << "\n";
+        result["runs"].push_back(std::move(run));
+    }
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
@@ -7,8 +7,9 @@
 //
 // Section 2: Execution Time Stats via Observer
 //   LatencyObserver accumulates on_job_executed durations (min/avg/max)
-//   Scheduling latency (enqueue_time → dequeue) is available on the Job struct
-//   but requires worker instrumentation; this benchmark measures execution time.
+//   Scheduling latency (enqueue → dequeue) is available from
+//   Scheduler::enqueue_time(job) but requires worker instrumentation; this
+//   benchmark measures execution time.
 
 #include <atomic>
 #include <chrono>
@@ -181,10 +182,10 @@ int main() {
               << obs->avg_us() << " µs\n";
     std::cout << "  Max exec time : " << obs->max_us.load() << " µs\n\n";
 
-    // Scheduling latency (enqueue→dequeue) is recorded on job.enqueue_time
-    // but requires worker instrumentation to measure. See docs/ARCHITECTURE.md.
+    // Scheduling latency (enqueue→dequeue) is recorded on the job but
+    // requires worker instrumentation to measure. See docs/ARCHITECTURE.md.
     std::cout << "  Note: scheduling latency (enqueue→dequeue) is measurable via\n"
-              << "  job.enqueue_time captured inside the worker loop before execution.\n\n";
+              << "  Scheduler::enqueue_time(job) inside the worker loop before execution.\n\n";
 
     return 0;
 }
@@ -0,0 +1,439 @@
+// soak.cpp — Long-running soak harness with drift detection
+//
+// Runs a realistic mixed load for hours or days and watches for the failures
+// that only show up late: memory creep, throughput decay, tail-latency growth
+// and fairness drift. The load combines:
+//   * stable tenants  — Poisson arrivals at ~1.2× pool capacity in total,
+//                       exponential job costs, mixed priorities, deadlines on
+//                       a share of jobs, bounded DROP_OLDEST queues
+//   * churn           — ephemeral tenants registered, given a burst of work
+//                       and unregistered (with work possibly still queued)
+//   * weight updates  — a stable tenant's weight changes at window boundaries
+//   * cancellations   — recently submitted jobs are cancelled at random
+//
+// Every second a row goes to the CSV: RSS, heap, throughput, p99 latency
+// (submit → completion), weighted Jain index over the stable tenants, queue
+// depth and event counters. Stable tenants are saturated, so completions /
+// weight is the fairness signal; weights only change right after a sample so
+// each window is normalised by the weights it actually ran with.
+//
+// Drift detection: after --warmup, the median of the next --baseline windows
+// is the baseline. From then on the median of the last --window windows must
+// stay within bounds, otherwise the run fails (exit 1). --duration must leave
+// room for at least one comparison (warmup + baseline + window seconds); a
+// run that still ends without one is reported inconclusive (exit 2).
+//   RSS growth    > --max-rss-growth-pct (%) of baseline, and > 16 MiB
+//   throughput    < baseline × (1 − --max-throughput-drop-pct / 100)
+//   p99 latency   > baseline × (1 + --max-p99-rise-pct / 100)
+//   Jain index    < baseline − --max-jain-drop
+//
+// Usage:
+//   soak [--duration 24h] [--warmup 30s] [--csv soak.csv] [--workers 4]
+//        [--clients 8] [--cost-us 20] [--load 1.2] [--churn-ms 250]
+//        [--weight-every 10] [--cancel-per-s 50] [--baseline 30] [--window 30]
+//        [--max-rss-growth-pct 25] [--max-throughput-drop-pct 20]
+//        [--max-p99-rise-pct 100] [--max-jain-drop 0.05] [--fail-fast]
+// Durations accept s/m/h/d suffixes (plain numbers are seconds).
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/latency_histogram.h"
+#include "common/memory_stats.h"
+#include "job_system/metrics_observer.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono;
+
+namespace {
+
+struct SoakConfig {
+    double   duration_s{120.0};
+    double   warmup_s{10.0};
+    std::string csv{"soak.csv"};
+    size_t   workers{4};
+    size_t   clients{8};
+    double   cost_us{20.0};
+    double   load{1.2};
+    int64_t  churn_ms{250};
+    int64_t  weight_every{10}; // windows between weight updates
+    double   cancel_per_s{50.0};
+    size_t   baseline{30};
+    size_t   window{30};
+    double   max_rss_growth_pct{25.0};
+    double   max_throughput_drop_pct{20.0};
+    double   max_p99_rise_pct{100.0};
+    double   max_jain_drop{0.05};
+    bool     fail_fast{false};
+};
+
+// "90" → 90 s, "15m", "6h", "2d"
+double parse_duration(const std::string& s) {
+    if (s.empty()) throw std::invalid_argument("empty duration");
+    double scale = 1.0;
+    std::string num = s;
+    switch (s.back()) {
+    case 's': num.pop_back(); break;
+    case 'm': scale = 60.0; num.pop_back(); break;
+    case 'h': scale = 3600.0; num.pop_back(); break;
+    case 'd': scale = 86400.0; num.pop_back(); break;
+    default: break;
+    }
+    return std::stod(num) * scale;
+}
+
+// Remembers recently submitted job ids so the canceller has live targets
+class RecentJobs : public IMetricsObserver {
+public:
+    void on_job_submitted(const std::string&, uint64_t job_id) override {
+        ring_[next_.fetch_add(1, std::memory_order_relaxed) % ring_.size()].store(
+            job_id, std::memory_order_relaxed);
+    }
+    void on_job_cancelled(const std::string&, uint64_t) override {
+        cancelled_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t pick(std::mt19937_64& rng) const {
+        return ring_[rng() % ring_.size()].load(std::memory_order_relaxed);
+    }
+    uint64_t cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, 1024> ring_{};
+    std::atomic<uint64_t> next_{0};
+    std::atomic<uint64_t> cancelled_{0};
+};
+
+// Two histograms swapped every window so the sampler reads a quiet one
+class WindowedLatency {
+public:
+    void record(uint64_t ns) { h_[active_.load(std::memory_order_acquire)].record(ns); }
+
+    // Returns the p99 of the window that just ended and starts a new one
+    uint64_t rotate_p99() {
+        const unsigned old = active_.load(std::memory_order_relaxed);
+        active_.store(old ^ 1u, std::memory_order_release);
+        std::this_thread::sleep_for(microseconds(200)); // let in-flight records land
+        const uint64_t p99 = h_[old].percentile(0.99);
+        h_[old].reset();
+        return p99;
+    }
+
+private:
+    std::array<bench::LatencyHistogram, 2> h_;
+    std::atomic<unsigned> active_{0};
+};
+
+struct Window {
+    double t_s;
+    double rss_mb;
+    double heap_mb;
+    double throughput;
+    double p99_us;
+    double jain;
+    size_t queue_depth;
+    size_t registered;
+    uint64_t overflow;
+    uint64_t expired;
+    uint64_t cancelled;
+    uint64_t churned;
+};
+
+double median_of(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), v.end());
+    return v[v.size() / 2];
+}
+
+template <typename F>
+double window_median(const std::vector<Window>& w, size_t from, size_t to, F field) {
+    std::vector<double> v;
+    for (size_t i = from; i < to; ++i) v.push_back(field(w[i]));
+    return median_of(std::move(v));
+}
+
+SoakConfig load_config(const bench::Args& args) {
+    SoakConfig c;
+    if (args.has("duration")) c.duration_s = parse_duration(args.get("duration"));
+    if (args.has("warmup"))   c.warmup_s = parse_duration(args.get("warmup"));
+    c.csv          = args.get("csv", c.csv);
+    c.workers      = static_cast<size_t>(args.get_int("workers", static_cast<int64_t>(c.workers)));
+    c.clients      = static_cast<size_t>(args.get_int("clients", static_cast<int64_t>(c.clients)));
+    c.cost_us      = args.get_double("cost-us", c.cost_us);
+    c.load         = args.get_double("load", c.load);
+    c.churn_ms     = args.get_int("churn-ms", c.churn_ms);
+    c.weight_every = args.get_int("weight-every", c.weight_every);
+    c.cancel_per_s = args.get_double("cancel-per-s", c.cancel_per_s);
+    c.baseline     = static_cast<size_t>(args.get_int("baseline", static_cast<int64_t>(c.baseline)));
+    c.window       = static_cast<size_t>(args.get_int("window", static_cast<int64_t>(c.window)));
+    c.max_rss_growth_pct      = args.get_double("max-rss-growth-pct", c.max_rss_growth_pct);
+    c.max_throughput_drop_pct = args.get_double("max-throughput-drop-pct", c.max_throughput_drop_pct);
+    c.max_p99_rise_pct        = args.get_double("max-p99-rise-pct", c.max_p99_rise_pct);
+    c.max_jain_drop           = args.get_double("max-jain-drop", c.max_jain_drop);
+    c.fail_fast    = args.has("fail-fast");
+    if (c.clients < 2) throw std::invalid_argument("--clients must be >= 2");
+    if (c.baseline == 0 || c.window == 0)
+        throw std::invalid_argument("--baseline and --window must be >= 1");
+    // One window per second; drift is first checked at warmup + baseline + window
+    const size_t needed = static_cast<size_t>(c.warmup_s) + c.baseline + c.window;
+    if (static_cast<size_t>(c.duration_s) < needed)
+        throw std::invalid_argument("--duration must be at least " + std::to_string(needed) +
+                                    "s (--warmup + --baseline + --window)");
+    return c;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    SoakConfig cfg;
+    try {
+        cfg = load_config(args);
+    } catch (const std::exception& e) {
+        std::cerr << "soak: " << e.what() << "\n";
+        return 2;
+    }
+    std::ofstream csv(cfg.csv);
+    if (!csv) {
+        std::cerr << "soak: cannot open " << cfg.csv << "\n";
+        return 2;
+    }
+    csv << "t_s,rss_mb,heap_mb,throughput_jobs_per_s,p99_us,jain,queue_depth,"
+           "registered_clients,overflow,expired,cancelled,churned_clients\n";
+
+    Scheduler sched(bench::make_policy("drr"));
+    auto recent = std::make_shared<RecentJobs>();
+    sched.set_observer(recent);
+
+    // Stable tenants: weights 1..4, bounded queues so overload cannot grow
+    // memory without limit — any growth the harness sees is a leak
+    std::vector<std::string> stable;
+    std::vector<size_t> weights;
+    for (size_t i = 0; i < cfg.clients; ++i) {
+        stable.push_back("stable-" + std::to_string(i));
+        weights.push_back(1 + i % 4);
+        sched.register_client(stable.back(), weights.back(), 512,
+                              OverflowStrategy::DROP_OLDEST);
+    }
+
+    ThreadPool pool(sched, cfg.workers);
+    WindowedLatency latency;
+    std::atomic<uint64_t> churned{0};
+    std::atomic<bool> stop{false};
+    const double capacity = static_cast<double>(cfg.workers) * 1e6 / cfg.cost_us;
+
+    auto make_job = [&latency, mean_ns = cfg.cost_us * 1e3](std::mt19937_64& rng) {
+        const auto cost = nanoseconds(static_cast<int64_t>(
+            std::exponential_distribution<double>(1.0 / mean_ns)(rng)));
+        const int64_t submitted = bench::now_ns();
+        return [&latency, cost, submitted] {
+            bench::spin_for(cost);
+            latency.record(static_cast<uint64_t>(bench::now_ns() - submitted));
+        };
+    };
+
+    std::vector<std::jthread> threads;
+
+    // One generator per stable tenant (Poisson)
+    for (size_t i = 0; i < cfg.clients; ++i) {
+        threads.emplace_back([&, i] {
+            std::mt19937_64 rng(1000 + i);
+            const double rate = cfg.load * capacity / static_cast<double>(cfg.clients);
+            std::exponential_distribution<double> gap_ns(rate / 1e9);
+            std::uniform_real_distribution<double> u(0.0, 1.0);
+            auto next = steady_clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                next += nanoseconds(static_cast<int64_t>(gap_ns(rng)));
+                if (next > steady_clock::now()) std::this_thread::sleep_until(next);
+                const double r = u(rng);
+                const Priority prio = r < 0.05 ? Priority::HIGH
+                                    : r < 0.25 ? Priority::LOW
+                                               : Priority::NORMAL;
+                const auto deadline = u(rng) < 0.2 ? steady_clock::now() + milliseconds(50)
+                                                   : steady_clock::time_point{};
+                sched.submit(stable[i], make_job(rng), 1, prio, deadline);
+            }
+        });
+    }
+
+    // Churn: keep a handful of ephemeral tenants cycling through
+    // register → burst → unregister
+    threads.emplace_back([&] {
+        std::mt19937_64 rng(7);
+        std::vector<std::string> live;
+        uint64_t serial = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(milliseconds(cfg.churn_ms));
+            const std::string name = "ephemeral-" + std::to_string(serial++);
+            sched.register_client(name, 1 + rng() % 3, 64, OverflowStrategy::DROP_NEWEST);
+            live.push_back(name);
+            for (int j = 0; j < 32; ++j) sched.submit(name, make_job(rng));
+            if (live.size() > 8) {
+                sched.unregister_client(live.front());
+                live.erase(live.begin());
+                churned.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        for (const auto& n : live) sched.unregister_client(n);
+    });
+
+    // Cancellations of recently submitted jobs (most will already have run)
+    if (cfg.cancel_per_s > 0) {
+        threads.emplace_back([&] {
+            std::mt19937_64 rng(11);
+            const auto gap = duration_cast<nanoseconds>(duration<double>(1.0 / cfg.cancel_per_s));
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(gap);
+                sched.cancel_job(recent->pick(rng));
+            }
+        });
+    }
+
+    std::cout << "\n=== Soak (" << cfg.duration_s << "s, warmup " << cfg.warmup_s << "s, "
+              << cfg.clients << " stable tenants @ " << cfg.load << "x capacity, "
+              << cfg.workers << " workers) → " << cfg.csv << " ===\n\n";
+
+    std::vector<Window> windows;
+    std::vector<uint64_t> last_exec(cfg.clients, 0);
+    uint64_t last_total = sched.total_jobs_processed();
+    std::mt19937_64 wrng(3);
+    size_t warmup_windows = static_cast<size_t>(cfg.warmup_s);
+    bool baseline_ready = false;
+    double base_rss = 0, base_tp = 0, base_p99 = 0, base_jain = 0;
+    std::vector<std::string> violations;
+    size_t checks = 0; // windows compared against the baseline
+
+    const auto t0 = steady_clock::now();
+    auto next_sample = t0 + seconds(1);
+    for (size_t w = 0; duration<double>(next_sample - t0).count() <= cfg.duration_s; ++w) {
+        std::this_thread::sleep_until(next_sample);
+        next_sample += seconds(1);
+
+        Window win{};
+        win.t_s = duration<double>(steady_clock::now() - t0).count();
+        win.p99_us = static_cast<double>(latency.rotate_p99()) / 1e3;
+        const uint64_t total = sched.total_jobs_processed();
+        win.throughput = static_cast<double>(total - last_total);
+        last_total = total;
+
+        std::vector<double> normalized;
+        for (size_t i = 0; i < cfg.clients; ++i) {
+            const auto m = sched.get_client_metrics(stable[i]);
+            normalized.push_back(static_cast<double>(m.executed - last_exec[i]) /
+                                 static_cast<double>(weights[i]));
+            last_exec[i] = m.executed;
+            win.queue_depth += m.queue_depth;
+            win.overflow += m.overflow_count;
+            win.expired += m.expired_count;
+        }
+        win.jain = bench::jain_index(normalized);
+        win.rss_mb = static_cast<double>(bench::rss_bytes()) / (1024.0 * 1024.0);
+        win.heap_mb = static_cast<double>(bench::heap_in_use_bytes()) / (1024.0 * 1024.0);
+        win.registered = sched.get_global_metrics().active_clients;
+        win.cancelled = recent->cancelled();
+        win.churned = churned.load();
+        windows.push_back(win);
+
+        csv << std::fixed << std::setprecision(1) << win.t_s << ',' << std::setprecision(2)
+            << win.rss_mb << ',' << win.heap_mb << ',' << std::setprecision(0)
+            << win.throughput << ',' << std::setprecision(1) << win.p99_us << ','
+            << std::setprecision(4) << win.jain << ',' << win.queue_depth << ','
+            << win.registered << ',' << win.overflow << ',' << win.expired << ','
+            << win.cancelled << ',' << win.churned << '\n';
+        csv.flush();
+
+        // Weight update right after the sample, so the next window runs with
+        // (and is normalised by) the new weights
+        if (cfg.weight_every > 0 && (w + 1) % static_cast<size_t>(cfg.weight_every) == 0) {
+            const size_t i = wrng() % cfg.clients;
+            weights[i] = 1 + wrng() % 4;
+            sched.update_client_weight(stable[i], weights[i]);
+        }
+
+        // ── Drift detection ─────────────────────────────────────────────────
+        const size_t n = windows.size();
+        if (!baseline_ready && n >= warmup_windows + cfg.baseline) {
+            const size_t from = n - cfg.baseline;
+            base_rss  = window_median(windows, from, n, [](const Window& x) { return x.rss_mb; });
+            base_tp   = window_median(windows, from, n, [](const Window& x) { return x.throughput; });
+            base_p99  = window_median(windows, from, n, [](const Window& x) { return x.p99_us; });
+            base_jain = window_median(windows, from, n, [](const Window& x) { return x.jain; });
+            baseline_ready = true;
+            std::cout << std::fixed << std::setprecision(1) << "[" << win.t_s
+                      << "s] baseline: rss " << base_rss << " MiB, throughput "
+                      << std::setprecision(0) << base_tp << "/s, p99 " << std::setprecision(1)
+                      << base_p99 << " µs, jain " << std::setprecision(3) << base_jain << "\n";
+        } else if (baseline_ready && n >= warmup_windows + cfg.baseline + cfg.window) {
+            const size_t from = n - cfg.window;
+            const double rss  = window_median(windows, from, n, [](const Window& x) { return x.rss_mb; });
+            const double tp   = window_median(windows, from, n, [](const Window& x) { return x.throughput; });
+            const double p99  = window_median(windows, from, n, [](const Window& x) { return x.p99_us; });
+            const double jain = window_median(windows, from, n, [](const Window& x) { return x.jain; });
+
+            ++checks;
+            std::vector<std::string> now;
+            auto fmt = [](double v) {
+                std::ostringstream os;
+                os << std::fixed << std::setprecision(2) << v;
+                return os.str();
+            };
+            if (rss - base_rss > std::max(16.0, base_rss * cfg.max_rss_growth_pct / 100.0))
+                now.push_back("rss " + fmt(base_rss) + " → " + fmt(rss) + " MiB");
+            if (tp < base_tp * (1.0 - cfg.max_throughput_drop_pct / 100.0))
+                now.push_back("throughput " + fmt(base_tp) + " → " + fmt(tp) + " jobs/s");
+            if (p99 > base_p99 * (1.0 + cfg.max_p99_rise_pct / 100.0))
+                now.push_back("p99 " + fmt(base_p99) + " → " + fmt(p99) + " µs");
+            if (jain < base_jain - cfg.max_jain_drop)
+                now.push_back("jain " + fmt(base_jain) + " → " + fmt(jain));
+            for (const auto& v : now) {
+                std::cout << "[" << std::fixed << std::setprecision(1) << win.t_s
+                          << "s] DRIFT: " << v << "\n";
+                violations.push_back(v);
+            }
+            if (!now.empty() && cfg.fail_fast) break;
+        }
+
+        if (w % 60 == 59) {
+            std::cout << "[" << std::fixed << std::setprecision(0) << win.t_s << "s] rss "
+                      << std::setprecision(1) << win.rss_mb << " MiB, throughput "
+                      << std::setprecision(0) << win.throughput << "/s, p99 "
+                      << std::setprecision(1) << win.p99_us << " µs, jain "
+                      << std::setprecision(3) << win.jain << "\n";
+        }
+    }
+
+    stop.store(true);
+    threads.clear(); // join
+    pool.shutdown(ShutdownMode::IMMEDIATE);
+
+    if (checks == 0) {
+        std::cout << "\nINCONCLUSIVE: run ended after " << windows.size()
+                  << " windows, before any drift check (need "
+                  << warmup_windows + cfg.baseline + cfg.window << ")\n";
+        return 2;
+    }
+    if (!violations.empty()) {
+        std::cout << "\nFAILED: " << violations.size() << " drift violation(s); see "
+                  << cfg.csv << "\n";
+        return 1;
+    }
+    std::cout << "\nPASSED: no drift beyond bounds over " << windows.size() << " windows ("
+              << checks << " checked)\n";
+    return 0;
+}
@@ -0,0 +1,262 @@
+// tenant_scaling_bench.cpp — Many-tenant scaling (10 → 100k registered clients)
+//
+// Sweeps the number of registered clients and the fraction of them that have
+// work queued, for each policy, and reports:
+//   * heap and RSS bytes per idle registered client
+//   * submit cost (ns/job)
+//   * selection cost (ns per select_next_job call)
+//   * Jain index over the active clients' service counts
+//   * job wait (enqueue → dequeue) percentiles, and the spread of per-client
+//     mean wait across active clients (the tail shows starved tenants)
+//
+// Selection runs single-threaded in steady state: every active client is
+// pre-filled with a small backlog, then each dequeue is followed by one new
+// submit to a random active client, so the backlog (and the idle clients the
+// policy must skip over) stays constant while we measure. The select count is
+// raised to at least twice the standing backlog so every queued job turns over
+// and the Jain / per-client figures cover all active tenants.
+//
+// Usage:
+//   tenant_scaling_bench [--clients 10,100,1000,10000,100000]
+//                        [--active 1,10,100] [--policies wrr,drr]
+//                        [--backlog 4] [--selects 20000] [--out r.json]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/latency_histogram.h"
+#include "common/memory_stats.h"
+#include "job_system/scheduler.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+struct Row {
+    std::string policy;
+    int64_t     clients{0};
+    int64_t     active_pct{0};
+    double      heap_bytes_per_client{0};
+    double      rss_bytes_per_client{0};
+    double      submit_ns{0};
+    double      select_ns{0};
+    double      jain{1.0};
+    double      wait_p50_us{0};
+    double      wait_p99_us{0};
+    double      client_mean_wait_p50_us{0};
+    double      client_mean_wait_p99_us{0};
+    double      client_mean_wait_max_us{0};
+};
+
+double percentile_of(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[static_cast<size_t>(q * static_cast<double>(v.size() - 1))];
+}
+
+Row run_config(const std::string& policy, int64_t n_clients, int64_t active_pct,
+               int64_t backlog, int64_t selects) {
+    Row row;
+    row.policy = policy;
+    row.clients = n_clients;
+    row.active_pct = active_pct;
+
+    // Client names are built up front so their storage is not attributed to
+    // the scheduler
+    std::vector<std::string> names;
+    names.reserve(static_cast<size_t>(n_clients));
+    for (int64_t i = 0; i < n_clients; ++i) names.push_back("tenant-" + std::to_string(i));
+
+    bench::trim_heap();
+    const uint64_t heap0 = bench::heap_in_use_bytes();
+    const uint64_t rss0 = bench::rss_bytes();
+
+    auto sched = std::make_unique<Scheduler>(bench::make_policy(policy));
+    for (const auto& n : names) sched->register_client(n);
+
+    row.heap_bytes_per_client = static_cast<double>(bench::heap_in_use_bytes() - heap0) /
+                                static_cast<double>(n_clients);
+    row.rss_bytes_per_client = static_cast<double>(bench::rss_bytes() - rss0) /
+                               static_cast<double>(n_clients);
+
+    // Active clients are spread evenly across the registration order so the
+    // policy has to skip idle tenants between them
+    const int64_t n_active = std::max<int64_t>(1, n_clients * active_pct / 100);
+    std::vector<size_t> active;
+    for (int64_t i = 0; i < n_active; ++i)
+        active.push_back(static_cast<size_t>(i * n_clients / n_active));
+
+    // ── Submit cost: the initial backlog ────────────────────────────────────
+    auto noop = [] {};
+    const auto s0 = steady_clock::now();
+    for (int64_t b = 0; b < backlog; ++b)
+        for (size_t idx : active) sched->submit(names[idx], noop);
+    const auto s1 = steady_clock::now();
+    row.submit_ns = static_cast<double>(duration_cast<nanoseconds>(s1 - s0).count()) /
+                    static_cast<double>(backlog * n_active);
+
+    // ── Steady-state selection ──────────────────────────────────────────────
+    selects = std::max(selects, 2 * backlog * n_active);
+    // Client handles follow registration order, i.e. index into `names`
+    std::vector<size_t> slot_of(names.size(), 0);
+    for (size_t k = 0; k < active.size(); ++k) slot_of[active[k]] = k;
+
+    std::vector<uint64_t> served(active.size(), 0);
+    std::vector<double> wait_sum_us(active.size(), 0.0);
+    bench::LatencyHistogram wait_ns;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, active.size() - 1);
+    int64_t select_total_ns = 0;
+
+    Job job;
+    for (int64_t i = 0; i < selects; ++i) {
+        const auto t0 = steady_clock::now();
+        const bool found = sched->select_next_job(job);
+        const auto t1 = steady_clock::now();
+        select_total_ns += duration_cast<nanoseconds>(t1 - t0).count();
+        if (!found) break;
+
+        const auto waited =
+            std::max<int64_t>(duration_cast<nanoseconds>(t1 - sched->enqueue_time(job)).count(), 0);
+        wait_ns.record(static_cast<uint64_t>(waited));
+        const size_t k = slot_of[job.client];
+        ++served[k];
+        wait_sum_us[k] += static_cast<double>(waited) / 1e3;
+
+        sched->submit(names[active[pick(rng)]], noop);
+    }
+    row.select_ns = static_cast<double>(select_total_ns) / static_cast<double>(selects);
+
+    std::vector<double> served_d, mean_wait;
+    for (size_t k = 0; k < active.size(); ++k) {
+        served_d.push_back(static_cast<double>(served[k]));
+        if (served[k]) mean_wait.push_back(wait_sum_us[k] / static_cast<double>(served[k]));
+    }
+    row.jain = bench::jain_index(served_d);
+    row.wait_p50_us = static_cast<double>(wait_ns.percentile(0.50)) / 1e3;
+    row.wait_p99_us = static_cast<double>(wait_ns.percentile(0.99)) / 1e3;
+    row.client_mean_wait_p50_us = percentile_of(mean_wait, 0.50);
+    row.client_mean_wait_p99_us = percentile_of(mean_wait, 0.99);
+    row.client_mean_wait_max_us = percentile_of(mean_wait, 1.0);
+
+    sched->drain_all_clients();
+    return row;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    const auto client_counts = args.get_int_list("clients", {10, 100, 1000, 10000, 100000});
+    const auto active_pcts   = args.get_int_list("active", {1, 10, 100});
+    const int64_t backlog    = args.get_int("backlog", 4);
+    const int64_t selects    = args.get_int("selects", 20000);
+    std::vector<std::string> policies = {"wrr", "drr"};
+    if (args.has("policies")) {
+        policies.clear();
+        const std::string p = args.get("policies");
+        size_t start = 0;
+        while (start <= p.size()) {
+            size_t comma = std::min(p.find(',', start), p.size());
+            if (comma > start) policies.push_back(p.substr(start, comma - start));
+            start = comma + 1;
+        }
+    }
+
+    std::cout << "\n=== Many-Tenant Scaling (backlog " << backlog << "/active client, "
+              << selects << " steady-state selects) ===\n\n";
+    std::cout << std::left << std::setw(7) << "Policy" << std::right
+              << std::setw(9) << "Clients"
+              << std::setw(8) << "Active"
+              << std::setw(11) << "Heap B/cl"
+              << std::setw(10) << "RSS B/cl"
+              << std::setw(11) << "Submit ns"
+              << std::setw(11) << "Select ns"
+              << std::setw(8) << "Jain"
+              << std::setw(11) << "Wait p50"
+              << std::setw(11) << "Wait p99"
+              << std::setw(13) << "ClMean p99"
+              << std::setw(13) << "ClMean max" << "  (µs)\n";
+    std::cout << std::string(131, '-') << "\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "tenant_scaling_bench";
+    result["config"]["backlog"] = backlog;
+    result["config"]["selects"] = selects;
+    result["directions"] = Json::object();
+    Json rows = Json::array();
+    Json metrics = Json::object();
+
+    for (const auto& policy : policies) {
+        for (int64_t n : client_counts) {
+            for (int64_t pct : active_pcts) {
+                const Row r = run_config(policy, n, pct, backlog, selects);
+                std::cout << std::left << std::setw(7) << bench::lower(r.policy) << std::right
+                          << std::setw(9) << r.clients
+                          << std::setw(7) << r.active_pct << "%"
+                          << std::fixed << std::setprecision(0)
+                          << std::setw(11) << r.heap_bytes_per_client
+                          << std::setw(10) << r.rss_bytes_per_client
+                          << std::setw(11) << r.submit_ns
+                          << std::setw(11) << r.select_ns
+                          << std::setprecision(3) << std::setw(8) << r.jain
+                          << std::setprecision(1)
+                          << std::setw(11) << r.wait_p50_us
+                          << std::setw(11) << r.wait_p99_us
+                          << std::setw(13) << r.client_mean_wait_p99_us
+                          << std::setw(13) << r.client_mean_wait_max_us << "\n";
+
+                Json j = Json::object();
+                j["policy"] = r.policy;
+                j["clients"] = r.clients;
+                j["active_pct"] = r.active_pct;
+                j["heap_bytes_per_client"] = r.heap_bytes_per_client;
+                j["rss_bytes_per_client"] = r.rss_bytes_per_client;
+                j["submit_ns"] = r.submit_ns;
+                j["select_ns"] = r.select_ns;
+                j["jain_fairness_index"] = r.jain;
+                j["wait_p50_us"] = r.wait_p50_us;
+                j["wait_p99_us"] = r.wait_p99_us;
+                j["client_mean_wait_p50_us"] = r.client_mean_wait_p50_us;
+                j["client_mean_wait_p99_us"] = r.client_mean_wait_p99_us;
+                j["client_mean_wait_max_us"] = r.client_mean_wait_max_us;
+                rows.push_back(std::move(j));
+
+                // Flattened for bench_compare
+                const std::string key = r.policy + "_c" + std::to_string(r.clients) +
+                                        "_a" + std::to_string(r.active_pct) + "_";
+                metrics[key + "heap_bytes_per_client"] = r.heap_bytes_per_client;
+                metrics[key + "submit_ns"] = r.submit_ns;
+                metrics[key + "select_ns"] = r.select_ns;
+                metrics[key + "jain_fairness_index"] = r.jain;
+                metrics[key + "client_mean_wait_p99_us"] = r.client_mean_wait_p99_us;
+                for (const char* m : {"heap_bytes_per_client", "submit_ns", "select_ns",
+                                      "client_mean_wait_p99_us"})
+                    result["directions"][key + m] = "lower";
+                result["directions"][key + "jain_fairness_index"] = "higher";
+            }
+        }
+    }
+
+    result["results"] = std::move(rows);
+    Json run = Json::object();
+    run["metrics"] = std::move(metrics);
+    result["runs"].push_back(std::move(run));
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
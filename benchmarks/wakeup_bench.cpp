@@ -0,0 +1,310 @@
+// wakeup_bench.cpp — Submit → start latency into an idle pool
+//
+// Every other benchmark keeps the pool busy, so the cost of waking a parked
+// worker is invisible. Here a single submitter sleeps for a random gap (long
+// enough for every worker to go idle), submits one job and records how long it
+// takes for a worker to start running it. Sweeps worker count × IdleStrategy ×
+// CPU affinity and also reports the submit() call cost and the CPU the process
+// burned while idle (what spinning and yielding pay for their latency).
+//
+// --cpuset restricts the whole process first, like running under
+// `taskset -c`, so oversubscribed and cross-socket layouts can be reproduced
+// without an external wrapper. With --affinity pinned, the submitter takes the
+// first allowed CPU and workers are spread over the rest.
+//
+// Usage:
+//   wakeup_bench [--workers 1,2,4] [--idle block,spin,yield] [--spin-us 50]
+//                [--affinity none,pinned] [--cpuset 0-3,6]
+//                [--samples 2000] [--gap-us 100,1000] [--out r.json]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+#include "common/bench_util.h"
+#include "common/json.h"
+#include "common/latency_histogram.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono;
+using bench::Json;
+
+namespace {
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = std::min(s.find(',', start), s.size());
+        if (comma > start) out.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+// "0-3,6" → {0, 1, 2, 3, 6}
+std::vector<int> parse_cpu_list(const std::string& s) {
+    std::vector<int> cpus;
+    for (const auto& part : split_list(s)) {
+        const auto dash = part.find('-');
+        const int lo = std::stoi(part.substr(0, dash));
+        const int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+        for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    }
+#endif
+    return cpus;
+}
+
+// Equivalent of `taskset -c` for this process (threads created later inherit it)
+void restrict_process(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) CPU_SET(c, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        throw std::runtime_error("sched_setaffinity failed for --cpuset");
+#else
+    (void)cpus;
+    throw std::runtime_error("--cpuset is only supported on Linux");
+#endif
+}
+
+void pin_self(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+void unpin_self(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) CPU_SET(c, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpus;
+#endif
+}
+
+double cpu_seconds() {
+#if defined(__linux__)
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+           static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+#else
+    return 0.0;
+#endif
+}
+
+IdleStrategy parse_idle(const std::string& name) {
+    const std::string n = bench::lower(name);
+    if (n == "block") return IdleStrategy::BLOCK;
+    if (n == "spin" || n == "spin_then_block") return IdleStrategy::SPIN_THEN_BLOCK;
+    if (n == "yield") return IdleStrategy::YIELD;
+    throw std::invalid_argument("Unknown idle strategy: " + name);
+}
+
+const char* idle_name(IdleStrategy s) {
+    switch (s) {
+    case IdleStrategy::BLOCK:           return "block";
+    case IdleStrategy::SPIN_THEN_BLOCK: return "spin";
+    case IdleStrategy::YIELD:           return "yield";
+    }
+    return "?";
+}
+
+struct PointConfig {
+    size_t       workers{1};
+    IdleStrategy idle{IdleStrategy::BLOCK};
+    bool         pinned{false};
+    int64_t      spin_us{50};
+    int64_t      samples{2000};
+    int64_t      gap_min_us{100};
+    int64_t      gap_max_us{1000};
+};
+
+Json run_point(const PointConfig& pc, const std::vector<int>& cpus) {
+    ThreadPoolOptions opts;
+    opts.idle_strategy = pc.idle;
+    opts.spin_duration = microseconds(pc.spin_us);
+    if (pc.pinned && !cpus.empty()) {
+        pin_self(cpus.front());
+        if (cpus.size() > 1) opts.cpu_affinity.assign(cpus.begin() + 1, cpus.end());
+        else opts.cpu_affinity = cpus;
+    }
+
+    Scheduler sched;
+    sched.register_client("probe");
+    ThreadPool pool(sched, pc.workers, opts);
+    std::this_thread::sleep_for(milliseconds(20)); // let workers reach idle
+
+    bench::LatencyHistogram wake_ns, submit_ns;
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<int64_t> gap(pc.gap_min_us, pc.gap_max_us);
+
+    // Outlives every job, so a worker still inside notify_one() never touches
+    // a dead object
+    std::atomic<int64_t> completed{0};
+    int64_t started_ns = 0;
+
+    const auto wall0 = steady_clock::now();
+    const double cpu0 = cpu_seconds();
+    for (int64_t i = 0; i < pc.samples; ++i) {
+        std::this_thread::sleep_for(microseconds(gap(rng)));
+
+        const int64_t t_submit = bench::now_ns();
+        sched.submit("probe", [&started_ns, &completed] {
+            started_ns = bench::now_ns();
+            completed.fetch_add(1, std::memory_order_release);
+            completed.notify_one();
+        });
+        const int64_t t_returned = bench::now_ns();
+        completed.wait(i, std::memory_order_acquire);
+
+        wake_ns.record(static_cast<uint64_t>(std::max<int64_t>(0, started_ns - t_submit)));
+        submit_ns.record(static_cast<uint64_t>(t_returned - t_submit));
+    }
+    const double wall = duration<double>(steady_clock::now() - wall0).count();
+    const double cpu = cpu_seconds() - cpu0;
+    pool.shutdown();
+    if (pc.pinned) unpin_self(cpus);
+
+    Json m = Json::object();
+    m["wake_p50_us"]   = static_cast<double>(wake_ns.percentile(0.50)) / 1e3;
+    m["wake_p90_us"]   = static_cast<double>(wake_ns.percentile(0.90)) / 1e3;
+    m["wake_p99_us"]   = static_cast<double>(wake_ns.percentile(0.99)) / 1e3;
+    m["wake_p999_us"]  = static_cast<double>(wake_ns.percentile(0.999)) / 1e3;
+    m["wake_max_us"]   = static_cast<double>(wake_ns.max()) / 1e3;
+    m["submit_p50_us"] = static_cast<double>(submit_ns.percentile(0.50)) / 1e3;
+    m["submit_p99_us"] = static_cast<double>(submit_ns.percentile(0.99)) / 1e3;
+    m["cpu_cores_used"] = wall > 0 ? cpu / wall : 0.0;
+    return m;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv);
+    std::vector<int64_t> worker_counts;
+    std::vector<IdleStrategy> idles;
+    std::vector<bool> pinnings;
+    PointConfig base;
+    try {
+        if (args.has("cpuset")) restrict_process(parse_cpu_list(args.get("cpuset")));
+        worker_counts = args.get_int_list("workers", {1, 2, 4});
+        for (const auto& s : split_list(args.get("idle", "block,spin,yield")))
+            idles.push_back(parse_idle(s));
+        for (const auto& s : split_list(args.get("affinity", "none,pinned"))) {
+            if (s != "none" && s != "pinned")
+                throw std::invalid_argument("Unknown affinity mode: " + s);
+            pinnings.push_back(s == "pinned");
+        }
+        base.spin_us = args.get_int("spin-us", base.spin_us);
+        base.samples = args.get_int("samples", base.samples);
+        const auto gaps = args.get_int_list("gap-us", {100, 1000});
+        base.gap_min_us = gaps.front();
+        base.gap_max_us = gaps.back();
+    } catch (const std::exception& e) {
+        std::cerr << "wakeup_bench: " << e.what() << "\n";
+        return 2;
+    }
+
+    const std::vector<int> cpus = allowed_cpus();
+    std::cout << "\n=== Idle-Pool Wakeup Latency (" << base.samples << " samples, gap "
+              << base.gap_min_us << "-" << base.gap_max_us << "µs, " << cpus.size()
+              << " CPUs allowed) ===\n\n";
+    std::cout << std::left << std::setw(9) << "Workers" << std::setw(8) << "Idle"
+              << std::setw(9) << "Affinity" << std::right
+              << std::setw(10) << "p50"
+              << std::setw(10) << "p90"
+              << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9"
+              << std::setw(10) << "max"
+              << std::setw(12) << "submit p50"
+              << std::setw(8) << "CPU" << "   (µs; CPU = cores busy)\n";
+    std::cout << std::string(96, '-') << "\n";
+
+    Json result = Json::object();
+    result["benchmark"] = "wakeup_bench";
+    result["config"]["samples"]    = base.samples;
+    result["config"]["gap_min_us"] = base.gap_min_us;
+    result["config"]["gap_max_us"] = base.gap_max_us;
+    result["config"]["spin_us"]    = base.spin_us;
+    result["config"]["cpus"]       = Json::array();
+    for (int c : cpus) result["config"]["cpus"].push_back(c);
+    result["directions"] = Json::object();
+    Json run = Json::object();
+    run["metrics"] = Json::object();
+
+    for (int64_t w : worker_counts) {
+        for (IdleStrategy idle : idles) {
+            for (bool pinned : pinnings) {
+                PointConfig pc = base;
+                pc.workers = static_cast<size_t>(w);
+                pc.idle = idle;
+                pc.pinned = pinned;
+                const Json m = run_point(pc, cpus);
+                std::cout << std::left << std::setw(9) << w << std::setw(8) << idle_name(idle)
+                          << std::setw(9) << (pinned ? "pinned" : "none") << std::right
+                          << std::fixed << std::setprecision(1)
+                          << std::setw(10) << m.at("wake_p50_us").as_number()
+                          << std::setw(10) << m.at("wake_p90_us").as_number()
+                          << std::setw(10) << m.at("wake_p99_us").as_number()
+                          << std::setw(10) << m.at("wake_p999_us").as_number()
+                          << std::setw(10) << m.at("wake_max_us").as_number()
+                          << std::setw(12) << m.at("submit_p50_us").as_number()
+                          << std::setprecision(2)
+                          << std::setw(8) << m.at("cpu_cores_used").as_number() << "\n";
+
+                const std::string prefix = "w" + std::to_string(w) + "_" + idle_name(idle) +
+                                           (pinned ? "_pinned_" : "_");
+                for (const auto& [k, v] : m.as_object()) {
+                    run["metrics"][prefix + k] = v;
+                    result["directions"][prefix + k] = "lower";
+                }
+            }
+        }
+    }
+    result["runs"] = Json::array();
+    result["runs"].push_back(std::move(run));
+
+    if (args.has("out")) {
+        result.write_file(args.get("out"));
+        std::cout << "\nResults written to " << args.get("out") << "\n";
+    }
+    return 0;
+}
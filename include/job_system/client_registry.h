@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "job_system/client_state.h"
+#include "job_system/job.h"
+
+namespace job_system {
+
+// The registered clients of a Scheduler as dense columns indexed by slot.
+// The fields a policy scan reads (weight, queued depth) sit in arrays of
+// their own, so choosing the next client is a linear walk over a few bytes
+// per client and only the chosen ClientState is touched (to dequeue). Slots
+// of unregistered clients are reused, so the columns are as long as the
+// largest number of clients registered at once; free slots read as weight 0
+// and depth 0. A ClientHandle is the slot plus a generation bumped on every
+// reuse, so a job dequeued before its client was unregistered never
+// resolves to the slot's next client.
+//
+// Names resolve to slots through an open-addressing table (linear probing,
+// backward-shift deletion) holding only hashes and slots — keys are compared
+// against ClientState::client_id — used at API boundaries only.
+//
+// Locking is the Scheduler's: add(), remove() and set_weight() under the
+// registry write lock, everything else under at least its read lock. A depth
+// is written with its client's mutex held as well and read without it, so to
+// a policy it is a hint that dequeue() confirms.
+class ClientRegistry {
+public:
+    static constexpr size_t NO_SLOT = SIZE_MAX;
+    static constexpr size_t SLOT_BITS = 24;
+    // Slot 2^24 - 1 is never used, so no handle equals NO_CLIENT
+    static constexpr size_t MAX_CLIENTS = (size_t{1} << SLOT_BITS) - 1;
+
+    static size_t slot_of(ClientHandle handle) {
+        return handle & ((ClientHandle{1} << SLOT_BITS) - 1);
+    }
+
+    // Registered clients
+    size_t size() const { return live_; }
+    bool empty() const { return live_ == 0; }
+    // Length of the columns: scans cover slots [0, slot_count())
+    size_t slot_count() const { return states_.size(); }
+
+    // Slot of a registered client, or NO_SLOT
+    size_t find(std::string_view client_id) const;
+
+    // Client in `slot`, null if the slot is free
+    const std::shared_ptr<ClientState>& state(size_t slot) const { return states_[slot]; }
+
+    // Client a job's handle refers to, or null once it was unregistered
+    std::shared_ptr<ClientState> at(ClientHandle handle) const;
+
+    // Whether `client` is still registered
+    bool contains(const ClientState& client) const {
+        const size_t slot = slot_of(client.handle);
+        return slot < states_.size() && states_[slot].get() == &client;
+    }
+
+    size_t weight(size_t slot) const { return weights_[slot]; }
+
+    // Jobs queued on the client in `slot`
+    size_t depth(size_t slot) const {
+        return std::atomic_ref(depths_[slot]).load(std::memory_order_relaxed);
+    }
+
+    // Moves the highest-priority job of the client in `slot` into `out`,
+    // under the client's mutex, and wakes its BLOCK submitters. Returns false
+    // if the client had nothing queued.
+    bool dequeue(size_t slot, Job& out) const;
+
+    // Publishes a client's queued job count after its queues changed. Caller
+    // must hold client.mutex.
+    void sync_depth(const ClientState& client) const {
+        std::atomic_ref(depths_[slot_of(client.handle)])
+            .store(client.total_queued(), std::memory_order_relaxed);
+    }
+
+    // Puts `client` in a free slot and sets its handle; returns the slot.
+    // Throws std::runtime_error if MAX_CLIENTS are registered.
+    size_t add(std::shared_ptr<ClientState> client, size_t weight);
+
+    // Frees `slot` for reuse
+    void remove(size_t slot);
+
+    void set_weight(size_t slot, size_t weight) { weights_[slot] = weight; }
+
+private:
+    // Open-addressing index entry; slot_plus_one == 0 marks an empty bucket
+    struct IndexEntry {
+        uint32_t hash{0};
+        uint32_t slot_plus_one{0};
+    };
+
+    static uint32_t hash_of(std::string_view client_id);
+    void index_insert(IndexEntry entry);
+    void index_erase(size_t slot);
+    void index_grow();
+
+    std::vector<std::shared_ptr<ClientState>> states_;
+    std::vector<size_t> weights_;
+    mutable std::vector<size_t> depths_; // accessed through std::atomic_ref
+    std::vector<uint8_t> generations_;
+    std::vector<uint32_t> free_slots_;
+    size_t live_{0};
+
+    std::vector<IndexEntry> index_; // power-of-two size, at most half full
+};
+
+} // namespace job_system
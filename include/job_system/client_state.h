@@ -5,6 +5,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <string>
@@ -17,38 +18,68 @@ enum class OverflowStrategy {
     REJECT,      // throw QueueFullException
     BLOCK,       // caller blocks until space is available
     DROP_OLDEST, // evict front of queue to make room
-    DROP_NEWEST  // silently discard the incoming job
+    DROP_NEWEST, // silently discard the incoming job
+    CALLER_RUNS  // submitting thread runs the client's next queued job inline,
+                 // and the incoming job takes its slot; that job's exception
+                 // is reported to the observer, not thrown from submit()
 };
 
+// Backpressure config and overflow counters of a bounded client
+// (max_queue_depth > 0). Cold: only touched when the queue is full and by
+// metrics reads, so unbounded clients don't carry it.
+struct ClientLimits {
+    size_t max_queue_depth;
+    OverflowStrategy overflow_strategy;
+
+    // BLOCK only: slot of the Scheduler's shared condition variable pool,
+    // and the number of submitters asleep on it (guarded by
+    // ClientState::mutex) — dequeues notify only while it is non-zero
+    std::condition_variable_any* space_cv{nullptr};
+    uint32_t sleepers{0};
+
+    std::atomic<uint64_t> overflow_count{0};
+    std::atomic<uint64_t> blocked_count{0};            // BLOCK waits
+    std::atomic<uint64_t> blocked_in_task_count{0};    // ... by a running task
+    std::atomic<uint64_t> priority_inversion_count{0}; // ... outranking the queue
+    std::atomic<uint64_t> blocked_time_us{0};
+    std::atomic<uint64_t> helped_count{0};             // run inline by a submitter
+
+    ClientLimits(size_t max_depth, OverflowStrategy strategy)
+        : max_queue_depth(max_depth)
+        , overflow_strategy(strategy) {}
+};
+
+// A client that has never submitted costs its id, a mutex, a few counters
+// and null pointers: each priority level's queue is allocated on first
+// submit at that level. A drained queue is kept (an empty deque still holds
+// one block) so a busy client does not reallocate on every idle period; only
+// drain_client() and unregister_client() release it. Its weight and queued job count, which
+// policies scan, live in the ClientRegistry's columns.
 struct ClientState {
     std::string client_id;
-    size_t weight;
+    ClientHandle handle{NO_CLIENT}; // set by ClientRegistry::add
 
     static constexpr size_t NUM_PRIORITY_LEVELS =
         static_cast<size_t>(Priority::NUM_LEVELS);
-    std::array<std::deque<Job>, NUM_PRIORITY_LEVELS> queues;
+    // Null until a job of that priority is first queued. Guarded by mutex.
+    std::array<std::unique_ptr<std::deque<Job>>, NUM_PRIORITY_LEVELS> queues;
 
     mutable std::mutex mutex;
-    std::condition_variable submit_cv_; // for BLOCK strategy
 
     // Atomic metrics — readable without locking
     std::atomic<uint64_t> submitted_count{0};
     std::atomic<uint64_t> executed_count{0};
     std::atomic<int64_t>  total_execution_time_us{0}; // microseconds
-    std::atomic<uint64_t> overflow_count{0};
     std::atomic<uint64_t> expired_count{0};
 
-    // Backpressure config — set at registration time, const thereafter
-    size_t max_queue_depth{0};                         // 0 = unlimited
-    OverflowStrategy overflow_strategy{OverflowStrategy::REJECT};
+    // Set at registration time for bounded clients, const thereafter
+    const std::unique_ptr<ClientLimits> limits;
 
-    explicit ClientState(std::string id, size_t w = 1,
-                         size_t max_depth = 0,
+    explicit ClientState(std::string id, size_t max_depth = 0,
                          OverflowStrategy strategy = OverflowStrategy::REJECT)
         : client_id(std::move(id))
-        , weight(w)
-        , max_queue_depth(max_depth)
-        , overflow_strategy(strategy) {}
+        , limits(max_depth > 0 ? std::make_unique<ClientLimits>(max_depth, strategy)
+                               : nullptr) {}
 
     // Non-copyable, non-movable (contains mutex)
     ClientState(const ClientState&) = delete;
@@ -56,10 +87,15 @@ struct ClientState {
     ClientState(ClientState&&) = delete;
     ClientState& operator=(ClientState&&) = delete;
 
+    size_t max_queue_depth() const { return limits ? limits->max_queue_depth : 0; }
+    OverflowStrategy overflow_strategy() const {
+        return limits ? limits->overflow_strategy : OverflowStrategy::REJECT;
+    }
+
     // Caller must hold mutex
     bool any_queued() const {
         for (const auto& q : queues)
-            if (!q.empty()) return true;
+            if (q && !q->empty()) return true;
         return false;
     }
 
@@ -67,21 +103,36 @@ struct ClientState {
     size_t total_queued() const {
         size_t count = 0;
         for (const auto& q : queues)
-            count += q.size();
+            if (q) count += q->size();
         return count;
     }
 
-    // Dequeues highest-priority pending job. Caller must hold mutex.
-    Job dequeue_highest() {
+    // Appends `job` to its priority level. Caller must hold mutex.
+    void push(Job&& job) {
+        auto& q = queues[static_cast<size_t>(job.priority())];
+        if (!q) q = std::make_unique<std::deque<Job>>();
+        q->push_back(std::move(job));
+    }
+
+    // Moves the highest-priority pending job into `out`. Caller must hold
+    // mutex.
+    void dequeue_highest(Job& out) {
         for (int level = static_cast<int>(NUM_PRIORITY_LEVELS) - 1; level >= 0; --level) {
-            if (!queues[level].empty()) {
-                Job j = std::move(queues[level].front());
-                queues[level].pop_front();
-                return j;
+            auto& q = queues[level];
+            if (q && !q->empty()) {
+                out = std::move(q->front());
+                q->pop_front();
+                return;
             }
         }
         throw std::logic_error("dequeue_highest called on empty client");
     }
+
+    // Wakes BLOCK submitters after queue space was freed. Caller must hold
+    // mutex.
+    void notify_space() const {
+        if (limits && limits->sleepers > 0) limits->space_cv->notify_all();
+    }
 };
 
 } // namespace job_system
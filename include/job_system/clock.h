@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace job_system {
+
+// Time source for enqueue timestamps, deadline checks and execution
+// durations. Scheduler uses SteadyClock unless another clock is injected.
+class IClock {
+public:
+    virtual ~IClock() = default;
+    virtual std::chrono::steady_clock::time_point now() const = 0;
+};
+
+class SteadyClock final : public IClock {
+public:
+    std::chrono::steady_clock::time_point now() const override {
+        return std::chrono::steady_clock::now();
+    }
+};
+
+// Clock that only moves when told to — for deterministic tests and
+// simulation with ManualExecutor. Thread-safe.
+class ManualClock final : public IClock {
+public:
+    // Starts at a non-zero point so that "now" is never mistaken for the
+    // "no deadline" sentinel (a default-constructed time_point)
+    explicit ManualClock(std::chrono::steady_clock::time_point start =
+                             std::chrono::steady_clock::time_point{} + std::chrono::hours(1))
+        : ns_(start.time_since_epoch().count()) {}
+
+    std::chrono::steady_clock::time_point now() const override {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(ns_.load(std::memory_order_acquire)));
+    }
+
+    void advance(std::chrono::steady_clock::duration d) {
+        ns_.fetch_add(d.count(), std::memory_order_acq_rel);
+    }
+
+    // Moves to `t`; the clock never goes backwards
+    void advance_to(std::chrono::steady_clock::time_point t) {
+        const int64_t target = t.time_since_epoch().count();
+        int64_t cur = ns_.load(std::memory_order_relaxed);
+        while (cur < target &&
+               !ns_.compare_exchange_weak(cur, target, std::memory_order_acq_rel)) {}
+    }
+
+private:
+    std::atomic<int64_t> ns_;
+};
+
+} // namespace job_system
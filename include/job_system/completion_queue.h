@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace job_system {
+
+class Scheduler;
+
+enum class CompletionStatus : uint8_t {
+    COMPLETED = 0, // task returned
+    FAILED    = 1, // task threw (the exception is swallowed)
+    EXPIRED   = 2, // deadline passed before it was dequeued
+    CANCELLED = 3, // cancel_job, drain_client or unregister_client
+    DROPPED   = 4  // DROP_OLDEST / DROP_NEWEST overflow
+};
+
+// One finished job (24 bytes)
+struct Completion {
+    uint64_t job_id{0};
+    uint64_t user_tag{0};
+    uint32_t duration_us{0}; // run time, saturated; 0 unless COMPLETED or FAILED
+    CompletionStatus status{CompletionStatus::COMPLETED};
+};
+
+// Bounded ring that jobs post a Completion to when they finish or are
+// discarded, in the style of an io_uring completion queue. Workers post
+// lock-free; the owner harvests many records per call and can sleep on a
+// single futex word (std::atomic::wait) until enough have arrived.
+//
+// Every job submitted with a queue reserves a slot until its completion is
+// harvested, so posting never fails. Submitting when capacity() jobs are
+// already in flight or unharvested throws QueueFullException. The queue must
+// outlive the jobs submitted to it. harvest() and wait() are single-consumer:
+// call them from one thread at a time.
+class CompletionQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit CompletionQueue(size_t capacity);
+    ~CompletionQueue();
+
+    CompletionQueue(const CompletionQueue&) = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+    // Copies up to out.size() ready completions, oldest first; never blocks
+    size_t harvest(std::span<Completion> out);
+
+    // Like harvest(), but first blocks until min_count completions are ready
+    // or fewer than that are still outstanding (so it cannot wait for jobs
+    // that were never submitted)
+    size_t wait(std::span<Completion> out, size_t min_count = 1);
+
+    size_t capacity() const { return mask_ + 1; }
+    // Jobs submitted with this queue whose completion is not yet harvested
+    size_t outstanding() const { return reserved_.load(std::memory_order_acquire); }
+
+private:
+    friend class Scheduler;
+
+    struct Slot {
+        std::atomic<uint64_t> seq; // == index + 1 once posted for that index
+        Completion completion;
+    };
+
+    // Scheduler side
+    bool try_reserve();
+    void release();
+    void post(uint64_t job_id, uint64_t user_tag, CompletionStatus status,
+              std::chrono::microseconds duration);
+
+    bool head_ready() const;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> tail_{0};    // next index to post (producers)
+    alignas(64) uint64_t head_{0};                 // next index to harvest (consumer)
+    alignas(64) std::atomic<uint32_t> posted_{0};  // futex word, bumped per post
+    std::atomic<uint32_t> waiting_{0};             // consumer is (about to be) asleep
+    alignas(64) std::atomic<size_t> reserved_{0};
+};
+
+} // namespace job_system
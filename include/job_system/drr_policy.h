@@ -2,9 +2,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <optional>
-#include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "job_system/scheduling_policy.h"
@@ -16,22 +13,21 @@ public:
     // base_quantum: credits added per round, scaled by client weight
     explicit DeficitRoundRobinPolicy(uint32_t base_quantum = 100);
 
-    void on_client_registered(const std::string& client_id,
-                               size_t weight) override;
+    void on_client_registered(size_t slot, size_t weight) override;
 
-    std::optional<Job> select_next_job(
-        const std::vector<std::string>& client_order,
-        const ClientMap& clients) override;
+    bool select_next_job(const ClientRegistry& clients, Job& out) override;
 
-    void on_client_weight_updated(const std::string& client_id,
-                                   size_t new_weight) override;
+    // Inline runs spend deficit like dequeued jobs
+    void on_job_run_inline(size_t slot, const Job& job) override;
 
-    void on_client_unregistered(const std::string& client_id) override;
+    void on_client_weight_updated(size_t slot, size_t new_weight) override;
+
+    void on_client_unregistered(size_t slot) override;
 
 private:
     uint32_t base_quantum_;
     size_t   drr_index_{0};
-    std::unordered_map<std::string, int64_t> deficit_; // credit counters
+    std::vector<int64_t> deficit_; // credit counters, per slot
 };
 
 } // namespace job_system
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace job_system {
+
+// Job lifecycle transitions written to an EventLog
+enum class EventType : uint8_t {
+    SUBMIT,   // admitted to a queue              extra = priority
+    REJECT,   // refused (REJECT / DROP_NEWEST)   extra = OverflowStrategy
+    DROP,     // evicted by DROP_OLDEST
+    EXPIRE,   // dequeued past its deadline
+    CANCEL,   // cancel_job(), drain_client() or unregister_client()
+    START,    // task about to run
+    COMPLETE, // task returned                    extra = duration µs
+    SPAWN,    // submitted from a running task    extra = parent job id
+              // (precedes the child's SUBMIT / REJECT)
+    NUM_TYPES
+};
+
+const char* event_type_name(EventType type);
+
+// Binary log of every job lifecycle transition, for post-hoc analysis with
+// `jlog_analyze`. Unlike TraceRecorder (arrivals + durations for replay) it
+// records each state change with the thread it happened on, so queue wait,
+// run time and per-worker utilisation can be reconstructed.
+//
+// Each recording thread appends to its own buffer; a full buffer is written
+// as one chunk with a single write. Records within a thread's chunks are in
+// order; chunks from different threads interleave, so readers must not
+// assume global time order.
+//
+// File layout: 8-byte magic "JSEVLOG1", then chunks of LEB128 varints:
+//   chunk  : thread, base_ts_ns, payload_len, payload
+//   payload: records; each is a type byte followed by
+//     'N' name   : index, len, bytes     (thread-local client index)
+//     event      : dt_ns, client, zigzag(job_id − previous job_id), extra
+// dt_ns and the job_id delta restart from base_ts_ns / 0 in every chunk.
+// Client indices are per thread and persist across that thread's chunks.
+class EventLog {
+public:
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 64 * 1024;
+
+    // Throws std::runtime_error if the file cannot be opened or written
+    explicit EventLog(const std::string& path,
+                      size_t buffer_bytes = DEFAULT_BUFFER_BYTES);
+    ~EventLog(); // flushes every thread's buffer; a failure shows in records_lost()
+
+    void record(EventType type, const std::string& client_id, uint64_t job_id,
+                uint64_t extra, std::chrono::steady_clock::time_point ts);
+
+    // Writes out every thread's pending records. Throws std::runtime_error
+    // if any write since the log was opened failed (record() never throws:
+    // it runs inside the Scheduler's locks).
+    void flush();
+    uint64_t records_written() const;
+    // Records recorded but not in the file because a write failed (e.g. a
+    // full disk); the file is valid up to the first failed chunk
+    uint64_t records_lost() const;
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+private:
+    struct ThreadBuffer;
+
+    ThreadBuffer& local_buffer();
+    // Caller must hold buf.mutex
+    void write_chunk(ThreadBuffer& buf);
+
+    const uint64_t id_; // distinguishes logs in the thread-local cache
+    const size_t buffer_bytes_;
+    const std::string path_;
+
+    std::mutex file_mutex_;
+    std::FILE* file_{nullptr};
+
+    std::mutex buffers_mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<bool> write_failed_{false};
+    std::atomic<uint64_t> lost_{0};
+};
+
+struct LogEvent {
+    EventType type{EventType::SUBMIT};
+    uint32_t  thread{0};       // recording thread (stable for the whole log)
+    uint64_t  timestamp_ns{0}; // Scheduler clock's time_since_epoch(), ns
+    uint32_t  client{0};       // index into EventLogReader::clients()
+    uint64_t  job_id{0};
+    uint64_t  extra{0};
+};
+
+// Streams an EventLog file. The file is memory-mapped and read once front to
+// back, releasing pages behind the cursor, so multi-GB logs need neither
+// that much RAM nor a full load before the first event.
+class EventLogReader {
+public:
+    // Throws std::runtime_error if the file cannot be opened or is not an
+    // event log
+    explicit EventLogReader(const std::string& path);
+    ~EventLogReader();
+
+    // Calls `fn` for every event in file order. Throws std::runtime_error on
+    // malformed input.
+    void for_each(const std::function<void(const LogEvent&)>& fn);
+
+    // Client names by index; grows as for_each() encounters them
+    const std::vector<std::string>& clients() const { return clients_; }
+    uint64_t file_bytes() const { return size_; }
+
+    EventLogReader(const EventLogReader&) = delete;
+    EventLogReader& operator=(const EventLogReader&) = delete;
+
+private:
+    std::string path_;
+    const uint8_t* data_{nullptr};
+    uint64_t size_{0};
+    std::vector<uint8_t> fallback_; // whole-file copy where mmap is unavailable
+
+    std::vector<std::string> clients_;
+    std::unordered_map<std::string, uint32_t> client_index_;
+};
+
+} // namespace job_system
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "job_system/job.h"
+#include "job_system/scheduler.h"
+
+// Sender/receiver (P2300) view of a Scheduler.
+//
+// std::execution is not part of C++20, so these types implement the P2300
+// member protocol directly: sender.connect(receiver) returns an immovable
+// operation state, op.start() launches it, and the receiver is completed with
+// exactly one of std::move(r).set_value() / set_error(exception_ptr) /
+// set_stopped(). Every sender here completes with no values.
+//
+//   auto sched = scheduler.get_scheduler("A", Priority::HIGH);
+//   sync_wait(bulk(sched.schedule(), n, [&](size_t i) { out[i] = f(in[i]); }));
+//
+// Starting an operation submits one job through the normal fairness path;
+// the job's task captures only the operation's address, so it is stored
+// inline in the Job and costs no allocation beyond submit() itself.
+// A job the scheduler discards (DROP_*, cancel_job, drain / unregister)
+// completes its receiver with set_stopped(); a REJECT client's
+// QueueFullException arrives as set_error().
+
+namespace job_system {
+
+// Receiver of a sender that completes with no values
+template <typename R>
+concept void_receiver =
+    std::move_constructible<R> && requires(R&& r, std::exception_ptr e) {
+        std::move(r).set_value();
+        std::move(r).set_error(e);
+        std::move(r).set_stopped();
+    };
+
+template <void_receiver R>
+class ScheduleOperation;
+
+// One client of a Scheduler at a fixed priority, as a P2300 scheduler.
+// Cheap to copy; equal when it targets the same client, priority and bulk
+// fan-out of the same Scheduler.
+class ClientScheduler {
+public:
+    class Sender;
+
+    // bulk_chunks: jobs a bulk() over this scheduler is split into
+    // (0 = std::thread::hardware_concurrency())
+    ClientScheduler(Scheduler& scheduler, std::string client_id,
+                    Priority priority = Priority::NORMAL, size_t bulk_chunks = 0)
+        : scheduler_(&scheduler)
+        , client_id_(std::move(client_id))
+        , priority_(priority)
+        , bulk_chunks_(bulk_chunks != 0
+                           ? bulk_chunks
+                           : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    Sender schedule() const;
+
+    ClientScheduler with_bulk_chunks(size_t chunks) const {
+        return ClientScheduler(*scheduler_, client_id_, priority_, chunks);
+    }
+
+    Scheduler& scheduler() const { return *scheduler_; }
+    const std::string& client_id() const { return client_id_; }
+    Priority priority() const { return priority_; }
+    size_t bulk_chunks() const { return bulk_chunks_; }
+
+    bool operator==(const ClientScheduler&) const = default;
+
+private:
+    Scheduler* scheduler_;
+    std::string client_id_;
+    Priority priority_;
+    size_t bulk_chunks_;
+};
+
+// Completes with set_value() on a worker running a job of the client
+class ClientScheduler::Sender {
+public:
+    explicit Sender(ClientScheduler scheduler) : scheduler_(std::move(scheduler)) {}
+
+    template <void_receiver R>
+    ScheduleOperation<std::decay_t<R>> connect(R&& receiver) const& {
+        return ScheduleOperation<std::decay_t<R>>(scheduler_, std::forward<R>(receiver));
+    }
+    template <void_receiver R>
+    ScheduleOperation<std::decay_t<R>> connect(R&& receiver) && {
+        return ScheduleOperation<std::decay_t<R>>(std::move(scheduler_),
+                                                  std::forward<R>(receiver));
+    }
+
+    const ClientScheduler& get_completion_scheduler() const noexcept { return scheduler_; }
+
+private:
+    ClientScheduler scheduler_;
+};
+
+inline ClientScheduler::Sender ClientScheduler::schedule() const { return Sender(*this); }
+
+template <void_receiver R>
+class ScheduleOperation {
+public:
+    ScheduleOperation(ClientScheduler scheduler, R receiver)
+        : scheduler_(std::move(scheduler)), receiver_(std::move(receiver)) {}
+
+    ScheduleOperation(const ScheduleOperation&) = delete;
+    ScheduleOperation& operator=(const ScheduleOperation&) = delete;
+
+    void start() noexcept {
+        try {
+            scheduler_.scheduler().submit(scheduler_.client_id(), Run{this}, 1,
+                                          scheduler_.priority());
+        } catch (...) {
+            // submit() throws only if Run was not queued, so this is the
+            // receiver's one completion
+            std::move(receiver_).set_error(std::current_exception());
+        }
+    }
+
+private:
+    // Trivially copyable and pointer-sized: Task stores it inline
+    struct Run {
+        ScheduleOperation* op;
+        void operator()() const { std::move(op->receiver_).set_value(); }
+        void on_discard() const { std::move(op->receiver_).set_stopped(); }
+    };
+
+    ClientScheduler scheduler_;
+    R receiver_;
+};
+
+// ── bulk ─────────────────────────────────────────────────────────────────────
+
+// Senders whose value completion happens on a ClientScheduler
+template <typename S>
+concept client_sender = requires(const S& s) {
+    { s.get_completion_scheduler() } -> std::convertible_to<const ClientScheduler&>;
+};
+
+template <client_sender Pred, std::integral Shape, typename F, void_receiver R>
+class BulkOperation {
+    struct PredReceiver {
+        BulkOperation* op;
+        void set_value() && noexcept { op->launch(); }
+        void set_error(std::exception_ptr e) && noexcept {
+            std::move(op->receiver_).set_error(std::move(e));
+        }
+        void set_stopped() && noexcept { std::move(op->receiver_).set_stopped(); }
+    };
+
+public:
+    BulkOperation(Pred&& pred, Shape shape, F f, R receiver)
+        : scheduler_(pred.get_completion_scheduler())
+        , shape_(shape)
+        , f_(std::move(f))
+        , receiver_(std::move(receiver))
+        , pred_op_(std::move(pred).connect(PredReceiver{this})) {}
+
+    BulkOperation(const BulkOperation&) = delete;
+    BulkOperation& operator=(const BulkOperation&) = delete;
+
+    void start() noexcept { pred_op_.start(); }
+
+private:
+    // One contiguous index range; two words, so stored inline like Run above
+    struct Chunk {
+        BulkOperation* op;
+        size_t index;
+        void operator()() const { op->run_chunk(index); }
+        void on_discard() const {
+            op->stopped_.store(true, std::memory_order_relaxed);
+            op->finish_one();
+        }
+    };
+
+    size_t size() const { return shape_ > 0 ? static_cast<size_t>(shape_) : 0; }
+    size_t chunk_begin(size_t c) const { return size() * c / chunks_; }
+
+    // Runs on whichever thread completed the predecessor. Once the last job
+    // is submitted, `this` may already be gone.
+    void launch() noexcept {
+        const size_t n = size();
+        if (n == 0) {
+            std::move(receiver_).set_value();
+            return;
+        }
+        const size_t chunks = std::min(n, scheduler_.bulk_chunks());
+        chunks_ = chunks;
+        pending_.store(chunks, std::memory_order_relaxed);
+        for (size_t c = 0; c < chunks; ++c) {
+            try {
+                // DRR charges the chunk by the number of indices it covers
+                const auto cost = static_cast<uint32_t>(std::min<size_t>(
+                    chunk_begin(c + 1) - chunk_begin(c), std::numeric_limits<uint32_t>::max()));
+                scheduler_.scheduler().submit(scheduler_.client_id(), Chunk{this, c}, cost,
+                                              scheduler_.priority());
+            } catch (...) {
+                fail(std::current_exception());
+                // submit() throws only if the chunk was not queued
+                const size_t missing = chunks - c; // never submitted
+                if (pending_.fetch_sub(missing, std::memory_order_acq_rel) == missing) complete();
+                return;
+            }
+        }
+    }
+
+    void run_chunk(size_t c) {
+        if (!failed_.load(std::memory_order_relaxed)) {
+            try {
+                for (size_t i = chunk_begin(c), end = chunk_begin(c + 1); i < end; ++i)
+                    f_(static_cast<Shape>(i));
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        }
+        finish_one();
+    }
+
+    void fail(std::exception_ptr e) noexcept {
+        if (!failed_.exchange(true, std::memory_order_relaxed)) error_ = std::move(e);
+    }
+
+    void finish_one() noexcept {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) complete();
+    }
+
+    void complete() noexcept {
+        if (failed_.load(std::memory_order_relaxed)) {
+            std::move(receiver_).set_error(std::move(error_));
+        } else if (stopped_.load(std::memory_order_relaxed)) {
+            std::move(receiver_).set_stopped();
+        } else {
+            std::move(receiver_).set_value();
+        }
+    }
+
+    using PredOp = decltype(std::declval<Pred>().connect(std::declval<PredReceiver>()));
+
+    ClientScheduler scheduler_;
+    Shape shape_;
+    F f_;
+    R receiver_;
+    size_t chunks_{1};
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> stopped_{false};
+    std::exception_ptr error_;
+    PredOp pred_op_;
+};
+
+template <client_sender Pred, std::integral Shape, typename F>
+class BulkSender {
+public:
+    BulkSender(Pred pred, Shape shape, F f)
+        : pred_(std::move(pred)), shape_(shape), f_(std::move(f)) {}
+
+    template <void_receiver R>
+    BulkOperation<Pred, Shape, F, std::decay_t<R>> connect(R&& receiver) && {
+        return BulkOperation<Pred, Shape, F, std::decay_t<R>>(
+            std::move(pred_), shape_, std::move(f_), std::forward<R>(receiver));
+    }
+    template <void_receiver R>
+    BulkOperation<Pred, Shape, F, std::decay_t<R>> connect(R&& receiver) const& {
+        Pred pred = pred_;
+        return BulkOperation<Pred, Shape, F, std::decay_t<R>>(std::move(pred), shape_, f_,
+                                                              std::forward<R>(receiver));
+    }
+
+    const ClientScheduler& get_completion_scheduler() const noexcept {
+        return pred_.get_completion_scheduler();
+    }
+
+private:
+    Pred pred_;
+    Shape shape_;
+    F f_;
+};
+
+// P2300 bulk: once `pred` completes, calls f(i) for every i in [0, shape),
+// split into scheduler.bulk_chunks() jobs of contiguous indices that run in
+// parallel on the predecessor's client, each going through the fairness
+// policy. The first exception from f stops chunks that have not started yet
+// and is delivered through set_error().
+template <client_sender Pred, std::integral Shape, typename F>
+BulkSender<std::decay_t<Pred>, Shape, std::decay_t<F>> bulk(Pred&& pred, Shape shape, F&& f) {
+    return {std::forward<Pred>(pred), shape, std::forward<F>(f)};
+}
+
+// ── sync_wait ────────────────────────────────────────────────────────────────
+
+// Starts `sender` and blocks the calling thread until it completes. Returns an
+// empty tuple on set_value(), nullopt on set_stopped(), and rethrows on
+// set_error(). Calling it from a task can deadlock a pool that has no other
+// worker free to run the awaited jobs.
+template <typename S>
+std::optional<std::tuple<>> sync_wait(S&& sender) {
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done{false};
+        bool stopped{false};
+        std::exception_ptr error;
+
+        // Notifies under the lock: the waiter destroys State once it sees done
+        void finish(bool was_stopped, std::exception_ptr e) {
+            std::lock_guard lock(mutex);
+            stopped = was_stopped;
+            error = std::move(e);
+            done = true;
+            cv.notify_one();
+        }
+    };
+    struct Receiver {
+        State* state;
+        void set_value() && noexcept { state->finish(false, nullptr); }
+        void set_error(std::exception_ptr e) && noexcept { state->finish(false, std::move(e)); }
+        void set_stopped() && noexcept { state->finish(true, nullptr); }
+    };
+
+    State state;
+    auto op = std::forward<S>(sender).connect(Receiver{&state});
+    op.start();
+    std::unique_lock lock(state.mutex);
+    state.cv.wait(lock, [&] { return state.done; });
+    if (state.error) std::rethrow_exception(state.error);
+    if (state.stopped) return std::nullopt;
+    return std::tuple<>{};
+}
+
+} // namespace job_system
@@ -1,12 +1,18 @@
 #pragma once
 
-#include <chrono>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <string>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include "job_system/task.h"
 
 namespace job_system {
 
+class CompletionQueue;
+
 enum class Priority : uint8_t {
     LOW      = 0,
     NORMAL   = 1,
@@ -15,27 +21,110 @@ enum class Priority : uint8_t {
     NUM_LEVELS = 4   // sentinel — never use as a job priority
 };
 
-struct Job {
-    std::string client_id;
-    std::function<void()> task;
-    std::chrono::steady_clock::time_point enqueue_time;
+// Index of a registered client in its Scheduler (assigned at registration)
+using ClientHandle = uint32_t;
+inline constexpr ClientHandle NO_CLIENT = UINT32_MAX;
+
+// Job data most jobs do not carry, allocated on demand: spawn lineage (jobs
+// submitted from inside a task) and completion reporting
+struct JobExtras {
+    uint64_t parent_id{0};
+    uint64_t root_id{0};
+    CompletionQueue* completion_queue{nullptr};
+    uint64_t user_tag{0};
+};
+
+// One queued job, exactly one cache line. Client, timestamps, lineage and
+// completion fields are filled in by Scheduler::submit; callers building a
+// Job for submit(client_id, Job) set the task, cost, priority and completion
+// queue only.
+//
+// Timestamps are microseconds on the scheduler's clock since its
+// construction, truncated to 32 bits (wrapping every ~71 minutes); the
+// deadline is kept relative to the enqueue time. Scheduler::enqueue_time()
+// and Scheduler::deadline() convert them back.
+struct alignas(64) Job {
+    using RawHandler = Task::RawHandler;
+    static constexpr size_t RAW_PAYLOAD_BYTES = Task::RAW_PAYLOAD_BYTES;
+    // cost_hint is packed into 24 bits; larger hints are clamped
+    static constexpr uint32_t MAX_COST_HINT = (1u << 24) - 1;
+
+    Task task;
     uint64_t job_id{0};
-    uint32_t cost_hint{1}; // DRR cost unit; default 1 = unit cost (WRR-equivalent)
-    Priority priority{Priority::NORMAL};
-    // Default-constructed time_point = epoch = "no deadline" sentinel
-    std::chrono::steady_clock::time_point deadline{};
+    // Null unless the job has a parent or a completion queue
+    std::unique_ptr<JobExtras> extras;
+    ClientHandle client{NO_CLIENT};
+    uint32_t enqueue_us{0};
+    int32_t deadline_us{0}; // after enqueue_us; meaningful if has_deadline()
+
+private:
+    uint32_t cost_hint_ : 24 {1}; // DRR cost unit; 1 = unit cost (WRR-equivalent)
+    uint32_t priority_ : 2 {static_cast<uint32_t>(Priority::NORMAL)};
+    uint32_t has_deadline_ : 1 {0};
 
-    bool is_expired() const {
-        if (deadline == std::chrono::steady_clock::time_point{}) return false;
-        return std::chrono::steady_clock::now() > deadline;
+public:
+    uint32_t cost_hint() const { return cost_hint_; }
+    void set_cost_hint(uint32_t cost) { cost_hint_ = cost < MAX_COST_HINT ? cost : MAX_COST_HINT; }
+
+    Priority priority() const { return static_cast<Priority>(priority_); }
+    void set_priority(Priority priority) { priority_ = static_cast<uint32_t>(priority) & 3u; }
+
+    bool has_deadline() const { return has_deadline_ != 0; }
+    void set_deadline(int32_t after_enqueue_us) {
+        deadline_us = after_enqueue_us;
+        has_deadline_ = 1;
+    }
+    void clear_deadline() {
+        deadline_us = 0;
+        has_deadline_ = 0;
     }
 
-    Job() = default;
+    // Whether the deadline has passed at `now_us` (same time base as
+    // enqueue_us). Correct for jobs that have waited less than ~35 minutes.
+    bool is_expired(uint32_t now_us) const {
+        return has_deadline() && static_cast<int32_t>(now_us - enqueue_us) > deadline_us;
+    }
 
-    Job(std::string cid, std::function<void()> t)
-        : client_id(std::move(cid))
-        , task(std::move(t))
-        , enqueue_time(std::chrono::steady_clock::now()) {}
+    // Spawn lineage: set by submit() when called from inside a running task
+    // of the same Scheduler while an event log is attached (its only reader).
+    // parent_id 0 = top-level job or lineage not recorded (root_id == job_id).
+    uint64_t parent_id() const { return extras ? extras->parent_id : 0; }
+    uint64_t root_id() const { return extras && extras->root_id != 0 ? extras->root_id : job_id; }
+
+    // Receives a Completion tagged user_tag when the job finishes or is
+    // discarded (completion_queue.h); must outlive the job
+    CompletionQueue* completion_queue() const {
+        return extras ? extras->completion_queue : nullptr;
+    }
+    uint64_t user_tag() const { return extras ? extras->user_tag : 0; }
+    void set_completion(CompletionQueue* cq, uint64_t user_tag) {
+        if (!extras) {
+            if (!cq) return;
+            extras = std::make_unique<JobExtras>();
+        }
+        extras->completion_queue = cq;
+        extras->user_tag = user_tag;
+    }
+
+    // Makes this a raw job (Task::raw): copies `payload`, zero-padded.
+    // Throws std::invalid_argument if it exceeds RAW_PAYLOAD_BYTES.
+    void set_raw(RawHandler handler, std::span<const std::byte> payload) {
+        task = Task::raw(handler, payload);
+    }
+
+    bool is_raw() const { return task.is_raw(); }
+
+    // Runs the job's body, if any
+    void run() {
+        if (task) task();
+    }
+
+    // Whether discarding the job must notify someone
+    bool wants_discard_notice() const {
+        return task.has_discard_hook() || completion_queue() != nullptr;
+    }
+
+    Job() = default;
 
     // Move-only
     Job(Job&&) = default;
@@ -44,4 +133,20 @@ struct Job {
     Job& operator=(const Job&) = delete;
 };
 
+static_assert(sizeof(Job) == 64, "Job must fit one cache line");
+
+// A value that can travel as a raw job payload
+template <typename T>
+concept RawPayload = std::is_trivially_copyable_v<T> && sizeof(T) <= Job::RAW_PAYLOAD_BYTES &&
+                     alignof(T) <= 8 &&
+                     !std::is_convertible_v<const T&, std::span<const std::byte>>;
+
+// Reads a raw handler's payload back as the T it was submitted as
+template <RawPayload T>
+T load_payload(const std::byte* payload) {
+    T value;
+    std::memcpy(&value, payload, sizeof(T));
+    return value;
+}
+
 } // namespace job_system
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "job_system/scheduler.h"
+
+namespace job_system {
+
+// Runs jobs on the calling thread, one select at a time, instead of a
+// ThreadPool. With a ManualClock injected into the Scheduler this makes
+// scheduling fully deterministic: for a given arrival order the jobs run in
+// exactly the order a single-worker ThreadPool would run them, since both
+// go through Scheduler::select_next_job() and Scheduler::execute().
+//
+// Jobs may submit further jobs. A BLOCK-strategy submit from inside a job
+// that hits a full queue waits forever, since nothing else drains it, unless
+// the scheduler has set_help_while_blocked(true); then the submit runs the
+// client's next job inline. CALLER_RUNS clients never wait.
+class ManualExecutor {
+public:
+    explicit ManualExecutor(Scheduler& scheduler);
+
+    // Dequeues and runs up to `n` jobs. Returns how many ran (fewer than `n`
+    // only when the scheduler had nothing runnable).
+    size_t step(size_t n = 1);
+
+    // Steps until nothing is runnable or `max_jobs` have run
+    size_t run_until_idle(size_t max_jobs = std::numeric_limits<size_t>::max());
+
+    uint64_t executed() const { return executed_; }
+
+    ManualExecutor(const ManualExecutor&) = delete;
+    ManualExecutor& operator=(const ManualExecutor&) = delete;
+
+private:
+    Scheduler& scheduler_;
+    uint64_t executed_{0};
+};
+
+} // namespace job_system
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "job_system/execution.h"
+#include "job_system/parallel.h"
+
+// In-process map-reduce over one client of a Scheduler.
+//
+//   MapReduce<std::string, uint64_t> wc(sched.get_scheduler("A").with_bulk_chunks(8));
+//   wc.set_combiner([](uint64_t a, uint64_t b) { return a + b; });
+//   auto counts = wc.run(lines.begin(), lines.end(),
+//       [](std::string_view line, auto& out) { for (auto w : words(line)) out.emit(std::string(w), 1); },
+//       [](const std::string&, std::vector<uint64_t>& n) { return std::accumulate(n.begin(), n.end(), 0ull); });
+//
+// The input range is split into map tasks and the keys into hash partitions.
+// Every map task owns one buffer per partition, so emitting never takes a
+// lock; the shuffle is each reduce task reading its partition's buffer from
+// every map task. Both phases run through par::detail::fork_join, i.e. as
+// helper jobs of the ClientScheduler's client plus the calling thread.
+//
+// With a combiner, a map task keeps one combined value per key and partition
+// instead of every record, and the reduce side combines as it groups.
+// With a memory limit, a map task whose buffers exceed it appends them to one
+// spill file per partition and starts over; reduce tasks read the files back.
+// A file is open only while a spill appends to it, so a run never holds more
+// descriptors than it has threads, however many partitions it has.
+// Spilling needs SpillCodec for K and V (arithmetic types and std::string
+// are provided). A failed write or close of a spill file, or a spill file
+// that ends mid-record, fails run() with std::runtime_error.
+//
+// The limit bounds the map side only: a reduce task groups its whole
+// partition in memory, so more partitions are the way to bound that side.
+
+namespace job_system {
+
+struct MapReduceOptions {
+    size_t map_tasks{0};          // 0 = 4 per participant (bulk_chunks())
+    size_t partitions{0};         // reduce tasks; 0 = 4 per participant
+    size_t memory_limit_bytes{0}; // per map task, before spilling (0 = never spill);
+                                  // reduce tasks hold a whole partition
+    std::string spill_dir;        // empty = std::filesystem::temp_directory_path()
+};
+
+struct MapReduceStats {
+    uint64_t map_tasks{0};
+    uint64_t reduce_tasks{0};
+    uint64_t input_records{0};
+    uint64_t emitted{0};       // emit() calls
+    uint64_t shuffled{0};      // records handed to reduce tasks (after combining)
+    uint64_t spills{0};        // times a map task flushed its buffers to disk
+    uint64_t spilled_bytes{0};
+    uint64_t output_keys{0};
+};
+
+// Binary encoding for spill files; specialise for other key/value types.
+// write() returns the bytes written and throws std::runtime_error if it
+// could not write them all; read() returns false if the value is incomplete.
+template <typename T>
+struct SpillCodec;
+
+namespace detail {
+
+inline size_t spill_write(std::FILE* f, const void* data, size_t size) {
+    if (size != 0 && std::fwrite(data, 1, size, f) != size) {
+        throw std::runtime_error("Short write to spill file");
+    }
+    return size;
+}
+
+} // namespace detail
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+struct SpillCodec<T> {
+    static size_t write(std::FILE* f, const T& v) { return detail::spill_write(f, &v, sizeof v); }
+    static bool read(std::FILE* f, T& v) { return std::fread(&v, sizeof v, 1, f) == 1; }
+};
+
+template <>
+struct SpillCodec<std::string> {
+    static size_t write(std::FILE* f, const std::string& s) {
+        const uint32_t n = static_cast<uint32_t>(s.size());
+        return detail::spill_write(f, &n, sizeof n) + detail::spill_write(f, s.data(), n);
+    }
+    static bool read(std::FILE* f, std::string& s) {
+        uint32_t n = 0;
+        if (std::fread(&n, sizeof n, 1, f) != 1) return false;
+        s.resize(n);
+        return std::fread(s.data(), 1, n, f) == n;
+    }
+};
+
+template <typename T>
+concept spillable = requires(std::FILE* f, const T& in, T& out) {
+    { SpillCodec<T>::write(f, in) } -> std::convertible_to<size_t>;
+    { SpillCodec<T>::read(f, out) } -> std::convertible_to<bool>;
+};
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class MapReduce {
+    struct Task;
+
+public:
+    using Combiner = std::function<V(V, V)>;
+
+    // Collects one map task's output; passed to the map function
+    class Emitter {
+    public:
+        void emit(K key, V value) {
+            ++emitted_;
+            const size_t p = owner_->partition_of(key);
+            if (owner_->combiner_) {
+                auto& m = task_->combined[p];
+                auto it = m.find(key);
+                if (it != m.end()) {
+                    it->second = owner_->combiner_(std::move(it->second), std::move(value));
+                    return;
+                }
+                bytes_ += record_bytes(key, value) + 2 * sizeof(void*); // node + bucket
+                m.emplace(std::move(key), std::move(value));
+            } else {
+                bytes_ += record_bytes(key, value);
+                task_->records[p].emplace_back(std::move(key), std::move(value));
+            }
+            if (owner_->options_.memory_limit_bytes != 0 &&
+                bytes_ > owner_->options_.memory_limit_bytes) {
+                owner_->spill(*task_);
+                bytes_ = 0;
+            }
+        }
+
+    private:
+        friend class MapReduce;
+        Emitter(MapReduce* owner, Task* task) : owner_(owner), task_(task) {}
+
+        MapReduce* owner_;
+        Task* task_;
+        size_t bytes_{0};
+        uint64_t emitted_{0};
+    };
+
+    explicit MapReduce(ClientScheduler scheduler, MapReduceOptions options = {})
+        : scheduler_(std::move(scheduler)), options_(std::move(options)) {
+        if (options_.memory_limit_bytes != 0 && !(spillable<K> && spillable<V>)) {
+            throw std::invalid_argument("MapReduce: memory limit needs SpillCodec for K and V");
+        }
+        if (options_.spill_dir.empty()) {
+            options_.spill_dir = std::filesystem::temp_directory_path().string();
+        }
+    }
+
+    // Folds values of the same key on the map side and while grouping;
+    // must be associative and commutative
+    void set_combiner(Combiner combiner) { combiner_ = std::move(combiner); }
+
+    // map(const auto& input, Emitter& out) for every input record, then
+    // reduce(const K&, std::vector<V>& values) -> V once per distinct key.
+    // Output is grouped by partition; order within a partition is unspecified.
+    template <std::random_access_iterator It, typename Map, typename Reduce>
+    std::vector<std::pair<K, V>> run(It first, It last, Map map, Reduce reduce) {
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t per_participant = std::max<size_t>(scheduler_.bulk_chunks(), 1) * 4;
+        const size_t map_tasks = std::max<size_t>(
+            1, std::min(n, options_.map_tasks ? options_.map_tasks : per_participant));
+        partitions_ = options_.partitions ? options_.partitions : per_participant;
+
+        stats_ = MapReduceStats{};
+        stats_.map_tasks = map_tasks;
+        stats_.reduce_tasks = partitions_;
+        stats_.input_records = n;
+        // Names this run's spill files apart from other runs and processes
+        run_id_ = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                  reinterpret_cast<uintptr_t>(this);
+        spills_.store(0, std::memory_order_relaxed);
+        spilled_bytes_.store(0, std::memory_order_relaxed);
+
+        std::vector<Task> tasks(map_tasks);
+        for (size_t t = 0; t < map_tasks; ++t) tasks[t].init(*this, t);
+        SpillCleanup cleanup{tasks};
+
+        std::vector<uint64_t> emitted(map_tasks, 0);
+        auto map_body = [&](size_t t) {
+            Emitter out(this, &tasks[t]);
+            const It end = first + par::detail::chunk_begin(n, map_tasks, t + 1);
+            for (It it = first + par::detail::chunk_begin(n, map_tasks, t); it != end; ++it)
+                map(*it, out);
+            emitted[t] = out.emitted_;
+        };
+        par::detail::fork_join(scheduler_, map_tasks, map_body);
+
+        std::vector<std::vector<std::pair<K, V>>> output(partitions_);
+        std::vector<uint64_t> shuffled(partitions_, 0);
+        auto reduce_body = [&](size_t p) {
+            std::unordered_map<K, std::vector<V>, Hash> groups;
+            auto add = [&](K&& key, V&& value) {
+                ++shuffled[p];
+                auto& values = groups[std::move(key)];
+                if (combiner_ && !values.empty()) {
+                    values[0] = combiner_(std::move(values[0]), std::move(value));
+                } else {
+                    values.push_back(std::move(value));
+                }
+            };
+            for (auto& task : tasks) {
+                read_spill(task.spill_paths[p], add);
+                for (auto& kv : task.records[p]) add(std::move(kv.first), std::move(kv.second));
+                task.records[p] = {};
+                if (combiner_) {
+                    auto& m = task.combined[p];
+                    while (!m.empty()) {
+                        auto node = m.extract(m.begin());
+                        add(std::move(node.key()), std::move(node.mapped()));
+                    }
+                }
+            }
+            output[p].reserve(groups.size());
+            for (auto& [key, values] : groups) output[p].emplace_back(key, reduce(key, values));
+        };
+        par::detail::fork_join(scheduler_, partitions_, reduce_body);
+
+        std::vector<std::pair<K, V>> result;
+        size_t total = 0;
+        for (const auto& part : output) total += part.size();
+        result.reserve(total);
+        for (auto& part : output) {
+            for (auto& kv : part) result.push_back(std::move(kv));
+        }
+
+        for (uint64_t e : emitted) stats_.emitted += e;
+        for (uint64_t s : shuffled) stats_.shuffled += s;
+        stats_.spills = spills_.load(std::memory_order_relaxed);
+        stats_.spilled_bytes = spilled_bytes_.load(std::memory_order_relaxed);
+        stats_.output_keys = result.size();
+        return result;
+    }
+
+    // Counters of the last run()
+    const MapReduceStats& stats() const { return stats_; }
+
+private:
+    // One map task's partitioned output and spill files
+    struct Task {
+        std::vector<std::vector<std::pair<K, V>>> records;   // without a combiner
+        std::vector<std::unordered_map<K, V, Hash>> combined; // with a combiner
+        std::vector<std::string> spill_paths;                 // per partition, "" = none
+
+        void init(const MapReduce& owner, size_t index) {
+            records.resize(owner.partitions_);
+            if (owner.combiner_) combined.resize(owner.partitions_);
+            spill_paths.resize(owner.partitions_);
+            id = index;
+        }
+        size_t id{0};
+    };
+
+    struct FileCloser {
+        void operator()(std::FILE* f) const { std::fclose(f); }
+    };
+    using File = std::unique_ptr<std::FILE, FileCloser>;
+
+    // Removes spill files however run() exits
+    struct SpillCleanup {
+        std::vector<Task>& tasks;
+        ~SpillCleanup() {
+            for (auto& t : tasks) {
+                for (const auto& path : t.spill_paths) {
+                    if (!path.empty()) std::remove(path.c_str());
+                }
+            }
+        }
+    };
+
+    static size_t extra_bytes(const std::string& s) { return s.size(); }
+    template <typename T>
+    static size_t extra_bytes(const T&) { return 0; }
+    static size_t record_bytes(const K& k, const V& v) {
+        return sizeof(std::pair<K, V>) + extra_bytes(k) + extra_bytes(v);
+    }
+
+    // Mixed before the modulo so partitions stay balanced under weak hashes
+    size_t partition_of(const K& key) const {
+        uint64_t h = static_cast<uint64_t>(Hash{}(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h % partitions_);
+    }
+
+    // Appends a map task's buffers to its per-partition spill files, each
+    // opened for this append only
+    void spill(Task& task) {
+        if constexpr (spillable<K> && spillable<V>) {
+            uint64_t bytes = 0;
+            auto append = [&](size_t p, const auto& entries) {
+                std::string& path = task.spill_paths[p];
+                if (path.empty()) {
+                    path = (std::filesystem::path(options_.spill_dir) /
+                            ("job_system_mr_" + std::to_string(run_id_) + "_" +
+                             std::to_string(task.id) + "_" + std::to_string(p) + ".spill"))
+                               .string();
+                }
+                File file(std::fopen(path.c_str(), "ab"));
+                if (!file) throw std::runtime_error("Cannot open spill file: " + path);
+                for (const auto& kv : entries) {
+                    bytes += SpillCodec<K>::write(file.get(), kv.first);
+                    bytes += SpillCodec<V>::write(file.get(), kv.second);
+                }
+                // ferror() also catches codecs that do not check their own
+                // writes; buffered write errors (e.g. ENOSPC) surface at fclose()
+                const bool failed = std::ferror(file.get()) != 0;
+                if (std::fclose(file.release()) != 0 || failed) {
+                    throw std::runtime_error("Cannot write spill file: " + path);
+                }
+            };
+            for (size_t p = 0; p < partitions_; ++p) {
+                if (combiner_) {
+                    if (task.combined[p].empty()) continue;
+                    append(p, task.combined[p]);
+                    task.combined[p].clear();
+                } else {
+                    if (task.records[p].empty()) continue;
+                    append(p, task.records[p]);
+                    task.records[p].clear();
+                }
+            }
+            spills_.fetch_add(1, std::memory_order_relaxed);
+            spilled_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename Add>
+    void read_spill(const std::string& path, Add& add) {
+        if constexpr (spillable<K> && spillable<V>) {
+            if (path.empty()) return;
+            const File file(std::fopen(path.c_str(), "rb"));
+            std::FILE* const f = file.get();
+            if (!f) throw std::runtime_error("Cannot open spill file: " + path);
+            K key{};
+            V value{};
+            // Only a record boundary may be the end of the file: once the
+            // next byte exists, the whole record must read back
+            for (int c; (c = std::fgetc(f)) != EOF;) {
+                std::ungetc(c, f);
+                if (!SpillCodec<K>::read(f, key) || !SpillCodec<V>::read(f, value)) {
+                    throw std::runtime_error(
+                        (std::ferror(f) ? "Cannot read spill file: " : "Truncated spill file: ") +
+                        path);
+                }
+                add(std::move(key), std::move(value));
+            }
+            if (std::ferror(f)) throw std::runtime_error("Cannot read spill file: " + path);
+        }
+    }
+
+    ClientScheduler scheduler_;
+    MapReduceOptions options_;
+    Combiner combiner_;
+    size_t partitions_{1};
+    uint64_t run_id_{0};
+    MapReduceStats stats_;
+    std::atomic<uint64_t> spills_{0};
+    std::atomic<uint64_t> spilled_bytes_{0};
+};
+
+} // namespace job_system
@@ -13,6 +13,16 @@ public:
                                   std::chrono::microseconds /*duration*/) {}
     virtual void on_job_expired(const std::string& /*client_id*/, uint64_t /*job_id*/) {}
     virtual void on_job_cancelled(const std::string& /*client_id*/, uint64_t /*job_id*/) {}
+    // A task threw and the exception was swallowed: the job has a completion
+    // queue, or a submitter ran it inline (CALLER_RUNS, help-while-blocked).
+    // Follows on_job_executed() for the same job.
+    virtual void on_job_failed(const std::string& /*client_id*/, uint64_t /*job_id*/) {}
+    // A BLOCK-strategy submit found the queue full. blocking_task_id is the
+    // job the submitting thread was running (0 = not a task of this
+    // Scheduler); waited is 0 when it ran a queued job instead of sleeping.
+    virtual void on_submit_blocked(const std::string& /*client_id*/, uint64_t /*job_id*/,
+                                   uint64_t /*blocking_task_id*/,
+                                   std::chrono::microseconds /*waited*/) {}
 };
 
 } // namespace job_system
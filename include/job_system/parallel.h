@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "job_system/execution.h"
+#include "job_system/scheduler.h"
+
+// Parallel algorithms over one client of a Scheduler.
+//
+//   auto cs = sched.get_scheduler("A").with_bulk_chunks(8);
+//   par::sort(cs, v.begin(), v.end());
+//   double total = par::reduce(cs, v.begin(), v.end(), 0.0);
+//
+// Each call splits its range into chunks, submits up to cs.bulk_chunks() - 1
+// helper jobs to the client and works through the chunks on the calling
+// thread as well, so the work is charged to that client's fairness share and
+// calling from inside a task cannot deadlock: the caller finishes whatever the
+// helpers have not picked up. Helpers that run after the call has returned
+// find nothing left to do. Helpers only take free slots of a bounded
+// client's queue (Scheduler::try_submit), whatever its overflow strategy: a
+// full client only costs parallelism, and a call never blocks on the queue,
+// evicts a queued job or runs one inline. With bulk_chunks() == 1 every
+// algorithm runs serially on the caller. The first exception thrown by a
+// user callable skips the remaining chunks and is rethrown by the call.
+//
+// Iterators must be random access. Chunks run concurrently, so callables must
+// be safe to call from several threads at once; reduce and inclusive_scan
+// assume `op` is associative.
+
+namespace job_system::par {
+
+namespace detail {
+
+// Chunks of one parallel call, claimed by the caller and the helper jobs.
+// Helpers own a reference, so a late helper never touches a freed state; it
+// only calls `body` for a chunk it claimed, which the caller is waiting on.
+struct ForkState {
+    ForkState(size_t n, void (*fn)(void*, size_t), void* b) : chunks(n), run(fn), body(b) {}
+
+    const size_t chunks;
+    void (*const run)(void*, size_t);
+    void* const body;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    void work() noexcept {
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    run(body, c);
+                } catch (...) {
+                    if (!failed.exchange(true, std::memory_order_relaxed))
+                        error = std::current_exception();
+                }
+            }
+            if (finished.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks)
+                finished.notify_all();
+        }
+    }
+};
+
+// Runs body(c) for every c in [0, chunks) on the caller and the client's
+// helper jobs; returns once all have finished
+template <typename Body>
+void fork_join(const ClientScheduler& cs, size_t chunks, Body& body) {
+    if (chunks == 0) return;
+    if (chunks == 1 || cs.bulk_chunks() <= 1) {
+        for (size_t c = 0; c < chunks; ++c) body(c);
+        return;
+    }
+    auto state = std::make_shared<ForkState>(
+        chunks, [](void* b, size_t c) { (*static_cast<Body*>(b))(c); }, &body);
+
+    const size_t helpers = std::min(chunks, cs.bulk_chunks()) - 1;
+    // The caller runs whatever the missing helpers would have. try_submit()
+    // throws only if the helper was not queued (client unregistered, out of
+    // memory), and queued helpers already share `body`, so it cannot unwind.
+    for (size_t h = 0; h < helpers; ++h) {
+        bool queued = false;
+        try {
+            queued = cs.scheduler().try_submit(cs.client_id(), [state] { state->work(); }, 1,
+                                               cs.priority());
+        } catch (const std::exception&) {
+        }
+        if (!queued) break;
+    }
+
+    state->work();
+    for (size_t f; (f = state->finished.load(std::memory_order_acquire)) != chunks;)
+        state->finished.wait(f, std::memory_order_acquire);
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+// Oversplit by 4 so uneven chunks and late helpers still balance
+inline size_t chunk_count(const ClientScheduler& cs, size_t n) {
+    return cs.bulk_chunks() <= 1 ? std::min<size_t>(n, 1) : std::min(n, cs.bulk_chunks() * 4);
+}
+
+inline size_t chunk_begin(size_t n, size_t chunks, size_t c) { return n * c / chunks; }
+
+// Runs shorter than this are not worth a job of their own when sorting
+inline constexpr size_t min_sort_run = 1024;
+
+// Merge path: how many of the first d elements of merge(a, b) come from a
+template <typename It, typename Comp>
+size_t merge_split(It a, size_t na, It b, size_t nb, size_t d, Comp& comp) {
+    size_t lo = d > nb ? d - nb : 0;
+    size_t hi = std::min(d, na);
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (comp(b[d - mid - 1], a[mid])) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// Merges adjacent pairs of sorted runs [bounds[2k], bounds[2k+1]) and
+// [bounds[2k+1], bounds[2k+2]) from src into dst, splitting every merge into
+// pieces so that the round keeps all participants busy. An unpaired last run
+// is moved across unchanged.
+template <typename Src, typename Dst, typename Comp>
+void merge_round(const ClientScheduler& cs, Src src, Dst dst, const std::vector<size_t>& bounds,
+                 size_t pieces_per_round, Comp& comp) {
+    struct Piece {
+        size_t lo, mid, hi; // the two runs are [lo, mid) and [mid, hi)
+        size_t d0, d1;      // output offsets within [lo, hi)
+    };
+    const size_t n = bounds.back();
+    std::vector<Piece> pieces;
+    for (size_t k = 0; k + 1 < bounds.size(); k += 2) {
+        const size_t lo = bounds[k];
+        const size_t mid = bounds[k + 1];
+        const size_t hi = k + 2 < bounds.size() ? bounds[k + 2] : mid;
+        const size_t len = hi - lo;
+        const size_t parts = std::max<size_t>(1, pieces_per_round * len / n);
+        for (size_t p = 0; p < parts; ++p)
+            pieces.push_back({lo, mid, hi, len * p / parts, len * (p + 1) / parts});
+    }
+
+    auto body = [&](size_t i) {
+        const Piece& pc = pieces[i];
+        const size_t na = pc.mid - pc.lo;
+        const size_t nb = pc.hi - pc.mid;
+        const size_t a0 = merge_split(src + pc.lo, na, src + pc.mid, nb, pc.d0, comp);
+        const size_t a1 = merge_split(src + pc.lo, na, src + pc.mid, nb, pc.d1, comp);
+        std::merge(std::make_move_iterator(src + pc.lo + a0),
+                   std::make_move_iterator(src + pc.lo + a1),
+                   std::make_move_iterator(src + pc.mid + (pc.d0 - a0)),
+                   std::make_move_iterator(src + pc.mid + (pc.d1 - a1)),
+                   dst + pc.lo + pc.d0, comp);
+    };
+    fork_join(cs, pieces.size(), body);
+}
+
+} // namespace detail
+
+// f(x) for every element of [first, last)
+template <std::random_access_iterator It, typename F>
+void for_each(const ClientScheduler& cs, It first, It last, F f) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t chunks = detail::chunk_count(cs, n);
+    auto body = [&](size_t c) {
+        const It end = first + detail::chunk_begin(n, chunks, c + 1);
+        for (It it = first + detail::chunk_begin(n, chunks, c); it != end; ++it) f(*it);
+    };
+    detail::fork_join(cs, chunks, body);
+}
+
+// d_first[i] = op(first[i]); returns the end of the output
+template <std::random_access_iterator It, std::random_access_iterator Out, typename Op>
+Out transform(const ClientScheduler& cs, It first, It last, Out d_first, Op op) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t chunks = detail::chunk_count(cs, n);
+    auto body = [&](size_t c) {
+        const size_t b = detail::chunk_begin(n, chunks, c);
+        const size_t e = detail::chunk_begin(n, chunks, c + 1);
+        std::transform(first + b, first + e, d_first + b, std::ref(op));
+    };
+    detail::fork_join(cs, chunks, body);
+    return d_first + n;
+}
+
+// d_first[i] = op(first1[i], first2[i]); returns the end of the output
+template <std::random_access_iterator It1, std::random_access_iterator It2,
+          std::random_access_iterator Out, typename Op>
+Out transform(const ClientScheduler& cs, It1 first1, It1 last1, It2 first2, Out d_first, Op op) {
+    const size_t n = static_cast<size_t>(last1 - first1);
+    const size_t chunks = detail::chunk_count(cs, n);
+    auto body = [&](size_t c) {
+        const size_t b = detail::chunk_begin(n, chunks, c);
+        const size_t e = detail::chunk_begin(n, chunks, c + 1);
+        std::transform(first1 + b, first1 + e, first2 + b, d_first + b, std::ref(op));
+    };
+    detail::fork_join(cs, chunks, body);
+    return d_first + n;
+}
+
+// init combined with every element by an associative op, in unspecified
+// grouping; chunk results are combined in order
+template <std::random_access_iterator It, typename T, typename Op = std::plus<>>
+T reduce(const ClientScheduler& cs, It first, It last, T init, Op op = {}) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t chunks = detail::chunk_count(cs, n);
+    std::vector<std::optional<T>> partial(chunks);
+    auto body = [&](size_t c) {
+        It it = first + detail::chunk_begin(n, chunks, c);
+        const It end = first + detail::chunk_begin(n, chunks, c + 1);
+        if (it == end) return;
+        T acc = *it;
+        for (++it; it != end; ++it) acc = op(std::move(acc), *it);
+        partial[c].emplace(std::move(acc));
+    };
+    detail::fork_join(cs, chunks, body);
+    for (auto& p : partial) {
+        if (p) init = op(std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+// d_first[i] = first[0] op ... op first[i]; d_first may equal first. Two
+// passes: each chunk scans itself, then every chunk but the first is offset
+// by the total of the chunks before it.
+template <std::random_access_iterator It, std::random_access_iterator Out,
+          typename Op = std::plus<>>
+Out inclusive_scan(const ClientScheduler& cs, It first, It last, Out d_first, Op op = {}) {
+    using T = typename std::iterator_traits<It>::value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t chunks = detail::chunk_count(cs, n);
+    auto scan = [&](size_t c) {
+        const size_t b = detail::chunk_begin(n, chunks, c);
+        const size_t e = detail::chunk_begin(n, chunks, c + 1);
+        std::inclusive_scan(first + b, first + e, d_first + b, std::ref(op));
+    };
+    detail::fork_join(cs, chunks, scan);
+    if (chunks <= 1) return d_first + n;
+
+    // carry[c]: total of chunks [0, c)
+    std::vector<std::optional<T>> carry(chunks);
+    for (size_t c = 1; c < chunks; ++c) {
+        const size_t e = detail::chunk_begin(n, chunks, c);
+        if (e == detail::chunk_begin(n, chunks, c - 1)) {
+            carry[c] = carry[c - 1];
+        } else {
+            const T& last_of_prev = d_first[e - 1];
+            carry[c].emplace(carry[c - 1] ? op(*carry[c - 1], last_of_prev) : last_of_prev);
+        }
+    }
+    auto offset = [&](size_t c) {
+        if (c == 0 || !carry[c]) return;
+        const Out end = d_first + detail::chunk_begin(n, chunks, c + 1);
+        for (Out it = d_first + detail::chunk_begin(n, chunks, c); it != end; ++it)
+            *it = op(*carry[c], std::move(*it));
+    };
+    detail::fork_join(cs, chunks, offset);
+    return d_first + n;
+}
+
+// Sorts [first, last) by comp (not stable): sorts up to bulk_chunks() runs in
+// parallel, then merges them pairwise, each merge split by merge path so that
+// every round stays parallel. The value type must be default constructible
+// and movable; one buffer of the range's size is allocated.
+template <std::random_access_iterator It, typename Comp = std::less<>>
+void sort(const ClientScheduler& cs, It first, It last, Comp comp = {}) {
+    using T = typename std::iterator_traits<It>::value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t runs = std::min(cs.bulk_chunks(), n / detail::min_sort_run);
+    if (runs <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds(runs + 1);
+    for (size_t r = 0; r <= runs; ++r) bounds[r] = detail::chunk_begin(n, runs, r);
+    auto sort_run = [&](size_t r) { std::sort(first + bounds[r], first + bounds[r + 1], comp); };
+    detail::fork_join(cs, runs, sort_run);
+
+    std::vector<T> buffer(n);
+    bool in_buffer = false;
+    while (bounds.size() > 2) {
+        if (in_buffer) detail::merge_round(cs, buffer.begin(), first, bounds, runs, comp);
+        else detail::merge_round(cs, first, buffer.begin(), bounds, runs, comp);
+        in_buffer = !in_buffer;
+        std::vector<size_t> merged;
+        for (size_t k = 0; k < bounds.size(); k += 2) merged.push_back(bounds[k]);
+        if (merged.back() != n) merged.push_back(n);
+        bounds = std::move(merged);
+    }
+    if (in_buffer) {
+        auto back = [&](size_t c) {
+            const size_t b = detail::chunk_begin(n, runs, c);
+            const size_t e = detail::chunk_begin(n, runs, c + 1);
+            std::move(buffer.begin() + b, buffer.begin() + e, first + b);
+        };
+        detail::fork_join(cs, runs, back);
+    }
+}
+
+} // namespace job_system::par
@@ -1,22 +1,29 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "job_system/client_registry.h"
 #include "job_system/client_state.h"
+#include "job_system/clock.h"
+#include "job_system/completion_queue.h"
+#include "job_system/event_log.h"
 #include "job_system/job.h"
 #include "job_system/metrics_observer.h"
 #include "job_system/scheduling_policy.h"
+#include "job_system/trace_recorder.h"
 
 namespace job_system {
 
@@ -25,6 +32,9 @@ class QueueFullException : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+class ClientScheduler; // execution.h
+class SubmitBuffer;    // submit_buffer.h
+
 class Scheduler {
 public:
     struct ClientMetrics {
@@ -35,12 +45,25 @@ public:
         size_t   weight{1};
         uint64_t overflow_count{0};
         uint64_t expired_count{0};
+        // BLOCK strategy: submits that found the queue full, those made from
+        // inside one of this Scheduler's tasks (a worker stalled on its own
+        // pool), those where that task outranked the lowest-priority job it
+        // waited behind, and total time spent waiting. helped_jobs: queued
+        // jobs run inline by a submitter (CALLER_RUNS, set_help_while_blocked)
+        uint64_t blocked_submits{0};
+        uint64_t blocked_in_task{0};
+        uint64_t priority_inversions{0};
+        uint64_t blocked_time_us{0};
+        uint64_t helped_jobs{0};
     };
 
     struct GlobalMetrics {
         uint64_t total_processed{0};
         size_t   active_clients{0};
         double   jain_fairness_index{1.0}; // [1/n, 1.0]; 1.0 = perfectly fair
+        // Tasks currently asleep in a BLOCK submit; equal to the worker count
+        // means the pool is deadlocked
+        size_t   tasks_blocked_in_submit{0};
     };
 
     // Default constructor — uses WeightedRoundRobinPolicy
@@ -49,6 +72,10 @@ public:
     // Policy constructor — caller supplies any ISchedulingPolicy
     explicit Scheduler(std::unique_ptr<ISchedulingPolicy> policy);
 
+    // Policy + clock: every enqueue timestamp, deadline check and measured
+    // execution time uses `clock` (e.g. a ManualClock for deterministic runs)
+    Scheduler(std::unique_ptr<ISchedulingPolicy> policy, std::shared_ptr<IClock> clock);
+
     ~Scheduler();
 
     // Client management
@@ -57,14 +84,67 @@ public:
                          size_t max_queue_depth = 0,
                          OverflowStrategy strategy = OverflowStrategy::REJECT);
 
-    // Job submission — called by client threads
-    void submit(const std::string& client_id, std::function<void()> task,
+    // Job submission — called by client threads. Lambdas of up to three
+    // captured words are stored inline in the job (see Task). Throws only if
+    // the job was not admitted; an exception from a task the caller runs
+    // inline (CALLER_RUNS, help-while-blocked) goes to on_job_failed().
+    void submit(const std::string& client_id, Task task,
                 uint32_t cost_hint = 1,
                 Priority priority = Priority::NORMAL,
                 std::chrono::steady_clock::time_point deadline = {});
 
-    // Job selection — called by worker threads
-    // Returns nullopt if no jobs available (caller should wait on CV)
+    // Submits a closure-free job: `handler` is later called with a copy of
+    // `payload`, stored inline in the job (no allocation, no type erasure).
+    // A deadline more than ~35 minutes after submission is treated as none.
+    // Throws std::invalid_argument if payload exceeds Job::RAW_PAYLOAD_BYTES.
+    void submit_raw(const std::string& client_id, Job::RawHandler handler,
+                    std::span<const std::byte> payload, uint32_t cost_hint = 1,
+                    Priority priority = Priority::NORMAL,
+                    std::chrono::steady_clock::time_point deadline = {});
+
+    // submit_raw() with the bytes of `payload`; the handler reads it back
+    // with load_payload<T>()
+    template <RawPayload T>
+    void submit_raw(const std::string& client_id, Job::RawHandler handler, const T& payload,
+                    uint32_t cost_hint = 1, Priority priority = Priority::NORMAL,
+                    std::chrono::steady_clock::time_point deadline = {}) {
+        submit_raw(client_id, handler, std::as_bytes(std::span(&payload, 1)), cost_hint,
+                   priority, deadline);
+    }
+
+    // Submits a job whose outcome (completed, failed, expired, cancelled or
+    // dropped) is posted to `cq` tagged with `user_tag`. An exception from the
+    // task is reported as FAILED instead of propagating. Throws
+    // QueueFullException if `cq` has capacity() jobs outstanding.
+    void submit(CompletionQueue& cq, uint64_t user_tag, const std::string& client_id,
+                Task task, uint32_t cost_hint = 1,
+                Priority priority = Priority::NORMAL,
+                std::chrono::steady_clock::time_point deadline = {});
+
+    // Submits only if the client's queue has room: whatever its overflow
+    // strategy, never blocks, evicts a queued job or runs one inline.
+    // Returns false, dropping `task` unrun, if the queue is full. Throws
+    // std::runtime_error if client unknown.
+    bool try_submit(const std::string& client_id, Task task, uint32_t cost_hint = 1,
+                    Priority priority = Priority::NORMAL);
+
+    // Submits a pre-built job: task (or raw handler and payload), cost_hint,
+    // priority and completion queue are taken from `job`; id, client handle,
+    // timestamps and lineage are assigned here
+    void submit(const std::string& client_id, Job job,
+                std::chrono::steady_clock::time_point deadline = {});
+
+    // Sender/receiver view of one client at a fixed priority (execution.h).
+    // Throws std::runtime_error if client unknown.
+    ClientScheduler get_scheduler(const std::string& client_id,
+                                  Priority priority = Priority::NORMAL);
+
+    // Job selection — called by worker threads. Moves the next job into
+    // `out` (one move from its queue) and returns true, or returns false if
+    // no jobs are available (caller should wait on CV).
+    bool select_next_job(Job& out);
+
+    // select_next_job() into a fresh Job; nullopt if none available
     std::optional<Job> select_next_job();
 
     // Cancellation
@@ -80,7 +160,8 @@ public:
 
     // Drains pending jobs, removes client, notifies policy.
     // Returns the number of jobs that were still pending.
-    // Throws std::runtime_error if client_id unknown.
+    // Throws std::runtime_error if client_id unknown. A BLOCK submit asleep
+    // on the client wakes up and throws as for an unknown client.
     uint64_t unregister_client(const std::string& client_id);
 
     // Metrics
@@ -94,11 +175,57 @@ public:
     // Thread-safe: can be called at any time
     void set_observer(std::shared_ptr<IMetricsObserver> observer);
 
+    // Optional arrival/execution trace for offline replay, timestamped with
+    // the scheduler's clock; nullptr disables. Thread-safe: can be called at
+    // any time.
+    void set_trace_recorder(std::shared_ptr<TraceRecorder> recorder);
+
+    // Optional binary log of every job lifecycle transition, timestamped with
+    // the scheduler's clock; nullptr disables. Thread-safe: can be called at
+    // any time.
+    void set_event_log(std::shared_ptr<EventLog> log);
+
+    // When a submit finds a BLOCK client full, dequeue and run that client's
+    // next job on the calling thread (its slot takes the new job) instead of
+    // sleeping, as CALLER_RUNS does. Turns producer wait time into
+    // throughput and keeps a pool from deadlocking on its own queues. The
+    // run is charged to the client through
+    // ISchedulingPolicy::on_job_run_inline(), and an exception from it is
+    // reported through on_job_failed() instead of escaping submit(). Off by
+    // default. Thread-safe.
+    void set_help_while_blocked(bool enabled);
+
+    // Callback invoked after every successful enqueue. ThreadPool installs one
+    // to wake idle workers; only one notifier is active at a time.
+    using WorkNotifier = std::shared_ptr<std::function<void()>>;
+    void set_work_notifier(WorkNotifier notifier);
+    // Removes `notifier` only if it is still the installed one
+    void clear_work_notifier(const WorkNotifier& notifier);
+
     // Record that a job finished executing (called by workers)
     void record_execution(const std::string& client_id,
                           uint64_t job_id,
                           std::chrono::microseconds duration);
 
+    // Runs a job returned by select_next_job() on the calling thread, timed
+    // with the scheduler's clock, then calls record_execution(). Shared by
+    // ThreadPool workers and ManualExecutor so both paths behave identically.
+    // Leaves `job` empty, ready for the next select_next_job(). An exception
+    // from the task propagates unless the job has a completion queue.
+    void execute(Job& job);
+
+    const IClock& clock() const { return *clock_; }
+
+    // A queued or dequeued job's enqueue time and deadline on clock()
+    // (time_point{} = no deadline), from its 32-bit relative fields
+    std::chrono::steady_clock::time_point enqueue_time(const Job& job) const;
+    std::chrono::steady_clock::time_point deadline(const Job& job) const;
+
+    // Id of the job this Scheduler is executing on the calling thread, or 0
+    // when called from outside one of its tasks. Jobs submitted while it is
+    // non-zero record it as their parent_id if an event log is attached.
+    uint64_t current_job_id() const;
+
     // State
     bool has_pending_jobs() const;
 
@@ -107,16 +234,90 @@ public:
     Scheduler& operator=(const Scheduler&) = delete;
 
 private:
+    friend class SubmitBuffer;
+
     mutable std::shared_mutex registry_mutex_;
-    std::unordered_map<std::string, std::shared_ptr<ClientState>> clients_;
-    std::vector<std::string> client_order_; // stable iteration order
+    ClientRegistry registry_; // guarded by registry_mutex_
+    // Shared by BLOCK clients (registry slot mod size) instead of one per
+    // client; waiters re-check their own queue, so sharing only costs
+    // spurious wakeups
+    std::array<std::condition_variable_any, 16> space_cvs_;
 
     mutable std::mutex rr_mutex_; // protects policy state
     std::unique_ptr<ISchedulingPolicy> policy_;
+    std::shared_ptr<IClock> clock_; // never null; const after construction
+    std::chrono::steady_clock::time_point epoch_; // time base of Job timestamps
 
     std::atomic<uint64_t> next_job_id_{1};
     std::atomic<uint64_t> total_processed_{0};
     std::atomic<std::shared_ptr<IMetricsObserver>> observer_{nullptr};
+    std::atomic<WorkNotifier> work_notifier_{nullptr};
+    std::atomic<std::shared_ptr<TraceRecorder>> trace_{nullptr};
+    std::atomic<std::shared_ptr<EventLog>> event_log_{nullptr};
+    std::atomic<bool> help_while_blocked_{false};
+    std::atomic<size_t> tasks_blocked_{0};
+
+    // Registered client a job belongs to, or null
+    std::shared_ptr<ClientState> client_at(ClientHandle handle) const;
+
+    // `t` in Job timestamp units: microseconds since epoch_, mod 2^32
+    uint32_t to_ticks(std::chrono::steady_clock::time_point t) const;
+
+    // Sets a job's enqueue time to now and its deadline relative to it
+    void stamp(Job& job, std::chrono::steady_clock::time_point deadline) const;
+
+    // Sets parent_id and root_id of a job with an assigned id from the task
+    // the calling thread is running, if any, and fires the spawn probe. The
+    // lineage is stored (allocating the job's extras) only while an event
+    // log is attached or the job has extras anyway.
+    void assign_lineage(Job& job) const;
+
+    // First of `count` consecutive job ids, reserved for a SubmitBuffer
+    uint64_t reserve_job_ids(uint64_t count);
+
+    // Records a job's arrival (trace) and spawn (event log). Caller must hold
+    // registry_mutex_.
+    void announce(const ClientState& client, const Job& job);
+
+    // Admits a stamped job with an assigned id and lineage to `client`,
+    // applying its overflow strategy. `registry_lock` must be held on entry;
+    // it is released before callbacks run and across a BLOCK wait. Returns
+    // false if the client was unregistered while its submitter waited, or,
+    // with `only_if_room`, if the queue was full (refused as by REJECT, but
+    // not counted as an overflow). Throws only before admitting the job,
+    // leaving `job` intact; a task run inline reports its failure instead
+    // (see execute(Job&, bool)).
+    bool enqueue(std::shared_lock<std::shared_mutex>& registry_lock,
+                 const std::shared_ptr<ClientState>& client, Job& job,
+                 bool announced = false, bool only_if_room = false);
+
+    // Admits a SubmitBuffer's jobs for one client: spliced under one client
+    // lock when they all fit, otherwise enqueued one by one. Jobs that are
+    // refused (unknown client, REJECT, full completion queue) are discarded
+    // as DROPPED and counted in `refused`. Empties `jobs`; if enqueueing
+    // throws anything else, rethrows the first such exception after
+    // admitting the rest.
+    void submit_batch(const std::string& client_id, std::vector<Job>& jobs,
+                      uint64_t& refused);
+
+    // Counts, logs and reports a job of `client` discarded past its deadline
+    void on_expired(const Job& job, ClientState& client);
+
+    void record_execution(ClientState& client, uint64_t job_id,
+                          std::chrono::microseconds duration);
+
+    // execute(); with `contain_failure` an exception from the task is
+    // reported (on_job_failed(), FAILED completion) instead of propagating
+    void execute(Job& job, bool contain_failure);
+
+    // Logs a CANCEL for every job still queued on `client` and empties its
+    // queues, moving jobs that want a discard notice to `hooked`. Returns the
+    // number discarded. Caller must hold registry_mutex_ and client.mutex.
+    uint64_t discard_queued(ClientState& client, std::vector<Job>& hooked);
+
+    // Posts a discarded job's completion and runs its on_discard hook. Call
+    // outside scheduler locks.
+    void discard(Job& job, CompletionStatus status);
 };
 
 } // namespace job_system
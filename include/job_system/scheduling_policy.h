@@ -1,41 +1,44 @@
 #pragma once
 
 #include <chrono>
-#include <memory>
-#include <optional>
+#include <cstddef>
 #include <string>
-#include <unordered_map>
-#include <vector>
 
-#include "job_system/client_state.h"
+#include "job_system/client_registry.h"
 #include "job_system/job.h"
 
 namespace job_system {
 
-using ClientMap = std::unordered_map<std::string, std::shared_ptr<ClientState>>;
-
+// Policies keep per-client state in their own columns indexed by registry
+// slot. A slot freed by on_client_unregistered() may be handed to a new
+// client by a later on_client_registered().
 class ISchedulingPolicy {
 public:
     virtual ~ISchedulingPolicy() = default;
 
-    // Called under registry write lock when a client is registered
-    virtual void on_client_registered(const std::string& client_id,
-                                      size_t weight) = 0;
+    // Called under registry write lock when a client is registered in `slot`
+    virtual void on_client_registered(size_t slot, size_t weight) = 0;
 
-    // Called while Scheduler holds rr_mutex_; policy's internal state is
-    // protected by that same lock — no additional synchronization needed
-    virtual std::optional<Job> select_next_job(
-        const std::vector<std::string>& client_order,
-        const ClientMap& clients) = 0;
+    // Called while Scheduler holds rr_mutex_ and the registry read lock;
+    // policy's internal state is protected by rr_mutex_ — no additional
+    // synchronization needed. Walks the registry's columns and dequeues the
+    // chosen client's job straight into `out` (the caller's slot) with
+    // ClientRegistry::dequeue(), returning true, or returns false if every
+    // client is empty.
+    virtual bool select_next_job(const ClientRegistry& clients, Job& out) = 0;
 
     // Default no-op — override for time-aware policies
     virtual void on_job_executed(const std::string& /*client_id*/,
                                  std::chrono::microseconds /*duration*/) {}
 
-    virtual void on_client_weight_updated(const std::string& /*client_id*/,
-                                           size_t /*new_weight*/) {}
+    // Called under rr_mutex_ when a job of the client in `slot` was dequeued
+    // and run by its submitter (CALLER_RUNS, help-while-blocked) rather than
+    // picked by select_next_job(); charge it against the client's share
+    virtual void on_job_run_inline(size_t /*slot*/, const Job& /*job*/) {}
+
+    virtual void on_client_weight_updated(size_t /*slot*/, size_t /*new_weight*/) {}
 
-    virtual void on_client_unregistered(const std::string& /*client_id*/) {}
+    virtual void on_client_unregistered(size_t /*slot*/) {}
 };
 
 } // namespace job_system
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "job_system/event_log.h"
+
+namespace job_system {
+
+// One hop of a spawn tree's critical path. For every step but the last,
+// run_ns is the time the job had been running when it spawned the next step;
+// for the last it is the job's full run time. Summed over the path,
+// queue_ns + run_ns equals the tree's end-to-end latency.
+struct CriticalPathStep {
+    uint64_t job_id{0};
+    uint32_t client{0}; // EventLogReader::clients() index
+    uint64_t queue_ns{0};
+    uint64_t run_ns{0};
+};
+
+struct SpawnTree {
+    uint64_t root_id{0};
+    uint64_t submit_ns{0}; // root's SUBMIT
+    uint64_t end_ns{0};    // latest COMPLETE in the tree
+    size_t   size{0};      // jobs in the tree, root included
+    size_t   depth{0};     // longest root → leaf chain, in hops
+    size_t   max_fanout{0};
+    std::vector<CriticalPathStep> critical_path; // root first
+
+    uint64_t latency_ns() const { return end_ns - submit_ns; }
+    uint64_t path_queue_ns() const;
+    uint64_t path_run_ns() const;
+};
+
+// Reconstructs spawn trees (jobs submitted from inside running tasks, see
+// Job::parent_id) from EventLog events and finds the chain that determined
+// each tree's end-to-end latency: the ancestors of the job that completed
+// last. Events may arrive in any order.
+//
+// Keeps ~100 bytes per job until trees() is called, so on very large logs
+// feed it only the span of interest.
+class SpawnTreeAnalyzer {
+public:
+    void add(const LogEvent& ev);
+
+    // Trees with at least `min_size` jobs whose root was submitted and at
+    // least one job completed, slowest first. A parent that never appeared
+    // in the log (logging started mid-run) ends the chain.
+    std::vector<SpawnTree> trees(size_t min_size = 2) const;
+
+    // Number of children of every job that spawned at least one
+    std::vector<uint32_t> fanouts() const;
+
+private:
+    struct Node {
+        uint64_t parent{0};
+        uint64_t spawn_ns{0};
+        uint64_t submit_ns{0};
+        uint64_t start_ns{0};
+        uint64_t complete_ns{0};
+        uint32_t client{0};
+        uint32_t children{0};
+    };
+
+    std::unordered_map<uint64_t, Node> nodes_;
+};
+
+} // namespace job_system
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "job_system/scheduler.h"
+
+namespace job_system {
+
+struct SubmitBufferOptions {
+    // Buffered jobs (all clients) that trigger a flush from submit()
+    size_t max_jobs{256};
+    // Longest a job waits in the buffer before a background flush; 0 = no
+    // timer (flush only when full, on flush() or on destruction)
+    std::chrono::microseconds max_delay{0};
+    // Job ids reserved from the scheduler at a time
+    uint64_t id_block{1024};
+};
+
+// Per-producer front end to Scheduler::submit for high submission rates.
+// Job ids come from blocks reserved once per id_block jobs, and jobs are
+// collected per client and admitted in one client-lock acquisition per
+// client and flush instead of one per job. The price is latency: a job is
+// invisible to workers (and cannot be cancelled) until its flush, which
+// happens when max_jobs are buffered, max_delay after the oldest buffered
+// job was submitted, on flush(), or on destruction.
+//
+// Lineage and the enqueue time are taken at submit(), so jobs spawned inside
+// a task still carry its parent_id and time in the buffer counts as queue
+// wait (and towards deadlines). A buffer is meant for one producer thread; the
+// internal lock only serializes it with the timer. Unless the batch fits
+// within the client's max_queue_depth, its jobs are admitted one by one with
+// the client's overflow strategy, which may block or run a task inline on
+// the flushing thread (the timer's, with max_delay). Jobs refused at flush
+// time (unknown client, REJECT, full completion queue) are discarded as
+// DROPPED and counted in refused(), since no exception can reach their
+// producer. The scheduler must outlive the buffer.
+class SubmitBuffer {
+public:
+    explicit SubmitBuffer(Scheduler& scheduler);
+    // Throws std::invalid_argument if max_jobs or id_block is 0
+    SubmitBuffer(Scheduler& scheduler, SubmitBufferOptions options);
+    // Flushes, then stops the timer
+    ~SubmitBuffer();
+
+    SubmitBuffer(const SubmitBuffer&) = delete;
+    SubmitBuffer& operator=(const SubmitBuffer&) = delete;
+
+    // Buffers a job and returns its id. Rethrows an exception left by an
+    // earlier flush on the timer thread.
+    uint64_t submit(const std::string& client_id, Task task, uint32_t cost_hint = 1,
+                    Priority priority = Priority::NORMAL,
+                    std::chrono::steady_clock::time_point deadline = {});
+
+    // Buffers a closure-free job (see Scheduler::submit_raw)
+    uint64_t submit_raw(const std::string& client_id, Job::RawHandler handler,
+                        std::span<const std::byte> payload, uint32_t cost_hint = 1,
+                        Priority priority = Priority::NORMAL,
+                        std::chrono::steady_clock::time_point deadline = {});
+
+    template <RawPayload T>
+    uint64_t submit_raw(const std::string& client_id, Job::RawHandler handler,
+                        const T& payload, uint32_t cost_hint = 1,
+                        Priority priority = Priority::NORMAL,
+                        std::chrono::steady_clock::time_point deadline = {}) {
+        return submit_raw(client_id, handler, std::as_bytes(std::span(&payload, 1)),
+                          cost_hint, priority, deadline);
+    }
+
+    // Buffers a pre-built job (fields as for Scheduler::submit(client_id, Job))
+    uint64_t submit(const std::string& client_id, Job job,
+                    std::chrono::steady_clock::time_point deadline = {});
+
+    // Admits everything buffered; returns the number of jobs flushed. May
+    // throw like submit().
+    size_t flush();
+
+    size_t pending() const;
+    uint64_t flushes() const { return flushes_.load(std::memory_order_relaxed); }
+    uint64_t refused() const { return refused_.load(std::memory_order_relaxed); }
+
+private:
+    struct Batch {
+        std::string client_id;
+        std::vector<Job> jobs;
+    };
+
+    // Moves the buffered jobs out under mutex_, then admits them under
+    // flush_mutex_ so that concurrent flushes keep per-client order
+    size_t flush_from(std::unique_lock<std::mutex>& lock);
+    void timer_loop(std::stop_token stop_token);
+    void rethrow_deferred();
+
+    Scheduler& scheduler_;
+    const SubmitBufferOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any timer_cv_;
+    std::vector<Batch> batches_;   // one per client seen, reused across flushes
+    size_t last_batch_{0};         // batch of the previous submit
+    size_t pending_{0};
+    std::chrono::steady_clock::time_point oldest_; // submit time of the first pending job
+    uint64_t next_id_{0};
+    uint64_t id_end_{0};
+    std::exception_ptr deferred_error_; // from a timer flush
+
+    std::mutex flush_mutex_;
+    std::atomic<uint64_t> flushes_{0};
+    std::atomic<uint64_t> refused_{0};
+
+    std::jthread timer_; // last: stopped before the members it uses
+};
+
+} // namespace job_system
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace job_system {
+
+namespace detail {
+
+// Per-type operations of a Task, one static table per stored callable type.
+// Null entries mean "nothing to do" (relocate: copy the bytes).
+struct TaskOps {
+    void (*invoke)(std::byte* storage);
+    void (*relocate)(std::byte* dst, std::byte* src);
+    void (*destroy)(std::byte* storage);
+    void (*discard)(std::byte* storage);
+};
+
+template <typename F>
+struct is_std_function : std::false_type {};
+template <typename Sig>
+struct is_std_function<std::function<Sig>> : std::true_type {};
+
+} // namespace detail
+
+// Move-only, type-erased job body in 32 bytes: a pointer to a static table of
+// operations and 24 bytes of inline storage. Callables up to 24 bytes (three
+// captured words) with a non-throwing move are stored inline; larger ones are
+// boxed on the heap, as std::function does above 16 bytes.
+//
+// A raw task (Task::raw) stores a plain function pointer and up to
+// RAW_PAYLOAD_BYTES of payload in the same storage, with no type erasure.
+//
+// A callable with an `on_discard()` member has it called instead of its body
+// when the scheduler discards the job (DROP_*, deadline expiry, cancel_job,
+// drain / unregister), outside scheduler locks. Adapters use it to complete
+// whoever waits on the task.
+class Task {
+public:
+    using RawHandler = void (*)(const std::byte* payload);
+    static constexpr size_t INLINE_BYTES = 24;
+    static constexpr size_t RAW_PAYLOAD_BYTES = INLINE_BYTES - sizeof(RawHandler);
+
+    // Whether F is stored without allocating
+    template <typename F>
+    static constexpr bool stored_inline = sizeof(F) <= INLINE_BYTES && alignof(F) <= 8 &&
+                                          std::is_nothrow_move_constructible_v<F>;
+
+    Task() noexcept = default;
+    Task(std::nullptr_t) noexcept {}
+
+    // An empty std::function or null function pointer gives an empty Task
+    template <typename F>
+        requires(!std::is_same_v<std::decay_t<F>, Task> &&
+                 std::is_invocable_r_v<void, std::decay_t<F>&>)
+    Task(F&& f) {
+        using Fn = std::decay_t<F>;
+        // A function name (not a pointer) can never be null
+        if constexpr ((std::is_pointer_v<Fn> && !std::is_function_v<std::remove_reference_t<F>>) ||
+                      detail::is_std_function<Fn>::value) {
+            if (!f) return;
+        }
+        if constexpr (stored_inline<Fn>) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f));
+            ops_ = &inline_ops<Fn>;
+        } else {
+            Fn* boxed = new Fn(std::forward<F>(f));
+            std::memcpy(storage_, &boxed, sizeof(boxed));
+            ops_ = &boxed_ops<Fn>;
+        }
+    }
+
+    // Closure-free task: `handler` is later called with a copy of `payload`,
+    // zero-padded to RAW_PAYLOAD_BYTES. A null handler gives an empty Task.
+    // Throws std::invalid_argument if the payload exceeds RAW_PAYLOAD_BYTES.
+    static Task raw(RawHandler handler, std::span<const std::byte> payload) {
+        if (payload.size() > RAW_PAYLOAD_BYTES) {
+            throw std::invalid_argument("Raw job payload exceeds " +
+                                        std::to_string(RAW_PAYLOAD_BYTES) + " bytes");
+        }
+        Task task;
+        if (!handler) return task;
+        std::memset(task.storage_, 0, INLINE_BYTES);
+        std::memcpy(task.storage_, &handler, sizeof(handler));
+        if (!payload.empty()) {
+            std::memcpy(task.storage_ + sizeof(handler), payload.data(), payload.size());
+        }
+        task.ops_ = &raw_ops;
+        return task;
+    }
+
+    Task(Task&& other) noexcept : ops_(other.ops_) { take(other); }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ops_ = other.ops_;
+            take(other);
+        }
+        return *this;
+    }
+
+    Task& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    // Runs the body. Precondition: non-empty.
+    void operator()() { ops_->invoke(storage_); }
+
+    bool is_raw() const noexcept { return ops_ == &raw_ops; }
+    bool has_discard_hook() const noexcept { return ops_ && ops_->discard; }
+
+    // Calls the callable's on_discard() member, if it has one
+    void discard() {
+        if (has_discard_hook()) ops_->discard(storage_);
+    }
+
+private:
+    template <typename F>
+    static F& as(std::byte* storage) {
+        return *std::launder(reinterpret_cast<F*>(storage));
+    }
+
+    template <typename F>
+    static F* boxed(std::byte* storage) {
+        F* ptr;
+        std::memcpy(&ptr, storage, sizeof(ptr));
+        return ptr;
+    }
+
+    template <typename F>
+    static constexpr bool has_discard_member = requires(F& f) { f.on_discard(); };
+
+    template <typename F>
+    static constexpr auto inline_discard() -> void (*)(std::byte*) {
+        if constexpr (has_discard_member<F>) {
+            return [](std::byte* s) { as<F>(s).on_discard(); };
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <typename F>
+    static constexpr auto boxed_discard() -> void (*)(std::byte*) {
+        if constexpr (has_discard_member<F>) {
+            return [](std::byte* s) { boxed<F>(s)->on_discard(); };
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <typename F>
+    static constexpr auto inline_relocate() -> void (*)(std::byte*, std::byte*) {
+        if constexpr (std::is_trivially_copyable_v<F>) {
+            return nullptr;
+        } else {
+            return [](std::byte* dst, std::byte* src) {
+                ::new (static_cast<void*>(dst)) F(std::move(as<F>(src)));
+                as<F>(src).~F();
+            };
+        }
+    }
+
+    template <typename F>
+    static constexpr auto inline_destroy() -> void (*)(std::byte*) {
+        if constexpr (std::is_trivially_destructible_v<F>) {
+            return nullptr;
+        } else {
+            return [](std::byte* s) { as<F>(s).~F(); };
+        }
+    }
+
+    template <typename F>
+    static constexpr detail::TaskOps inline_ops{
+        [](std::byte* s) { as<F>(s)(); },
+        inline_relocate<F>(),
+        inline_destroy<F>(),
+        inline_discard<F>(),
+    };
+
+    template <typename F>
+    static constexpr detail::TaskOps boxed_ops{
+        [](std::byte* s) { (*boxed<F>(s))(); },
+        nullptr, // the pointer moves with the bytes
+        [](std::byte* s) { delete boxed<F>(s); },
+        boxed_discard<F>(),
+    };
+
+    static constexpr detail::TaskOps raw_ops{
+        [](std::byte* s) {
+            RawHandler handler;
+            std::memcpy(&handler, s, sizeof(handler));
+            handler(s + sizeof(handler));
+        },
+        nullptr, nullptr, nullptr,
+    };
+
+    // Moves other's callable here; ops_ already holds other's table
+    void take(Task& other) noexcept {
+        if (!ops_) return;
+        if (ops_->relocate) {
+            ops_->relocate(storage_, other.storage_);
+        } else {
+            std::memcpy(storage_, other.storage_, INLINE_BYTES);
+        }
+        other.ops_ = nullptr;
+    }
+
+    void reset() noexcept {
+        if (ops_ && ops_->destroy) ops_->destroy(storage_);
+        ops_ = nullptr;
+    }
+
+    const detail::TaskOps* ops_{nullptr};
+    alignas(8) std::byte storage_[INLINE_BYTES];
+};
+
+static_assert(sizeof(Task) == 32, "Task must stay half a cache line");
+
+} // namespace job_system
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -13,9 +16,29 @@ namespace job_system {
 
 enum class ShutdownMode { GRACEFUL, IMMEDIATE };
 
+// What a worker does when select_next_job() comes back empty
+enum class IdleStrategy {
+    BLOCK,           // park on the condition variable straight away (default)
+    SPIN_THEN_BLOCK, // poll for new work for spin_duration, then park
+    YIELD            // never park; yield between polls (lowest latency, burns a core)
+};
+
+struct ThreadPoolOptions {
+    IdleStrategy idle_strategy{IdleStrategy::BLOCK};
+    std::chrono::microseconds spin_duration{50}; // SPIN_THEN_BLOCK only
+
+    // Worker i is pinned to cpu_affinity[i % size()]; empty = no pinning.
+    // Linux only — ignored on other platforms.
+    std::vector<int> cpu_affinity;
+};
+
 class ThreadPool {
 public:
     explicit ThreadPool(Scheduler& scheduler, size_t worker_count);
+
+    // Throws std::invalid_argument if cpu_affinity names a CPU this process
+    // is not allowed to run on
+    ThreadPool(Scheduler& scheduler, size_t worker_count, ThreadPoolOptions options);
     ~ThreadPool();
 
     // Graceful shutdown: drain all queues, then stop workers.
@@ -33,16 +56,31 @@ public:
     ThreadPool& operator=(const ThreadPool&) = delete;
 
 private:
-    void worker_loop(std::stop_token stop_token);
+    // Idle-worker parking state. Shared with the Scheduler's work notifier so
+    // that a submit racing with pool teardown never touches a dead pool.
+    struct WakeState {
+        std::mutex cv_mutex;
+        std::condition_variable_any cv;
+        std::atomic<uint64_t> epoch{0};    // bumped on every enqueue
+        std::atomic<size_t>   sleepers{0}; // workers parked on cv
+
+        void notify_one();
+    };
+
+    void worker_loop(std::stop_token stop_token, size_t index);
+    // Polls the wake epoch until it moves past `seen_epoch` or the idle budget
+    // of the configured strategy runs out. Returns true if new work arrived.
+    bool idle_poll(const std::stop_token& stop_token, uint64_t seen_epoch) const;
 
     Scheduler& scheduler_;
+    const ThreadPoolOptions options_;
     std::vector<std::jthread> workers_;
 
     std::atomic<bool> running_{true};
     std::atomic<bool> draining_{false}; // shutdown requested, drain remaining
 
-    std::mutex cv_mutex_;
-    std::condition_variable_any cv_;
+    std::shared_ptr<WakeState> wake_;
+    Scheduler::WorkNotifier notifier_;
 };
 
 } // namespace job_system
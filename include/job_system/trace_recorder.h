@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "job_system/client_state.h"
+#include "job_system/job.h"
+
+namespace job_system {
+
+// Compact binary trace of job arrivals and measured execution times, for
+// replaying production traffic shapes against other policies / pool sizes.
+//
+// File layout: 8-byte magic "JSTRACE1" followed by tagged records whose
+// fields are LEB128 varints. Timestamps are nanosecond deltas from the
+// previous record on the recording Scheduler's clock, so a trace taken under
+// a ManualClock is deterministic (the first is relative to set_trace_recorder).
+//   'C' client   : index, weight, max_queue_depth, overflow, name_len, name
+//   'A' arrival  : dt_ns, client, job_id, cost_hint, priority, deadline
+//   'E' execution: dt_ns, client, job_id, duration_us
+// deadline is 0 for "none", otherwise zigzag(deadline − arrival in µs) + 1.
+class TraceRecorder {
+public:
+    // Throws std::runtime_error if the file cannot be opened
+    explicit TraceRecorder(const std::string& path);
+    ~TraceRecorder(); // flushes; a failure shows in records_lost()
+
+    // Called by Scheduler::set_trace_recorder: the time the trace starts at
+    void start(std::chrono::steady_clock::time_point now);
+
+    // Called by Scheduler::submit for every offered job (before admission),
+    // at `now` on the Scheduler's clock. `client` and `weight` are only read
+    // the first time its id is seen.
+    void record_arrival(const ClientState& client, size_t weight, uint64_t job_id,
+                        uint32_t cost_hint, Priority priority,
+                        std::chrono::steady_clock::time_point deadline,
+                        std::chrono::steady_clock::time_point now);
+
+    // Called by Scheduler::record_execution, at `now` on its clock
+    void record_execution(const std::string& client_id, uint64_t job_id,
+                          std::chrono::microseconds duration,
+                          std::chrono::steady_clock::time_point now);
+
+    // Throws std::runtime_error if any write since construction failed
+    // (recording never throws: it runs on the Scheduler's submit path)
+    void flush();
+    uint64_t records_written() const;
+    // Records not in the file because a write failed (e.g. a full disk);
+    // the file is valid up to the first failed write
+    uint64_t records_lost() const;
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+private:
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+    // Caller must hold mutex_
+    uint32_t client_index(const ClientState& client, size_t weight);
+    uint64_t take_delta_ns(std::chrono::steady_clock::time_point now);
+    void put_varint(uint64_t v);
+    void flush_locked();
+
+    mutable std::mutex mutex_;
+    const std::string path_;
+    std::FILE* file_{nullptr};
+    std::vector<uint8_t> buffer_;
+    std::unordered_map<std::string, uint32_t> client_index_;
+    std::chrono::steady_clock::time_point last_ts_;
+    bool started_{false};     // last_ts_ is set
+    uint64_t records_{0};
+    uint64_t pending_{0};     // records in buffer_
+    bool write_failed_{false};
+    uint64_t lost_{0};
+};
+
+struct TraceClient {
+    std::string name;
+    size_t weight{1};
+    size_t max_queue_depth{0};
+    OverflowStrategy overflow_strategy{OverflowStrategy::REJECT};
+};
+
+struct TraceEvent {
+    enum class Type : uint8_t { ARRIVAL, EXECUTION };
+    Type     type{Type::ARRIVAL};
+    uint64_t timestamp_ns{0}; // since trace start
+    uint32_t client{0};       // index into TraceReader::clients()
+    uint64_t job_id{0};
+    uint32_t cost_hint{1};
+    Priority priority{Priority::NORMAL};
+    bool     has_deadline{false};
+    int64_t  deadline_us{0};  // relative to arrival; may be negative
+    uint64_t duration_us{0};  // EXECUTION only
+};
+
+// Loads a whole trace written by TraceRecorder
+class TraceReader {
+public:
+    // Throws std::runtime_error on I/O error or malformed input
+    explicit TraceReader(const std::string& path);
+
+    const std::vector<TraceClient>& clients() const { return clients_; }
+    const std::vector<TraceEvent>& events() const { return events_; }
+
+private:
+    std::vector<TraceClient> clients_;
+    std::vector<TraceEvent> events_;
+};
+
+} // namespace job_system
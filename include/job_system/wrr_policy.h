@@ -1,8 +1,6 @@
 #pragma once
 
 #include <cstddef>
-#include <optional>
-#include <string>
 #include <vector>
 
 #include "job_system/scheduling_policy.h"
@@ -13,18 +11,20 @@ class WeightedRoundRobinPolicy : public ISchedulingPolicy {
 public:
     WeightedRoundRobinPolicy() = default;
 
-    void on_client_registered(const std::string& client_id,
-                               size_t weight) override;
+    void on_client_registered(size_t slot, size_t weight) override;
 
-    std::optional<Job> select_next_job(
-        const std::vector<std::string>& client_order,
-        const ClientMap& clients) override;
+    bool select_next_job(const ClientRegistry& clients, Job& out) override;
 
-    void on_client_unregistered(const std::string& client_id) override;
+    void on_job_run_inline(size_t slot, const Job& job) override;
+
+    void on_client_unregistered(size_t slot) override;
 
 private:
     size_t rr_index_{0};
     size_t rr_remaining_{0};
+    // Per slot: jobs run inline since the client's last turn; taken off its
+    // next quotas, leaving at least one job per turn (work-conserving)
+    std::vector<size_t> debt_;
 };
 
 } // namespace job_system
@@ -0,0 +1,115 @@
+#include "job_system/client_registry.h"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace job_system {
+
+uint32_t ClientRegistry::hash_of(std::string_view client_id) {
+    const size_t h = std::hash<std::string_view>{}(client_id);
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+size_t ClientRegistry::find(std::string_view client_id) const {
+    if (index_.empty()) return NO_SLOT;
+    const uint32_t hash = hash_of(client_id);
+    const size_t mask = index_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const IndexEntry& entry = index_[i];
+        if (entry.slot_plus_one == 0) return NO_SLOT;
+        const size_t slot = entry.slot_plus_one - 1;
+        if (entry.hash == hash && states_[slot]->client_id == client_id) return slot;
+    }
+}
+
+std::shared_ptr<ClientState> ClientRegistry::at(ClientHandle handle) const {
+    const size_t slot = slot_of(handle);
+    if (slot >= states_.size()) return nullptr;
+    const auto& client = states_[slot];
+    return client && client->handle == handle ? client : nullptr;
+}
+
+bool ClientRegistry::dequeue(size_t slot, Job& out) const {
+    ClientState& client = *states_[slot];
+    std::lock_guard client_lock(client.mutex);
+    if (!client.any_queued()) return false;
+    client.dequeue_highest(out);
+    sync_depth(client);
+    client.notify_space();
+    return true;
+}
+
+size_t ClientRegistry::add(std::shared_ptr<ClientState> client, size_t weight) {
+    if (live_ >= MAX_CLIENTS) {
+        throw std::runtime_error("Client handles exhausted: " + client->client_id);
+    }
+    if ((live_ + 1) * 2 > index_.size()) index_grow();
+
+    size_t slot;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        slot = states_.size();
+        states_.emplace_back();
+        weights_.push_back(0);
+        depths_.push_back(0);
+        generations_.push_back(0);
+    }
+    client->handle = static_cast<ClientHandle>(slot) |
+                     (static_cast<ClientHandle>(generations_[slot]) << SLOT_BITS);
+    index_insert({hash_of(client->client_id), static_cast<uint32_t>(slot + 1)});
+    states_[slot] = std::move(client);
+    weights_[slot] = weight;
+    depths_[slot] = 0;
+    ++live_;
+    return slot;
+}
+
+void ClientRegistry::remove(size_t slot) {
+    index_erase(slot);
+    states_[slot].reset();
+    weights_[slot] = 0;
+    depths_[slot] = 0;
+    ++generations_[slot]; // wraps; stale handles would need 256 reuses to match
+    free_slots_.push_back(static_cast<uint32_t>(slot));
+    --live_;
+}
+
+void ClientRegistry::index_insert(IndexEntry entry) {
+    const size_t mask = index_.size() - 1;
+    size_t i = entry.hash & mask;
+    while (index_[i].slot_plus_one != 0) i = (i + 1) & mask;
+    index_[i] = entry;
+}
+
+void ClientRegistry::index_erase(size_t slot) {
+    const size_t mask = index_.size() - 1;
+    size_t i = hash_of(states_[slot]->client_id) & mask;
+    while (index_[i].slot_plus_one != slot + 1) i = (i + 1) & mask;
+
+    // Backward shift: pull later entries of the probe run into the hole
+    // unless that would move them before their home bucket
+    for (size_t j = (i + 1) & mask; index_[j].slot_plus_one != 0; j = (j + 1) & mask) {
+        const size_t home = index_[j].hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            index_[i] = index_[j];
+            i = j;
+        }
+    }
+    index_[i] = IndexEntry{};
+}
+
+void ClientRegistry::index_grow() {
+    std::vector<IndexEntry> old = std::exchange(
+        index_, std::vector<IndexEntry>(std::max<size_t>(16, index_.size() * 2)));
+    for (const IndexEntry& entry : old) {
+        if (entry.slot_plus_one != 0) index_insert(entry);
+    }
+}
+
+} // namespace job_system
@@ -0,0 +1,80 @@
+#include "job_system/completion_queue.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace job_system {
+
+CompletionQueue::CompletionQueue(size_t capacity)
+    : slots_(std::make_unique<Slot[]>(std::bit_ceil(std::max<size_t>(capacity, 1))))
+    , mask_(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1) {
+    for (size_t i = 0; i <= mask_; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+}
+
+CompletionQueue::~CompletionQueue() = default;
+
+bool CompletionQueue::try_reserve() {
+    size_t cur = reserved_.load(std::memory_order_relaxed);
+    do {
+        if (cur >= capacity()) return false;
+    } while (!reserved_.compare_exchange_weak(cur, cur + 1, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+    return true;
+}
+
+void CompletionQueue::release() { reserved_.fetch_sub(1, std::memory_order_acq_rel); }
+
+void CompletionQueue::post(uint64_t job_id, uint64_t user_tag, CompletionStatus status,
+                           std::chrono::microseconds duration) {
+    // The poster's reservation guarantees the slot was harvested a lap ago
+    const uint64_t index = tail_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[index & mask_];
+    slot.completion.job_id = job_id;
+    slot.completion.user_tag = user_tag;
+    slot.completion.duration_us = static_cast<uint32_t>(std::clamp<int64_t>(
+        duration.count(), 0, std::numeric_limits<uint32_t>::max()));
+    slot.completion.status = status;
+    slot.seq.store(index + 1, std::memory_order_release);
+
+    // Pairs with wait(): either the consumer sees this post before sleeping,
+    // or this sees it waiting and wakes it
+    posted_.fetch_add(1, std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_seq_cst)) posted_.notify_one();
+}
+
+bool CompletionQueue::head_ready() const {
+    return slots_[head_ & mask_].seq.load(std::memory_order_acquire) == head_ + 1;
+}
+
+size_t CompletionQueue::harvest(std::span<Completion> out) {
+    size_t n = 0;
+    while (n < out.size() && head_ready()) {
+        Slot& slot = slots_[head_ & mask_];
+        out[n++] = slot.completion;
+        slot.seq.store(head_ + capacity(), std::memory_order_release); // free for the next lap
+        ++head_;
+    }
+    if (n) reserved_.fetch_sub(n, std::memory_order_acq_rel);
+    return n;
+}
+
+size_t CompletionQueue::wait(std::span<Completion> out, size_t min_count) {
+    min_count = std::min(min_count, out.size());
+    size_t got = harvest(out);
+    while (got < min_count) {
+        // Everything still outstanding is all that can ever arrive
+        if (got + outstanding() < min_count) {
+            min_count = got + outstanding();
+            if (got >= min_count) break;
+        }
+        waiting_.store(1, std::memory_order_seq_cst);
+        const uint32_t seen = posted_.load(std::memory_order_seq_cst);
+        if (!head_ready()) posted_.wait(seen, std::memory_order_seq_cst);
+        waiting_.store(0, std::memory_order_relaxed);
+        got += harvest(out.subspan(got));
+    }
+    return got;
+}
+
+} // namespace job_system
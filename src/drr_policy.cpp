@@ -1,66 +1,57 @@
 #include "job_system/drr_policy.h"
 
-#include <mutex>
-
 namespace job_system {
 
 DeficitRoundRobinPolicy::DeficitRoundRobinPolicy(uint32_t base_quantum)
     : base_quantum_(base_quantum) {}
 
-void DeficitRoundRobinPolicy::on_client_registered(
-    const std::string& client_id, size_t /*weight*/) {
-    deficit_[client_id] = 0;
+void DeficitRoundRobinPolicy::on_client_registered(size_t slot, size_t /*weight*/) {
+    if (deficit_.size() <= slot) deficit_.resize(slot + 1);
+    deficit_[slot] = 0;
 }
 
-std::optional<Job> DeficitRoundRobinPolicy::select_next_job(
-    const std::vector<std::string>& client_order,
-    const ClientMap& clients) {
-    const size_t n = client_order.size();
+bool DeficitRoundRobinPolicy::select_next_job(const ClientRegistry& clients, Job& out) {
+    const size_t n = clients.slot_count();
 
     for (size_t scanned = 0; scanned < n; ++scanned) {
-        const std::string& current = client_order[drr_index_];
-        auto& client = clients.at(current);
-
-        std::lock_guard client_lock(client->mutex);
-
-        if (!client->any_queued()) {
-            // No carry for idle clients — reset deficit
-            deficit_[current] = 0;
-            drr_index_ = (drr_index_ + 1) % n;
-            continue;
-        }
-
-        if (deficit_[current] <= 0) {
-            // Refill: weight × base_quantum credits
-            deficit_[current] +=
-                static_cast<int64_t>(client->weight) *
-                static_cast<int64_t>(base_quantum_);
+        int64_t& deficit = deficit_[drr_index_];
+
+        // Free slots read depth 0 like empty clients
+        if (clients.depth(drr_index_) > 0) {
+            if (deficit <= 0) {
+                // Refill: weight × base_quantum credits
+                deficit += static_cast<int64_t>(clients.weight(drr_index_)) *
+                           static_cast<int64_t>(base_quantum_);
+            }
+
+            if (clients.dequeue(drr_index_, out)) {
+                deficit -= static_cast<int64_t>(out.cost_hint());
+                if (deficit <= 0) {
+                    // Quota spent — next call starts at next client
+                    if (++drr_index_ == n) drr_index_ = 0;
+                }
+                return true;
+            }
         }
 
-        Job job = client->dequeue_highest();
-        deficit_[current] -= static_cast<int64_t>(job.cost_hint);
-
-        if (deficit_[current] <= 0) {
-            // Quota spent — next call starts at next client
-            drr_index_ = (drr_index_ + 1) % n;
-        }
-
-        client->submit_cv_.notify_one();
-        return job;
+        // No carry for idle clients — reset deficit
+        deficit = 0;
+        if (++drr_index_ == n) drr_index_ = 0;
     }
 
-    return std::nullopt;
+    return false;
+}
+
+void DeficitRoundRobinPolicy::on_job_run_inline(size_t slot, const Job& job) {
+    deficit_[slot] -= static_cast<int64_t>(job.cost_hint());
 }
 
-void DeficitRoundRobinPolicy::on_client_weight_updated(
-    const std::string& client_id, size_t /*new_weight*/) {
-    deficit_[client_id] = 0; // avoid inheriting large negative deficit
+void DeficitRoundRobinPolicy::on_client_weight_updated(size_t slot, size_t /*new_weight*/) {
+    deficit_[slot] = 0; // avoid inheriting large negative deficit
 }
 
-void DeficitRoundRobinPolicy::on_client_unregistered(
-    const std::string& client_id) {
-    deficit_.erase(client_id);
-    drr_index_ = 0;
+void DeficitRoundRobinPolicy::on_client_unregistered(size_t slot) {
+    deficit_[slot] = 0;
 }
 
 } // namespace job_system
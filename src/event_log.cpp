@@ -0,0 +1,362 @@
+#include "job_system/event_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JOB_SYSTEM_EVENT_LOG_MMAP 1
+#endif
+
+namespace job_system {
+
+namespace {
+
+constexpr char MAGIC[8] = {'J', 'S', 'E', 'V', 'L', 'O', 'G', '1'};
+
+constexpr uint8_t TAG_NAME = 'N';
+
+// Room kept in front of each thread's payload for the chunk header
+// (3 varints), so header + payload go out in one write
+constexpr size_t HEADER_RESERVE = 32;
+
+// Consumed input is released in steps of this size while streaming
+constexpr uint64_t RELEASE_BYTES = 64ull * 1024 * 1024;
+
+std::atomic<uint64_t> next_log_id{1};
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+uint64_t to_ns(std::chrono::steady_clock::time_point ts) {
+    const auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+    return static_cast<uint64_t>(ns > 0 ? ns : 0);
+}
+
+// Identifies a thread to the logs it records into; unlike std::thread::id,
+// never handed to a later thread
+std::atomic<uint64_t> next_thread_serial{1};
+thread_local const uint64_t tls_thread_serial =
+    next_thread_serial.fetch_add(1, std::memory_order_relaxed);
+
+// The buffer of the log this thread recorded into last. One entry, so a
+// thread that outlives many logs holds no stale pointers beyond it; log ids
+// are never reused, so it is never matched once its log is gone.
+struct CachedBuffer {
+    uint64_t log_id{0};
+    void*    buffer{nullptr};
+};
+thread_local CachedBuffer tls_buffer;
+
+} // namespace
+
+const char* event_type_name(EventType type) {
+    switch (type) {
+    case EventType::SUBMIT:   return "submit";
+    case EventType::REJECT:   return "reject";
+    case EventType::DROP:     return "drop";
+    case EventType::EXPIRE:   return "expire";
+    case EventType::CANCEL:   return "cancel";
+    case EventType::START:    return "start";
+    case EventType::COMPLETE: return "complete";
+    case EventType::SPAWN:    return "spawn";
+    case EventType::NUM_TYPES: break;
+    }
+    return "unknown";
+}
+
+struct EventLog::ThreadBuffer {
+    std::mutex mutex; // owner thread vs flush()/destructor
+    uint64_t owner{0}; // tls_thread_serial of the recording thread
+    uint32_t index{0};
+    std::vector<uint8_t> payload;
+    std::unordered_map<std::string, uint32_t> names;
+    uint64_t base_ts{0};
+    uint64_t last_ts{0};
+    uint64_t last_job{0};
+    uint64_t pending{0}; // records in payload
+
+    bool empty() const { return payload.size() == HEADER_RESERVE; }
+};
+
+EventLog::EventLog(const std::string& path, size_t buffer_bytes)
+    : id_(next_log_id.fetch_add(1, std::memory_order_relaxed))
+    , buffer_bytes_(buffer_bytes > 0 ? buffer_bytes : DEFAULT_BUFFER_BYTES)
+    , path_(path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("Cannot open event log: " + path);
+    }
+    // Chunks are already batched; let each one go out as a single write
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    if (std::fwrite(MAGIC, 1, sizeof(MAGIC), file_) != sizeof(MAGIC)) {
+        std::fclose(file_);
+        throw std::runtime_error("Cannot write event log: " + path);
+    }
+}
+
+EventLog::~EventLog() {
+    try {
+        flush();
+    } catch (const std::runtime_error&) {
+        // Already counted in records_lost()
+    }
+    std::fclose(file_);
+}
+
+EventLog::ThreadBuffer& EventLog::local_buffer() {
+    if (tls_buffer.log_id == id_) return *static_cast<ThreadBuffer*>(tls_buffer.buffer);
+
+    // Another log was recorded into since: look this thread up in ours
+    ThreadBuffer* raw = nullptr;
+    {
+        std::lock_guard lock(buffers_mutex_);
+        for (const auto& b : buffers_) {
+            if (b->owner == tls_thread_serial) {
+                raw = b.get();
+                break;
+            }
+        }
+    }
+    if (!raw) {
+        auto buf = std::make_unique<ThreadBuffer>();
+        buf->owner = tls_thread_serial;
+        buf->payload.reserve(HEADER_RESERVE + buffer_bytes_ + 64);
+        buf->payload.resize(HEADER_RESERVE);
+        raw = buf.get();
+        std::lock_guard lock(buffers_mutex_);
+        raw->index = static_cast<uint32_t>(buffers_.size());
+        buffers_.push_back(std::move(buf));
+    }
+    tls_buffer = {id_, raw};
+    return *raw;
+}
+
+void EventLog::record(EventType type, const std::string& client_id,
+                      uint64_t job_id, uint64_t extra,
+                      std::chrono::steady_clock::time_point ts) {
+    ThreadBuffer& buf = local_buffer();
+    std::lock_guard lock(buf.mutex);
+    auto& out = buf.payload;
+
+    const uint64_t now = to_ns(ts);
+    if (buf.empty()) {
+        buf.base_ts = now;
+        buf.last_ts = now;
+        buf.last_job = 0;
+    }
+
+    auto it = buf.names.find(client_id);
+    if (it == buf.names.end()) {
+        const auto idx = static_cast<uint32_t>(buf.names.size());
+        it = buf.names.emplace(client_id, idx).first;
+        out.push_back(TAG_NAME);
+        put_varint(out, idx);
+        put_varint(out, client_id.size());
+        out.insert(out.end(), client_id.begin(), client_id.end());
+    }
+
+    out.push_back(static_cast<uint8_t>(type));
+    put_varint(out, now > buf.last_ts ? now - buf.last_ts : 0);
+    put_varint(out, it->second);
+    put_varint(out, zigzag(static_cast<int64_t>(job_id - buf.last_job)));
+    put_varint(out, extra);
+    buf.last_ts = std::max(buf.last_ts, now);
+    buf.last_job = job_id;
+    records_.fetch_add(1, std::memory_order_relaxed);
+    ++buf.pending;
+
+    if (out.size() - HEADER_RESERVE >= buffer_bytes_) write_chunk(buf);
+}
+
+void EventLog::write_chunk(ThreadBuffer& buf) {
+    if (buf.empty()) return;
+    std::vector<uint8_t> header;
+    header.reserve(HEADER_RESERVE);
+    put_varint(header, buf.index);
+    put_varint(header, buf.base_ts);
+    put_varint(header, buf.payload.size() - HEADER_RESERVE);
+
+    const size_t start = HEADER_RESERVE - header.size();
+    std::memcpy(buf.payload.data() + start, header.data(), header.size());
+    {
+        std::lock_guard lock(file_mutex_);
+        // After a failed write the file ends in a torn chunk; later chunks
+        // could not be read past it, so they are dropped as well
+        const size_t size = buf.payload.size() - start;
+        if (write_failed_.load(std::memory_order_relaxed) ||
+            std::fwrite(buf.payload.data() + start, 1, size, file_) != size) {
+            write_failed_.store(true, std::memory_order_relaxed);
+            lost_.fetch_add(buf.pending, std::memory_order_relaxed);
+        }
+    }
+    buf.payload.resize(HEADER_RESERVE);
+    buf.pending = 0;
+}
+
+void EventLog::flush() {
+    {
+        std::lock_guard lock(buffers_mutex_);
+        for (auto& buf : buffers_) {
+            std::lock_guard buf_lock(buf->mutex);
+            write_chunk(*buf);
+        }
+    }
+    if (write_failed_.load(std::memory_order_relaxed)) {
+        throw std::runtime_error("Cannot write event log: " + path_ + " (" +
+                                 std::to_string(records_lost()) + " records lost)");
+    }
+}
+
+uint64_t EventLog::records_lost() const {
+    return lost_.load(std::memory_order_relaxed);
+}
+
+uint64_t EventLog::records_written() const {
+    return records_.load(std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------
+// EventLogReader
+// ---------------------------------------------------------------------------
+
+EventLogReader::EventLogReader(const std::string& path) : path_(path) {
+#ifdef JOB_SYSTEM_EVENT_LOG_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open event log: " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat event log: " + path);
+    }
+    size_ = static_cast<uint64_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map event log: " + path);
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const uint8_t*>(p);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open event log: " + path);
+    }
+    fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+#endif
+    if (size_ < sizeof(MAGIC) || std::memcmp(data_, MAGIC, sizeof(MAGIC)) != 0) {
+#ifdef JOB_SYSTEM_EVENT_LOG_MMAP
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        throw std::runtime_error("Not a job_system event log: " + path);
+    }
+}
+
+EventLogReader::~EventLogReader() {
+#ifdef JOB_SYSTEM_EVENT_LOG_MMAP
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+}
+
+void EventLogReader::for_each(const std::function<void(const LogEvent&)>& fn) {
+    uint64_t pos = sizeof(MAGIC);
+    auto get = [&](uint64_t end) -> uint64_t {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos >= end) throw std::runtime_error("Truncated event log: " + path_);
+            const uint8_t b = data_[pos++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw std::runtime_error("Malformed varint in event log: " + path_);
+    };
+
+    // Per recording thread: its local client index → global index
+    std::vector<std::vector<uint32_t>> thread_clients;
+#ifdef JOB_SYSTEM_EVENT_LOG_MMAP
+    const auto page = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    uint64_t released = 0;
+#endif
+
+    while (pos < size_) {
+        const auto thread = static_cast<uint32_t>(get(size_));
+        uint64_t ts = get(size_);
+        const uint64_t len = get(size_);
+        const uint64_t end = pos + len;
+        if (end > size_ || end < pos) throw std::runtime_error("Truncated event log: " + path_);
+        if (thread >= thread_clients.size()) thread_clients.resize(thread + 1);
+        auto& local = thread_clients[thread];
+
+        uint64_t job = 0;
+        while (pos < end) {
+            const uint8_t tag = data_[pos++];
+            if (tag == TAG_NAME) {
+                const auto idx = get(end);
+                const auto name_len = get(end);
+                if (pos + name_len > end) throw std::runtime_error("Truncated event log: " + path_);
+                std::string name(reinterpret_cast<const char*>(data_ + pos), name_len);
+                pos += name_len;
+                if (idx != local.size()) throw std::runtime_error("Bad client index in event log: " + path_);
+                auto [it, inserted] =
+                    client_index_.emplace(name, static_cast<uint32_t>(clients_.size()));
+                if (inserted) clients_.push_back(std::move(name));
+                local.push_back(it->second);
+                continue;
+            }
+            if (tag >= static_cast<uint8_t>(EventType::NUM_TYPES)) {
+                throw std::runtime_error("Unknown record type in event log: " + path_);
+            }
+            LogEvent ev;
+            ev.type = static_cast<EventType>(tag);
+            ev.thread = thread;
+            ts += get(end);
+            ev.timestamp_ns = ts;
+            const auto client = get(end);
+            if (client >= local.size()) throw std::runtime_error("Unknown client in event log: " + path_);
+            ev.client = local[client];
+            job += static_cast<uint64_t>(unzigzag(get(end)));
+            ev.job_id = job;
+            ev.extra = get(end);
+            fn(ev);
+        }
+
+#ifdef JOB_SYSTEM_EVENT_LOG_MMAP
+        // Drop pages already consumed so RSS stays bounded on huge logs
+        if (pos - released >= RELEASE_BYTES) {
+            const uint64_t upto = (pos / page) * page;
+            ::madvise(const_cast<uint8_t*>(data_) + released, upto - released, MADV_DONTNEED);
+            released = upto;
+        }
+#endif
+    }
+}
+
+} // namespace job_system
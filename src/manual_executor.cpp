@@ -0,0 +1,22 @@
+#include "job_system/manual_executor.h"
+
+namespace job_system {
+
+ManualExecutor::ManualExecutor(Scheduler& scheduler) : scheduler_(scheduler) {}
+
+size_t ManualExecutor::step(size_t n) {
+    size_t ran = 0;
+    Job job;
+    while (ran < n && scheduler_.select_next_job(job)) {
+        scheduler_.execute(job);
+        ++ran;
+    }
+    executed_ += ran;
+    return ran;
+}
+
+size_t ManualExecutor::run_until_idle(size_t max_jobs) {
+    return step(max_jobs);
+}
+
+} // namespace job_system
@@ -2,17 +2,61 @@
 
 #include <algorithm>
 #include <cmath>
+#include <exception>
+#include <limits>
 #include <stdexcept>
 
+#include "job_system/execution.h"
 #include "job_system/wrr_policy.h"
+#include "tracepoints.h"
 
 namespace job_system {
 
+namespace {
+
+// The job (if any) the calling thread is executing, and for which Scheduler.
+// Read by submit() to fill in spawn lineage.
+struct RunningJob {
+    const Scheduler* scheduler{nullptr};
+    uint64_t job_id{0};
+    uint64_t root_id{0};
+    Priority priority{Priority::NORMAL};
+};
+thread_local RunningJob tls_running;
+
+// Installs `job` as the thread's running job for the duration of a task,
+// restoring the previous one afterwards (tasks may step another executor)
+class RunningJobScope {
+public:
+    RunningJobScope(const Scheduler* scheduler, const Job& job) : saved_(tls_running) {
+        tls_running = {scheduler, job.job_id, job.root_id(), job.priority()};
+    }
+    ~RunningJobScope() { tls_running = saved_; }
+
+    RunningJobScope(const RunningJobScope&) = delete;
+    RunningJobScope& operator=(const RunningJobScope&) = delete;
+
+private:
+    RunningJob saved_;
+};
+
+} // namespace
+
 Scheduler::Scheduler()
     : Scheduler(std::make_unique<WeightedRoundRobinPolicy>()) {}
 
 Scheduler::Scheduler(std::unique_ptr<ISchedulingPolicy> policy)
-    : policy_(std::move(policy)) {}
+    : Scheduler(std::move(policy), std::make_shared<SteadyClock>()) {}
+
+Scheduler::Scheduler(std::unique_ptr<ISchedulingPolicy> policy,
+                     std::shared_ptr<IClock> clock)
+    : policy_(std::move(policy))
+    , clock_(std::move(clock)) {
+    if (!clock_) {
+        throw std::invalid_argument("Scheduler clock must not be null");
+    }
+    epoch_ = clock_->now();
+}
 
 Scheduler::~Scheduler() = default;
 
@@ -23,156 +67,616 @@ void Scheduler::register_client(const std::string& client_id,
     if (weight == 0) {
         throw std::invalid_argument("Client weight must be >= 1: " + client_id);
     }
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_EXCLUSIVE);
     std::unique_lock lock(registry_mutex_);
-    if (clients_.contains(client_id)) {
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_EXCLUSIVE);
+    if (registry_.find(client_id) != ClientRegistry::NO_SLOT) {
         throw std::runtime_error("Client already registered: " + client_id);
     }
-    clients_.emplace(client_id,
-                     std::make_shared<ClientState>(client_id, weight,
-                                                   max_queue_depth, strategy));
-    client_order_.push_back(client_id);
-    policy_->on_client_registered(client_id, weight);
+    auto client = std::make_shared<ClientState>(client_id, max_queue_depth, strategy);
+    ClientLimits* const limits = client->limits.get();
+    const size_t slot = registry_.add(std::move(client), weight);
+    if (limits && strategy == OverflowStrategy::BLOCK) {
+        limits->space_cv = &space_cvs_[slot % space_cvs_.size()];
+    }
+    policy_->on_client_registered(slot, weight);
 }
 
 void Scheduler::submit(const std::string& client_id,
-                        std::function<void()> task,
+                        Task task,
                         uint32_t cost_hint,
                         Priority priority,
                         std::chrono::steady_clock::time_point deadline) {
-    std::shared_ptr<ClientState> client;
-    {
-        std::shared_lock lock(registry_mutex_);
-        auto it = clients_.find(client_id);
-        if (it == clients_.end()) {
-            throw std::runtime_error("Unknown client: " + client_id);
+    Job job;
+    job.task = std::move(task);
+    job.set_cost_hint(cost_hint);
+    job.set_priority(priority);
+    submit(client_id, std::move(job), deadline);
+}
+
+void Scheduler::submit_raw(const std::string& client_id, Job::RawHandler handler,
+                           std::span<const std::byte> payload, uint32_t cost_hint,
+                           Priority priority, std::chrono::steady_clock::time_point deadline) {
+    Job job;
+    job.set_raw(handler, payload);
+    job.set_cost_hint(cost_hint);
+    job.set_priority(priority);
+    submit(client_id, std::move(job), deadline);
+}
+
+void Scheduler::submit(CompletionQueue& cq, uint64_t user_tag, const std::string& client_id,
+                       Task task, uint32_t cost_hint, Priority priority,
+                       std::chrono::steady_clock::time_point deadline) {
+    Job job;
+    job.task = std::move(task);
+    job.set_cost_hint(cost_hint);
+    job.set_priority(priority);
+    job.set_completion(&cq, user_tag);
+    submit(client_id, std::move(job), deadline);
+}
+
+void Scheduler::submit(const std::string& client_id, Job job,
+                       std::chrono::steady_clock::time_point deadline) {
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_SHARED);
+    std::shared_lock registry_lock(registry_mutex_);
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_SHARED);
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) {
+        throw std::runtime_error("Unknown client: " + client_id);
+    }
+    // Kept alive while enqueue() waits without the registry lock
+    const std::shared_ptr<ClientState> client = registry_.state(slot);
+    job.job_id = next_job_id_.fetch_add(1, std::memory_order_relaxed);
+    assign_lineage(job);
+    stamp(job, deadline);
+    if (!enqueue(registry_lock, client, job)) {
+        throw std::runtime_error("Unknown client: " + client_id);
+    }
+}
+
+std::shared_ptr<ClientState> Scheduler::client_at(ClientHandle handle) const {
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_SHARED);
+    std::shared_lock lock(registry_mutex_);
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_SHARED);
+    return registry_.at(handle);
+}
+
+uint32_t Scheduler::to_ticks(std::chrono::steady_clock::time_point t) const {
+    // Two's-complement truncation: differences of ticks stay exact mod 2^32
+    return static_cast<uint32_t>(
+        std::chrono::floor<std::chrono::microseconds>(t - epoch_).count());
+}
+
+void Scheduler::stamp(Job& job, std::chrono::steady_clock::time_point deadline) const {
+    using std::chrono::microseconds;
+    const auto now = clock_->now();
+    const int64_t now_us = std::chrono::floor<microseconds>(now - epoch_).count();
+    job.enqueue_us = static_cast<uint32_t>(now_us);
+    if (deadline == std::chrono::steady_clock::time_point{}) {
+        job.clear_deadline();
+        return;
+    }
+    const int64_t after =
+        std::chrono::floor<microseconds>(deadline - epoch_).count() - now_us;
+    if (after > std::numeric_limits<int32_t>::max()) {
+        job.clear_deadline(); // beyond the 32-bit range: never expires
+    } else {
+        job.set_deadline(static_cast<int32_t>(
+            std::max<int64_t>(after, std::numeric_limits<int32_t>::min())));
+    }
+}
+
+std::chrono::steady_clock::time_point Scheduler::enqueue_time(const Job& job) const {
+    using std::chrono::microseconds;
+    const auto now = clock_->now();
+    const uint32_t waited = to_ticks(now) - job.enqueue_us;
+    return epoch_ + std::chrono::floor<microseconds>(now - epoch_) - microseconds(waited);
+}
+
+std::chrono::steady_clock::time_point Scheduler::deadline(const Job& job) const {
+    if (!job.has_deadline()) return {};
+    return enqueue_time(job) + std::chrono::microseconds(job.deadline_us);
+}
+
+void Scheduler::assign_lineage(Job& job) const {
+    if (tls_running.scheduler == this && tls_running.job_id != 0) {
+        JOB_SYSTEM_TRACE(spawn, tls_running.job_id, job.job_id);
+        // Stored only for the event log (SPAWN, and the root_id its children
+        // inherit): a fork-join child otherwise costs no allocation
+        if (!job.extras) {
+            if (!event_log_.load(std::memory_order_relaxed)) return;
+            job.extras = std::make_unique<JobExtras>();
         }
-        client = it->second;
+        job.extras->parent_id = tls_running.job_id;
+        job.extras->root_id = tls_running.root_id;
+    } else if (job.extras) {
+        job.extras->parent_id = 0;
+        job.extras->root_id = job.job_id;
     }
+}
 
-    Job job(client_id, std::move(task));
+uint64_t Scheduler::reserve_job_ids(uint64_t count) {
+    return next_job_id_.fetch_add(count, std::memory_order_relaxed);
+}
+
+bool Scheduler::try_submit(const std::string& client_id, Task task, uint32_t cost_hint,
+                           Priority priority) {
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_SHARED);
+    std::shared_lock registry_lock(registry_mutex_);
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_SHARED);
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) {
+        throw std::runtime_error("Unknown client: " + client_id);
+    }
+    const std::shared_ptr<ClientState> client = registry_.state(slot);
+    Job job;
+    job.task = std::move(task);
+    job.set_cost_hint(cost_hint);
+    job.set_priority(priority);
     job.job_id = next_job_id_.fetch_add(1, std::memory_order_relaxed);
-    job.cost_hint = cost_hint;
-    job.priority = priority;
-    job.deadline = deadline;
+    assign_lineage(job);
+    stamp(job, {});
+    return enqueue(registry_lock, client, job, /*announced=*/false, /*only_if_room=*/true);
+}
+
+bool Scheduler::enqueue(std::shared_lock<std::shared_mutex>& registry_lock,
+                        const std::shared_ptr<ClientState>& client, Job& job, bool announced,
+                        bool only_if_room) {
+    // Held until the completion is harvested; returned if the job is refused
+    CompletionQueue* const cq = job.completion_queue();
+    if (cq && !cq->try_reserve()) {
+        throw QueueFullException("Completion queue full");
+    }
+    // `job` is moved into the queue below; these outlive it
+    const std::string& client_id = client->client_id;
+    const uint32_t cost_hint = job.cost_hint();
+    const Priority priority = job.priority();
+
+    job.client = client->handle;
+    // Job the calling thread is running for us (0 = not inside one of our tasks)
+    const uint64_t caller_task = tls_running.scheduler == this ? tls_running.job_id : 0;
 
     const uint64_t job_id_snapshot = job.job_id;
-    const size_t prio_idx = static_cast<size_t>(priority);
+    // Overflow outcome: how long a BLOCK caller waited, and the job the
+    // caller runs inline (CALLER_RUNS, help-while-blocked)
+    std::optional<std::chrono::microseconds> blocked_for;
+    std::optional<Job> helped;
+    std::optional<Job> evicted; // DROP_OLDEST victim that wants a discard notice
+
+    if (!announced) announce(*client, job);
 
     {
+        JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::CLIENT);
         std::unique_lock client_lock(client->mutex);
-        if (client->max_queue_depth > 0) {
-            switch (client->overflow_strategy) {
+        JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::CLIENT);
+        if (ClientLimits* const limits = client->limits.get()) {
+            const size_t max_depth = limits->max_queue_depth;
+            if (only_if_room && client->total_queued() >= max_depth) {
+                if (auto log = event_log_.load(std::memory_order_acquire)) {
+                    log->record(EventType::REJECT, client_id, job_id_snapshot,
+                                static_cast<uint64_t>(OverflowStrategy::REJECT), clock_->now());
+                }
+                if (cq) cq->release();
+                return false;
+            }
+            switch (limits->overflow_strategy) {
             case OverflowStrategy::REJECT:
-                if (client->total_queued() >= client->max_queue_depth) {
-                    client->overflow_count.fetch_add(1,
+                if (client->total_queued() >= max_depth) {
+                    JOB_SYSTEM_TRACE(overflow, client_id.c_str(), job_id_snapshot,
+                                     static_cast<int>(limits->overflow_strategy),
+                                     client->total_queued());
+                    limits->overflow_count.fetch_add(1,
                                                      std::memory_order_relaxed);
+                    if (auto log = event_log_.load(std::memory_order_acquire)) {
+                        log->record(EventType::REJECT, client_id, job_id_snapshot,
+                                    static_cast<uint64_t>(OverflowStrategy::REJECT),
+                                    clock_->now());
+                    }
+                    if (cq) cq->release();
                     throw QueueFullException("Queue full for client: " +
                                              client_id);
                 }
                 break;
             case OverflowStrategy::BLOCK:
-                client->submit_cv_.wait(client_lock, [&] {
-                    return client->total_queued() < client->max_queue_depth;
-                });
+                if (client->total_queued() >= max_depth) {
+                    JOB_SYSTEM_TRACE(overflow, client_id.c_str(), job_id_snapshot,
+                                     static_cast<int>(limits->overflow_strategy),
+                                     client->total_queued());
+                    limits->blocked_count.fetch_add(1, std::memory_order_relaxed);
+                    if (caller_task != 0) {
+                        // A worker is about to stall inside a task: it can
+                        // only continue once another worker drains this
+                        // client, and never if it is the only one that could
+                        limits->blocked_in_task_count.fetch_add(1, std::memory_order_relaxed);
+                        for (size_t level = 0; level < client->queues.size(); ++level) {
+                            const auto& q = client->queues[level];
+                            if (!q || q->empty()) continue;
+                            if (level < static_cast<size_t>(tls_running.priority)) {
+                                limits->priority_inversion_count.fetch_add(
+                                    1, std::memory_order_relaxed);
+                            }
+                            break;
+                        }
+                    }
+                    if (help_while_blocked_.load(std::memory_order_relaxed)) {
+                        // Run the client's next job here instead; the new
+                        // job takes its slot
+                        client->dequeue_highest(helped.emplace());
+                        limits->helped_count.fetch_add(1, std::memory_order_relaxed);
+                        JOB_SYSTEM_TRACE(help, client_id.c_str(), helped->job_id, caller_task);
+                        blocked_for = std::chrono::microseconds{0};
+                        break;
+                    }
+                    if (caller_task != 0) tasks_blocked_.fetch_add(1, std::memory_order_relaxed);
+                    const auto wait_start = clock_->now();
+                    bool registered = true;
+                    ++limits->sleepers;
+                    do {
+                        // Asleep without the registry lock. It comes first in
+                        // the lock order, so the client's is dropped to retake
+                        // it, and the client may be gone by then.
+                        registry_lock.unlock();
+                        limits->space_cv->wait(client_lock, [&] {
+                            return client->total_queued() < max_depth;
+                        });
+                        client_lock.unlock();
+                        registry_lock.lock();
+                        client_lock.lock();
+                        registered = registry_.contains(*client);
+                    } while (registered && client->total_queued() >= max_depth);
+                    --limits->sleepers;
+                    if (caller_task != 0) tasks_blocked_.fetch_sub(1, std::memory_order_relaxed);
+                    blocked_for = std::chrono::duration_cast<std::chrono::microseconds>(
+                        clock_->now() - wait_start);
+                    limits->blocked_time_us.fetch_add(blocked_for->count(),
+                                                      std::memory_order_relaxed);
+                    if (!registered) {
+                        if (cq) cq->release();
+                        return false;
+                    }
+                }
                 break;
             case OverflowStrategy::DROP_OLDEST:
-                if (client->total_queued() >= client->max_queue_depth) {
+                if (client->total_queued() >= max_depth) {
+                    JOB_SYSTEM_TRACE(overflow, client_id.c_str(), job_id_snapshot,
+                                     static_cast<int>(limits->overflow_strategy),
+                                     client->total_queued());
                     // Drop oldest job from lowest non-empty priority level
                     for (auto& q : client->queues) {
-                        if (!q.empty()) {
-                            q.pop_front();
+                        if (q && !q->empty()) {
+                            if (auto log = event_log_.load(std::memory_order_acquire)) {
+                                log->record(EventType::DROP, client_id, q->front().job_id, 0,
+                                            clock_->now());
+                            }
+                            if (q->front().wants_discard_notice()) {
+                                evicted = std::move(q->front());
+                            }
+                            q->pop_front();
                             break;
                         }
                     }
-                    client->overflow_count.fetch_add(1,
+                    limits->overflow_count.fetch_add(1,
                                                      std::memory_order_relaxed);
                 }
                 break;
             case OverflowStrategy::DROP_NEWEST:
-                if (client->total_queued() >= client->max_queue_depth) {
-                    client->overflow_count.fetch_add(1,
+                if (client->total_queued() >= max_depth) {
+                    JOB_SYSTEM_TRACE(overflow, client_id.c_str(), job_id_snapshot,
+                                     static_cast<int>(limits->overflow_strategy),
+                                     client->total_queued());
+                    limits->overflow_count.fetch_add(1,
                                                      std::memory_order_relaxed);
-                    return; // job silently discarded
+                    if (auto log = event_log_.load(std::memory_order_acquire)) {
+                        log->record(EventType::REJECT, client_id, job_id_snapshot,
+                                    static_cast<uint64_t>(OverflowStrategy::DROP_NEWEST),
+                                    clock_->now());
+                    }
+                    client_lock.unlock();
+                    registry_lock.unlock();
+                    discard(job, CompletionStatus::DROPPED);
+                    return true; // job silently discarded
+                }
+                break;
+            case OverflowStrategy::CALLER_RUNS:
+                if (client->total_queued() >= max_depth) {
+                    JOB_SYSTEM_TRACE(overflow, client_id.c_str(), job_id_snapshot,
+                                     static_cast<int>(limits->overflow_strategy),
+                                     client->total_queued());
+                    limits->overflow_count.fetch_add(1, std::memory_order_relaxed);
+                    // Throttle the producer by making it run the job the
+                    // client would run next; the new job takes its slot
+                    client->dequeue_highest(helped.emplace());
+                    limits->helped_count.fetch_add(1, std::memory_order_relaxed);
+                    JOB_SYSTEM_TRACE(help, client_id.c_str(), helped->job_id, caller_task);
                 }
                 break;
             }
         }
-        client->queues[prio_idx].push_back(std::move(job));
+        client->push(std::move(job));
+        registry_.sync_depth(*client);
+        // Timestamped under the client lock, so never later than the START,
+        // DROP or CANCEL of the same job
+        if (auto log = event_log_.load(std::memory_order_acquire)) {
+            log->record(EventType::SUBMIT, client_id, job_id_snapshot,
+                        static_cast<uint64_t>(priority), clock_->now());
+        }
     }
+    // Notifier, observer and inline runs may call back into the Scheduler
+    registry_lock.unlock();
     client->submitted_count.fetch_add(1, std::memory_order_relaxed);
+    JOB_SYSTEM_TRACE(submit, client_id.c_str(), job_id_snapshot,
+                     static_cast<int>(priority), cost_hint);
+
+    if (auto notify = work_notifier_.load(std::memory_order_acquire)) {
+        (*notify)();
+    }
 
     if (auto obs = observer_.load(std::memory_order_acquire)) {
+        if (blocked_for) {
+            obs->on_submit_blocked(client_id, job_id_snapshot, caller_task, *blocked_for);
+        }
         obs->on_job_submitted(client_id, job_id_snapshot);
     }
+
+    if (evicted) discard(*evicted, CompletionStatus::DROPPED);
+
+    if (helped) {
+        if (helped->has_deadline() && helped->is_expired(to_ticks(clock_->now()))) {
+            on_expired(*helped, *client);
+            discard(*helped, CompletionStatus::EXPIRED);
+        } else {
+            {
+                // Its slot may hold another client by now
+                std::shared_lock relock(registry_mutex_);
+                if (registry_.contains(*client)) {
+                    std::lock_guard rr_lock(rr_mutex_);
+                    policy_->on_job_run_inline(ClientRegistry::slot_of(client->handle),
+                                               *helped);
+                }
+            }
+            // The caller's job is admitted: another task's failure is not
+            // this submit's to report
+            execute(*helped, /*contain_failure=*/true);
+        }
+    }
+    return true;
 }
 
-std::optional<Job> Scheduler::select_next_job() {
+void Scheduler::announce(const ClientState& client, const Job& job) {
+    if (auto trace = trace_.load(std::memory_order_acquire)) {
+        trace->record_arrival(client, registry_.weight(ClientRegistry::slot_of(client.handle)),
+                              job.job_id, job.cost_hint(), job.priority(), deadline(job),
+                              clock_->now());
+    }
+    if (const uint64_t parent_id = job.parent_id(); parent_id != 0) {
+        if (auto log = event_log_.load(std::memory_order_acquire)) {
+            log->record(EventType::SPAWN, client.client_id, job.job_id, parent_id,
+                        clock_->now());
+        }
+    }
+}
+
+void Scheduler::submit_batch(const std::string& client_id, std::vector<Job>& jobs,
+                             uint64_t& refused) {
+    // Refused at flush time, when the producer can no longer be told by an
+    // exception: reported like a dropped job (on the completion queue only
+    // if it has a free slot)
+    auto refuse = [&](Job& job) {
+        if (job.completion_queue() && !job.completion_queue()->try_reserve()) {
+            job.set_completion(nullptr, 0);
+        }
+        discard(job, CompletionStatus::DROPPED);
+        ++refused;
+    };
+
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_SHARED);
+    std::shared_lock registry_lock(registry_mutex_);
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_SHARED);
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) {
+        registry_lock.unlock();
+        for (auto& job : jobs) refuse(job);
+        jobs.clear();
+        return;
+    }
+    const std::shared_ptr<ClientState> client = registry_.state(slot);
+    for (const auto& job : jobs) announce(*client, job);
+
+    // Jobs whose completion queue was full, left in place (not moved from)
+    std::vector<size_t> cq_full;
+    bool spliced = false;
+    {
+        JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::CLIENT);
+        std::lock_guard client_lock(client->mutex);
+        JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::CLIENT);
+        // The whole batch fits, so no overflow strategy applies
+        const size_t max_depth = client->max_queue_depth();
+        if (max_depth == 0 || client->total_queued() + jobs.size() <= max_depth) {
+            auto log = event_log_.load(std::memory_order_acquire);
+            const auto now = clock_->now();
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                Job& job = jobs[i];
+                if (job.completion_queue() && !job.completion_queue()->try_reserve()) {
+                    cq_full.push_back(i);
+                    continue;
+                }
+                job.client = client->handle;
+                JOB_SYSTEM_TRACE(submit, client_id.c_str(), job.job_id,
+                                 static_cast<int>(job.priority()), job.cost_hint());
+                if (log) {
+                    log->record(EventType::SUBMIT, client_id, job.job_id,
+                                static_cast<uint64_t>(job.priority()), now);
+                }
+                client->push(std::move(job));
+            }
+            registry_.sync_depth(*client);
+            spliced = true;
+        }
+    }
+    registry_lock.unlock();
+
+    if (!spliced) {
+        // Not enough room: each job goes through submit()'s overflow handling.
+        // enqueue() only throws before admitting, so a failure (e.g. out of
+        // memory) refuses that job and must not cost the rest of the batch.
+        std::exception_ptr error;
+        for (auto& job : jobs) {
+            bool admitted = false;
+            try {
+                std::shared_lock relock(registry_mutex_);
+                admitted = registry_.contains(*client) &&
+                           enqueue(relock, client, job, /*announced=*/true);
+            } catch (const QueueFullException&) {
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+            if (!admitted) refuse(job);
+        }
+        jobs.clear();
+        if (error) std::rethrow_exception(error);
+        return;
+    }
+
+    client->submitted_count.fetch_add(jobs.size() - cq_full.size(), std::memory_order_relaxed);
+    // Moved-from jobs keep their ids
+    auto notify = work_notifier_.load(std::memory_order_acquire);
+    auto obs = observer_.load(std::memory_order_acquire);
+    auto next_full = cq_full.begin();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (next_full != cq_full.end() && *next_full == i) {
+            ++next_full;
+            refuse(jobs[i]);
+            continue;
+        }
+        if (notify) (*notify)();
+        if (obs) obs->on_job_submitted(client_id, jobs[i].job_id);
+    }
+    jobs.clear();
+}
+
+ClientScheduler Scheduler::get_scheduler(const std::string& client_id, Priority priority) {
+    {
+        std::shared_lock lock(registry_mutex_);
+        if (registry_.find(client_id) == ClientRegistry::NO_SLOT) {
+            throw std::runtime_error("Unknown client: " + client_id);
+        }
+    }
+    return ClientScheduler(*this, client_id, priority);
+}
+
+bool Scheduler::select_next_job(Job& out) {
+    JOB_SYSTEM_TRACE(select_begin);
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_SHARED);
     std::shared_lock registry_lock(registry_mutex_);
-    if (client_order_.empty()) return std::nullopt;
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_SHARED);
+    if (registry_.empty()) {
+        JOB_SYSTEM_TRACE(select_end, uint64_t{0});
+        return false;
+    }
 
     while (true) {
-        std::optional<Job> maybe_job;
+        bool found = false;
         {
+            JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::POLICY);
             std::lock_guard rr_lock(rr_mutex_);
-            maybe_job = policy_->select_next_job(client_order_, clients_);
+            JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::POLICY);
+            found = policy_->select_next_job(registry_, out);
+        }
+        if (!found) {
+            JOB_SYSTEM_TRACE(select_end, uint64_t{0});
+            return false;
         }
-        if (!maybe_job.has_value()) return std::nullopt;
 
-        Job job = std::move(*maybe_job);
-        if (job.is_expired()) {
-            auto it = clients_.find(job.client_id);
-            if (it != clients_.end()) {
-                it->second->expired_count.fetch_add(1, std::memory_order_relaxed);
-            }
-            if (auto obs = observer_.load(std::memory_order_acquire)) {
-                obs->on_job_expired(job.client_id, job.job_id);
+        // The policy took `out` from a registered client's queue
+        ClientState& client = *registry_.state(ClientRegistry::slot_of(out.client));
+        if (out.has_deadline() && out.is_expired(to_ticks(clock_->now()))) {
+            on_expired(out, client);
+            if (out.wants_discard_notice()) {
+                registry_lock.unlock();
+                discard(out, CompletionStatus::EXPIRED);
+                registry_lock.lock();
             }
+            out = Job{};
             continue;
         }
-        return job;
+        JOB_SYSTEM_TRACE(dequeue, client.client_id.c_str(), out.job_id,
+                         static_cast<int>(out.priority()), uint64_t{out.enqueue_us});
+        JOB_SYSTEM_TRACE(select_end, out.job_id);
+        return true;
+    }
+}
+
+std::optional<Job> Scheduler::select_next_job() {
+    Job job;
+    if (!select_next_job(job)) return std::nullopt;
+    return job;
+}
+
+void Scheduler::on_expired(const Job& job, ClientState& client) {
+    JOB_SYSTEM_TRACE(expire, client.client_id.c_str(), job.job_id, uint64_t{job.enqueue_us},
+                     int64_t{job.deadline_us});
+    client.expired_count.fetch_add(1, std::memory_order_relaxed);
+    if (auto log = event_log_.load(std::memory_order_acquire)) {
+        log->record(EventType::EXPIRE, client.client_id, job.job_id, 0, clock_->now());
+    }
+    if (auto obs = observer_.load(std::memory_order_acquire)) {
+        obs->on_job_expired(client.client_id, job.job_id);
     }
 }
 
 bool Scheduler::cancel_job(uint64_t job_id) {
-    std::shared_lock registry_lock(registry_mutex_);
-    for (const auto& cid : client_order_) {
-        auto& client = clients_.at(cid);
-        std::lock_guard client_lock(client->mutex);
-        for (auto& q : client->queues) {
-            for (auto it = q.begin(); it != q.end(); ++it) {
-                if (it->job_id == job_id) {
-                    const uint64_t jid = it->job_id;
-                    q.erase(it);
-                    client->submit_cv_.notify_one();
-                    if (auto obs = observer_.load(std::memory_order_acquire)) {
-                        obs->on_job_cancelled(cid, jid);
+    std::optional<Job> cancelled;
+    std::shared_ptr<ClientState> owner;
+    {
+        std::shared_lock registry_lock(registry_mutex_);
+        for (size_t slot = 0; slot < registry_.slot_count() && !cancelled; ++slot) {
+            const auto& client = registry_.state(slot);
+            if (!client) continue;
+            std::lock_guard client_lock(client->mutex);
+            for (auto& q : client->queues) {
+                if (!q) continue;
+                for (auto it = q->begin(); it != q->end(); ++it) {
+                    if (it->job_id == job_id) {
+                        cancelled = std::move(*it);
+                        owner = client;
+                        q->erase(it);
+                        registry_.sync_depth(*client);
+                        if (auto log = event_log_.load(std::memory_order_acquire)) {
+                            log->record(EventType::CANCEL, client->client_id, job_id, 0,
+                                        clock_->now());
+                        }
+                        client->notify_space();
+                        break;
                     }
-                    return true;
                 }
+                if (cancelled) break;
             }
         }
     }
-    return false;
+    if (!cancelled) return false;
+
+    if (auto obs = observer_.load(std::memory_order_acquire)) {
+        obs->on_job_cancelled(owner->client_id, job_id);
+    }
+    discard(*cancelled, CompletionStatus::CANCELLED);
+    return true;
 }
 
 uint64_t Scheduler::drain_client(const std::string& client_id) {
-    std::shared_ptr<ClientState> client;
+    uint64_t count = 0;
+    std::vector<Job> hooked;
     {
         std::shared_lock registry_lock(registry_mutex_);
-        auto it = clients_.find(client_id);
-        if (it == clients_.end()) {
+        const size_t slot = registry_.find(client_id);
+        if (slot == ClientRegistry::NO_SLOT) {
             throw std::runtime_error("Unknown client: " + client_id);
         }
-        client = it->second;
-    }
-
-    std::lock_guard client_lock(client->mutex);
-    uint64_t count = 0;
-    for (auto& q : client->queues) {
-        count += static_cast<uint64_t>(q.size());
-        q.clear();
+        ClientState* client = registry_.state(slot).get();
+        std::lock_guard client_lock(client->mutex);
+        count = discard_queued(*client, hooked);
+        client->notify_space();
     }
-    client->submit_cv_.notify_all();
+    for (auto& job : hooked) discard(job, CompletionStatus::CANCELLED);
     return count;
 }
 
@@ -180,7 +684,10 @@ void Scheduler::drain_all_clients() {
     std::vector<std::string> ids;
     {
         std::shared_lock lock(registry_mutex_);
-        ids = client_order_;
+        ids.reserve(registry_.size());
+        for (size_t slot = 0; slot < registry_.slot_count(); ++slot) {
+            if (const auto& client = registry_.state(slot)) ids.push_back(client->client_id);
+        }
     }
     for (const auto& id : ids) {
         try { drain_client(id); } catch (const std::runtime_error&) {}
@@ -191,63 +698,106 @@ void Scheduler::set_observer(std::shared_ptr<IMetricsObserver> observer) {
     observer_.store(std::move(observer), std::memory_order_release);
 }
 
+void Scheduler::set_trace_recorder(std::shared_ptr<TraceRecorder> recorder) {
+    if (recorder) recorder->start(clock_->now());
+    trace_.store(std::move(recorder), std::memory_order_release);
+}
+
+void Scheduler::set_event_log(std::shared_ptr<EventLog> log) {
+    event_log_.store(std::move(log), std::memory_order_release);
+}
+
+void Scheduler::set_help_while_blocked(bool enabled) {
+    help_while_blocked_.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Scheduler::discard_queued(ClientState& client, std::vector<Job>& hooked) {
+    auto log = event_log_.load(std::memory_order_acquire);
+    const auto now = log ? clock_->now() : std::chrono::steady_clock::time_point{};
+    uint64_t count = 0;
+    for (auto& q : client.queues) {
+        if (!q) continue;
+        for (auto& job : *q) {
+            if (log) log->record(EventType::CANCEL, client.client_id, job.job_id, 0, now);
+            if (job.wants_discard_notice()) hooked.push_back(std::move(job));
+        }
+        count += static_cast<uint64_t>(q->size());
+        q.reset(); // back to the idle footprint
+    }
+    registry_.sync_depth(client);
+    return count;
+}
+
+void Scheduler::discard(Job& job, CompletionStatus status) {
+    if (CompletionQueue* cq = job.completion_queue()) {
+        cq->post(job.job_id, job.user_tag(), status, std::chrono::microseconds{0});
+    }
+    job.task.discard();
+}
+
+void Scheduler::set_work_notifier(WorkNotifier notifier) {
+    work_notifier_.store(std::move(notifier), std::memory_order_release);
+}
+
+void Scheduler::clear_work_notifier(const WorkNotifier& notifier) {
+    WorkNotifier expected = notifier;
+    work_notifier_.compare_exchange_strong(expected, nullptr,
+                                           std::memory_order_acq_rel);
+}
+
 void Scheduler::update_client_weight(const std::string& client_id,
                                       size_t new_weight) {
     if (new_weight == 0) {
         throw std::invalid_argument("Client weight must be >= 1: " + client_id);
     }
-    std::shared_lock registry_lock(registry_mutex_);
-    auto it = clients_.find(client_id);
-    if (it == clients_.end()) {
+    std::unique_lock registry_lock(registry_mutex_);
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) {
         throw std::runtime_error("Unknown client: " + client_id);
     }
-    auto& client = it->second;
+    registry_.set_weight(slot, new_weight);
     std::lock_guard rr_lock(rr_mutex_);
-    client->weight = new_weight;
-    policy_->on_client_weight_updated(client_id, new_weight);
+    policy_->on_client_weight_updated(slot, new_weight);
 }
 
 uint64_t Scheduler::unregister_client(const std::string& client_id) {
+    JOB_SYSTEM_TRACE(lock_wait_begin, trace_ids::REGISTRY_EXCLUSIVE);
     std::unique_lock registry_lock(registry_mutex_);
-    auto it = clients_.find(client_id);
-    if (it == clients_.end()) {
+    JOB_SYSTEM_TRACE(lock_wait_end, trace_ids::REGISTRY_EXCLUSIVE);
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) {
         throw std::runtime_error("Unknown client: " + client_id);
     }
 
-    auto& client = it->second;
+    const auto& client = registry_.state(slot);
     uint64_t count = 0;
+    std::vector<Job> hooked;
     {
         std::lock_guard client_lock(client->mutex);
-        for (auto& q : client->queues) {
-            count += static_cast<uint64_t>(q.size());
-            q.clear();
-        }
-        client->submit_cv_.notify_all();
+        count = discard_queued(*client, hooked);
+        client->notify_space();
     }
 
     {
         std::lock_guard rr_lock(rr_mutex_);
-        policy_->on_client_unregistered(client_id);
-    }
-
-    clients_.erase(it);
-    auto order_it = std::find(client_order_.begin(), client_order_.end(), client_id);
-    if (order_it != client_order_.end()) {
-        client_order_.erase(order_it);
+        policy_->on_client_unregistered(slot);
     }
+    registry_.remove(slot);
 
+    registry_lock.unlock();
+    for (auto& job : hooked) discard(job, CompletionStatus::CANCELLED);
     return count;
 }
 
 Scheduler::ClientMetrics Scheduler::get_client_metrics(
     const std::string& client_id) const {
     std::shared_lock lock(registry_mutex_);
-    auto it = clients_.find(client_id);
-    if (it == clients_.end()) {
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) {
         throw std::runtime_error("Unknown client: " + client_id);
     }
 
-    const auto& client = it->second;
+    const auto& client = registry_.state(slot);
     ClientMetrics metrics;
     metrics.submitted =
         client->submitted_count.load(std::memory_order_relaxed);
@@ -266,11 +816,23 @@ Scheduler::ClientMetrics Scheduler::get_client_metrics(
         std::lock_guard client_lock(client->mutex);
         metrics.queue_depth = client->total_queued();
     }
-    metrics.weight         = client->weight;
-    metrics.overflow_count =
-        client->overflow_count.load(std::memory_order_relaxed);
+    metrics.weight         = registry_.weight(slot);
     metrics.expired_count =
         client->expired_count.load(std::memory_order_relaxed);
+    if (const ClientLimits* limits = client->limits.get()) {
+        metrics.overflow_count =
+            limits->overflow_count.load(std::memory_order_relaxed);
+        metrics.blocked_submits =
+            limits->blocked_count.load(std::memory_order_relaxed);
+        metrics.blocked_in_task =
+            limits->blocked_in_task_count.load(std::memory_order_relaxed);
+        metrics.priority_inversions =
+            limits->priority_inversion_count.load(std::memory_order_relaxed);
+        metrics.blocked_time_us =
+            limits->blocked_time_us.load(std::memory_order_relaxed);
+        metrics.helped_jobs =
+            limits->helped_count.load(std::memory_order_relaxed);
+    }
     return metrics;
 }
 
@@ -280,16 +842,19 @@ Scheduler::GlobalMetrics Scheduler::get_global_metrics() const {
 
     GlobalMetrics gm;
     gm.total_processed = total_processed_.load(std::memory_order_relaxed);
-    gm.active_clients  = clients_.size();
+    gm.active_clients  = registry_.size();
+    gm.tasks_blocked_in_submit = tasks_blocked_.load(std::memory_order_relaxed);
 
-    if (clients_.size() < 2) {
+    if (registry_.size() < 2) {
         gm.jain_fairness_index = 1.0;
         return gm;
     }
 
     double sum   = 0.0;
     double sum_sq = 0.0;
-    for (const auto& [_, client] : clients_) {
+    for (size_t slot = 0; slot < registry_.slot_count(); ++slot) {
+        const auto& client = registry_.state(slot);
+        if (!client) continue;
         double x = static_cast<double>(
             client->executed_count.load(std::memory_order_relaxed));
         sum    += x;
@@ -299,7 +864,7 @@ Scheduler::GlobalMetrics Scheduler::get_global_metrics() const {
     if (sum_sq == 0.0) {
         gm.jain_fairness_index = 1.0;
     } else {
-        double n = static_cast<double>(clients_.size());
+        double n = static_cast<double>(registry_.size());
         gm.jain_fairness_index = (sum * sum) / (n * sum_sq);
     }
     return gm;
@@ -313,22 +878,88 @@ void Scheduler::record_execution(const std::string& client_id,
                                   uint64_t job_id,
                                   std::chrono::microseconds duration) {
     std::shared_lock lock(registry_mutex_);
-    auto it = clients_.find(client_id);
-    if (it == clients_.end()) return;
+    const size_t slot = registry_.find(client_id);
+    if (slot == ClientRegistry::NO_SLOT) return;
+    record_execution(*registry_.state(slot), job_id, duration);
+}
 
-    it->second->executed_count.fetch_add(1, std::memory_order_relaxed);
-    it->second->total_execution_time_us.fetch_add(duration.count(),
-                                                   std::memory_order_relaxed);
+void Scheduler::record_execution(ClientState& client, uint64_t job_id,
+                                 std::chrono::microseconds duration) {
+    client.executed_count.fetch_add(1, std::memory_order_relaxed);
+    client.total_execution_time_us.fetch_add(duration.count(), std::memory_order_relaxed);
     total_processed_.fetch_add(1, std::memory_order_relaxed);
 
+    if (auto trace = trace_.load(std::memory_order_acquire)) {
+        trace->record_execution(client.client_id, job_id, duration, clock_->now());
+    }
+
     if (auto obs = observer_.load(std::memory_order_acquire)) {
-        obs->on_job_executed(client_id, job_id, duration);
+        obs->on_job_executed(client.client_id, job_id, duration);
     }
 }
 
+void Scheduler::execute(Job& job) {
+    execute(job, job.completion_queue() != nullptr);
+}
+
+void Scheduler::execute(Job& job, bool contain_failure) {
+    // Null if the client was unregistered after the job was dequeued
+    const std::shared_ptr<ClientState> client = client_at(job.client);
+    static const std::string unregistered;
+    const std::string& cid = client ? client->client_id : unregistered;
+    const uint64_t jid = job.job_id;
+    RunningJobScope running(this, job);
+    // Releases the task's captures when done, even if it throws
+    struct Release {
+        Job& job;
+        ~Release() {
+            job.task = nullptr;
+            job.extras.reset();
+        }
+    } release{job};
+
+    auto log = event_log_.load(std::memory_order_acquire);
+
+    JOB_SYSTEM_TRACE(execute_begin, cid.c_str(), jid);
+    auto start = clock_->now();
+    if (log) log->record(EventType::START, cid, jid, 0, start);
+    CompletionQueue* const cq = job.completion_queue();
+    CompletionStatus status = CompletionStatus::COMPLETED;
+    if (contain_failure) {
+        // Reported below: through the completion record and the observer
+        try {
+            job.run();
+        } catch (...) {
+            status = CompletionStatus::FAILED;
+        }
+    } else {
+        job.run();
+    }
+    auto end = clock_->now();
+    auto duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    JOB_SYSTEM_TRACE(execute_end, cid.c_str(), jid, duration.count());
+    if (log) {
+        log->record(EventType::COMPLETE, cid, jid,
+                    static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)), end);
+    }
+
+    if (client) record_execution(*client, jid, duration);
+    if (status == CompletionStatus::FAILED) {
+        if (auto obs = observer_.load(std::memory_order_acquire)) obs->on_job_failed(cid, jid);
+    }
+    if (cq) cq->post(jid, job.user_tag(), status, duration);
+}
+
+uint64_t Scheduler::current_job_id() const {
+    return tls_running.scheduler == this ? tls_running.job_id : 0;
+}
+
 bool Scheduler::has_pending_jobs() const {
     std::shared_lock lock(registry_mutex_);
-    for (const auto& [_, client] : clients_) {
+    for (size_t slot = 0; slot < registry_.slot_count(); ++slot) {
+        const auto& client = registry_.state(slot);
+        if (!client) continue;
         std::lock_guard client_lock(client->mutex);
         if (client->any_queued()) return true;
     }
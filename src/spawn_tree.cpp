@@ -0,0 +1,149 @@
+#include "job_system/spawn_tree.h"
+
+#include <algorithm>
+
+namespace job_system {
+
+namespace {
+
+uint64_t gap(uint64_t from, uint64_t to) { return to > from ? to - from : 0; }
+
+} // namespace
+
+uint64_t SpawnTree::path_queue_ns() const {
+    uint64_t total = 0;
+    for (const auto& step : critical_path) total += step.queue_ns;
+    return total;
+}
+
+uint64_t SpawnTree::path_run_ns() const {
+    uint64_t total = 0;
+    for (const auto& step : critical_path) total += step.run_ns;
+    return total;
+}
+
+void SpawnTreeAnalyzer::add(const LogEvent& ev) {
+    switch (ev.type) {
+    case EventType::SPAWN: {
+        Node& n = nodes_[ev.job_id];
+        n.parent = ev.extra;
+        n.spawn_ns = ev.timestamp_ns;
+        n.client = ev.client;
+        ++nodes_[ev.extra].children;
+        break;
+    }
+    case EventType::SUBMIT: {
+        Node& n = nodes_[ev.job_id];
+        n.submit_ns = ev.timestamp_ns;
+        n.client = ev.client;
+        break;
+    }
+    case EventType::START:
+        nodes_[ev.job_id].start_ns = ev.timestamp_ns;
+        break;
+    case EventType::COMPLETE:
+        nodes_[ev.job_id].complete_ns = ev.timestamp_ns;
+        break;
+    default:
+        break;
+    }
+}
+
+std::vector<SpawnTree> SpawnTreeAnalyzer::trees(size_t min_size) const {
+    // Resolve every job's root (its oldest logged ancestor) and depth
+    struct Resolved {
+        uint64_t root;
+        size_t depth;
+    };
+    std::unordered_map<uint64_t, Resolved> resolved;
+    resolved.reserve(nodes_.size());
+    std::vector<uint64_t> chain;
+    for (const auto& [id, _] : nodes_) {
+        chain.clear();
+        uint64_t cur = id;
+        Resolved base{0, 0};
+        while (true) {
+            if (auto r = resolved.find(cur); r != resolved.end()) {
+                base = r->second;
+                break;
+            }
+            chain.push_back(cur);
+            const auto it = nodes_.find(cur);
+            const uint64_t parent = it->second.parent;
+            if (parent == 0 || nodes_.find(parent) == nodes_.end() ||
+                nodes_.at(parent).submit_ns == 0) {
+                base = {cur, 0};
+                resolved.emplace(cur, base);
+                chain.pop_back();
+                break;
+            }
+            cur = parent;
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            base = {base.root, base.depth + 1};
+            resolved.emplace(*it, base);
+        }
+    }
+
+    std::unordered_map<uint64_t, SpawnTree> by_root;
+    std::unordered_map<uint64_t, uint64_t> last_job; // root → latest completer
+    for (const auto& [id, node] : nodes_) {
+        const Resolved& r = resolved.at(id);
+        SpawnTree& t = by_root[r.root];
+        t.root_id = r.root;
+        ++t.size;
+        t.depth = std::max(t.depth, r.depth);
+        t.max_fanout = std::max<size_t>(t.max_fanout, node.children);
+        if (node.complete_ns > t.end_ns) {
+            t.end_ns = node.complete_ns;
+            last_job[r.root] = id;
+        }
+    }
+
+    std::vector<SpawnTree> out;
+    for (auto& [root, t] : by_root) {
+        const Node& root_node = nodes_.at(root);
+        if (t.size < min_size || root_node.submit_ns == 0 || t.end_ns == 0) continue;
+        t.submit_ns = root_node.submit_ns;
+
+        std::vector<uint64_t> path;
+        for (uint64_t cur = last_job.at(root);; cur = nodes_.at(cur).parent) {
+            path.push_back(cur);
+            if (cur == root) break;
+        }
+        std::reverse(path.begin(), path.end());
+
+        for (size_t i = 0; i < path.size(); ++i) {
+            const Node& n = nodes_.at(path[i]);
+            const uint64_t enqueued = n.submit_ns ? n.submit_ns : n.spawn_ns;
+            CriticalPathStep step;
+            step.job_id = path[i];
+            step.client = n.client;
+            step.queue_ns = gap(enqueued, n.start_ns);
+            if (i + 1 < path.size()) {
+                const Node& next = nodes_.at(path[i + 1]);
+                step.run_ns = gap(n.start_ns, next.submit_ns ? next.submit_ns : next.spawn_ns);
+            } else {
+                step.run_ns = gap(n.start_ns, n.complete_ns);
+            }
+            t.critical_path.push_back(step);
+        }
+        out.push_back(std::move(t));
+    }
+
+    std::sort(out.begin(), out.end(), [](const SpawnTree& a, const SpawnTree& b) {
+        if (a.latency_ns() != b.latency_ns()) return a.latency_ns() > b.latency_ns();
+        return a.root_id < b.root_id;
+    });
+    return out;
+}
+
+std::vector<uint32_t> SpawnTreeAnalyzer::fanouts() const {
+    std::vector<uint32_t> out;
+    for (const auto& [_, node] : nodes_) {
+        if (node.children > 0) out.push_back(node.children);
+    }
+    return out;
+}
+
+} // namespace job_system
@@ -0,0 +1,166 @@
+#include "job_system/submit_buffer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace job_system {
+
+SubmitBuffer::SubmitBuffer(Scheduler& scheduler)
+    : SubmitBuffer(scheduler, SubmitBufferOptions{}) {}
+
+SubmitBuffer::SubmitBuffer(Scheduler& scheduler, SubmitBufferOptions options)
+    : scheduler_(scheduler)
+    , options_(options) {
+    if (options_.max_jobs == 0) {
+        throw std::invalid_argument("SubmitBuffer max_jobs must be positive");
+    }
+    if (options_.id_block == 0) {
+        throw std::invalid_argument("SubmitBuffer id_block must be positive");
+    }
+    if (options_.max_delay.count() > 0) {
+        timer_ = std::jthread([this](std::stop_token stop_token) { timer_loop(stop_token); });
+    }
+}
+
+SubmitBuffer::~SubmitBuffer() {
+    if (timer_.joinable()) {
+        timer_.request_stop();
+        timer_.join();
+    }
+    std::unique_lock lock(mutex_);
+    try {
+        flush_from(lock);
+    } catch (...) {
+        // Admission failed (out of memory); there is no one left to tell
+    }
+}
+
+uint64_t SubmitBuffer::submit(const std::string& client_id, Task task, uint32_t cost_hint,
+                              Priority priority,
+                              std::chrono::steady_clock::time_point deadline) {
+    Job job;
+    job.task = std::move(task);
+    job.set_cost_hint(cost_hint);
+    job.set_priority(priority);
+    return submit(client_id, std::move(job), deadline);
+}
+
+uint64_t SubmitBuffer::submit_raw(const std::string& client_id, Job::RawHandler handler,
+                                  std::span<const std::byte> payload, uint32_t cost_hint,
+                                  Priority priority,
+                                  std::chrono::steady_clock::time_point deadline) {
+    Job job;
+    job.set_raw(handler, payload);
+    job.set_cost_hint(cost_hint);
+    job.set_priority(priority);
+    return submit(client_id, std::move(job), deadline);
+}
+
+uint64_t SubmitBuffer::submit(const std::string& client_id, Job job,
+                              std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock lock(mutex_);
+    rethrow_deferred();
+    if (next_id_ == id_end_) {
+        next_id_ = scheduler_.reserve_job_ids(options_.id_block);
+        id_end_ = next_id_ + options_.id_block;
+    }
+    const uint64_t job_id = next_id_++;
+    job.job_id = job_id;
+    scheduler_.assign_lineage(job);
+    // Queue wait and deadlines count from here, not from the flush
+    scheduler_.stamp(job, deadline);
+
+    // Producers usually feed one client at a time
+    if (last_batch_ >= batches_.size() || batches_[last_batch_].client_id != client_id) {
+        auto it = std::find_if(batches_.begin(), batches_.end(),
+                               [&](const Batch& b) { return b.client_id == client_id; });
+        if (it == batches_.end()) {
+            batches_.push_back(Batch{client_id, {}});
+            it = batches_.end() - 1;
+        }
+        last_batch_ = static_cast<size_t>(it - batches_.begin());
+    }
+    batches_[last_batch_].jobs.push_back(std::move(job));
+
+    if (pending_++ == 0 && timer_.joinable()) {
+        oldest_ = std::chrono::steady_clock::now();
+        timer_cv_.notify_one();
+    }
+    if (pending_ >= options_.max_jobs) flush_from(lock);
+    return job_id;
+}
+
+size_t SubmitBuffer::flush() {
+    std::unique_lock lock(mutex_);
+    rethrow_deferred();
+    return flush_from(lock);
+}
+
+size_t SubmitBuffer::pending() const {
+    std::lock_guard lock(mutex_);
+    return pending_;
+}
+
+size_t SubmitBuffer::flush_from(std::unique_lock<std::mutex>& lock) {
+    if (pending_ == 0) return 0;
+    // flush_mutex_ comes first in the lock order
+    lock.unlock();
+    std::lock_guard flush_lock(flush_mutex_);
+    lock.lock();
+    if (pending_ == 0) return 0;
+
+    // Admitted jobs leave their (empty) vectors behind for the next round
+    std::vector<Batch> batches;
+    batches.swap(batches_);
+    const size_t flushed = pending_;
+    pending_ = 0;
+    last_batch_ = 0;
+    lock.unlock();
+
+    uint64_t refused = 0;
+    std::exception_ptr error;
+    for (auto& batch : batches) {
+        if (batch.jobs.empty()) continue;
+        try {
+            scheduler_.submit_batch(batch.client_id, batch.jobs, refused);
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    refused_.fetch_add(refused, std::memory_order_relaxed);
+    flushes_.fetch_add(1, std::memory_order_relaxed);
+
+    lock.lock();
+    // Keep the emptied vectors' capacity unless new clients appeared meanwhile
+    if (batches_.empty()) batches_.swap(batches);
+    if (error) std::rethrow_exception(error);
+    return flushed;
+}
+
+void SubmitBuffer::timer_loop(std::stop_token stop_token) {
+    std::unique_lock lock(mutex_);
+    while (!stop_token.stop_requested()) {
+        if (pending_ == 0) {
+            timer_cv_.wait(lock, stop_token, [this] { return pending_ > 0; });
+            continue;
+        }
+        const auto due = oldest_ + options_.max_delay;
+        if (std::chrono::steady_clock::now() < due) {
+            // Woken early if the producer flushes in the meantime
+            timer_cv_.wait_until(lock, stop_token, due, [this] { return pending_ == 0; });
+            continue;
+        }
+        try {
+            flush_from(lock);
+        } catch (...) {
+            if (!deferred_error_) deferred_error_ = std::current_exception();
+        }
+    }
+}
+
+void SubmitBuffer::rethrow_deferred() {
+    if (deferred_error_) std::rethrow_exception(std::exchange(deferred_error_, nullptr));
+}
+
+} // namespace job_system
@@ -1,14 +1,83 @@
 #include "job_system/thread_pool.h"
 
 #include <chrono>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace job_system {
 
+namespace {
+
+// Spin-wait hint: lets the sibling hyperthread run and saves power
+inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+void validate_affinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) return;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        throw std::runtime_error("sched_getaffinity failed");
+    }
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)) {
+            throw std::invalid_argument("CPU not available for worker affinity: " +
+                                        std::to_string(cpu));
+        }
+    }
+#else
+    (void)cpus;
+#endif
+}
+
+// Best effort: the set was validated up front, so failure here only means
+// the allowed set changed underneath us
+void pin_current_thread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
 ThreadPool::ThreadPool(Scheduler& scheduler, size_t worker_count)
-    : scheduler_(scheduler) {
+    : ThreadPool(scheduler, worker_count, ThreadPoolOptions{}) {}
+
+ThreadPool::ThreadPool(Scheduler& scheduler, size_t worker_count,
+                       ThreadPoolOptions options)
+    : scheduler_(scheduler)
+    , options_(std::move(options))
+    , wake_(std::make_shared<WakeState>()) {
+    validate_affinity(options_.cpu_affinity);
+
+    notifier_ = std::make_shared<std::function<void()>>(
+        [wake = wake_] { wake->notify_one(); });
+    scheduler_.set_work_notifier(notifier_);
+
     workers_.reserve(worker_count);
     for (size_t i = 0; i < worker_count; ++i) {
-        workers_.emplace_back([this](std::stop_token st) { worker_loop(st); });
+        workers_.emplace_back([this, i](std::stop_token st) { worker_loop(st, i); });
     }
 }
 
@@ -24,25 +93,26 @@ void ThreadPool::shutdown(ShutdownMode mode) {
         scheduler_.drain_all_clients();
         running_.store(false, std::memory_order_release);
         draining_.store(true, std::memory_order_release);
-        cv_.notify_all();
+        wake_->cv.notify_all();
         for (auto& w : workers_) w.request_stop();
         workers_.clear();
+        scheduler_.clear_work_notifier(notifier_);
         return;
     }
 
     // GRACEFUL — existing logic: drain queues then stop
     draining_.store(true, std::memory_order_release);
-    cv_.notify_all();
+    wake_->cv.notify_all();
 
     // Spin until all jobs are drained
     while (scheduler_.has_pending_jobs()) {
-        cv_.notify_all();
+        wake_->cv.notify_all();
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
     // All queues empty — tell workers to stop
     running_.store(false, std::memory_order_release);
-    cv_.notify_all();
+    wake_->cv.notify_all();
 
     // Request stop on all jthreads and let destructors join
     for (auto& w : workers_) {
@@ -50,6 +120,7 @@ void ThreadPool::shutdown(ShutdownMode mode) {
     }
     // jthread destructor calls request_stop + join automatically
     workers_.clear();
+    scheduler_.clear_work_notifier(notifier_);
 }
 
 bool ThreadPool::is_running() const {
@@ -58,13 +129,48 @@ bool ThreadPool::is_running() const {
 
 size_t ThreadPool::worker_count() const { return workers_.size(); }
 
-void ThreadPool::notify_workers() { cv_.notify_one(); }
+void ThreadPool::notify_workers() { wake_->notify_one(); }
 
-void ThreadPool::worker_loop(std::stop_token stop_token) {
+void ThreadPool::WakeState::notify_one() {
+    // seq_cst pairs with the sleeper registration in worker_loop: either the
+    // worker sees the new epoch before parking, or we see it as a sleeper.
+    epoch.fetch_add(1);
+    if (sleepers.load() == 0) return;
+    { std::lock_guard lock(cv_mutex); } // serialize with a parking worker
+    cv.notify_one();
+}
+
+bool ThreadPool::idle_poll(const std::stop_token& stop_token,
+                           uint64_t seen_epoch) const {
+    const bool spin = options_.idle_strategy == IdleStrategy::SPIN_THEN_BLOCK;
+    const auto spin_until = std::chrono::steady_clock::now() + options_.spin_duration;
+    while (!stop_token.stop_requested() &&
+           !draining_.load(std::memory_order_acquire) &&
+           running_.load(std::memory_order_acquire)) {
+        if (wake_->epoch.load() != seen_epoch) return true;
+        if (spin) {
+            if (std::chrono::steady_clock::now() >= spin_until) return false;
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(std::stop_token stop_token, size_t index) {
+    if (!options_.cpu_affinity.empty()) {
+        pin_current_thread(options_.cpu_affinity[index % options_.cpu_affinity.size()]);
+    }
+
+    // Jobs are dequeued straight into this slot and run from it
+    Job job;
     while (!stop_token.stop_requested()) {
-        auto job = scheduler_.select_next_job();
+        // Snapshot before selecting so an enqueue that races with an empty
+        // select is seen as a new epoch and the wait below does not park.
+        const uint64_t seen_epoch = wake_->epoch.load();
 
-        if (!job.has_value()) {
+        if (!scheduler_.select_next_job(job)) {
             // No work available
             if (draining_.load(std::memory_order_acquire) &&
                 !scheduler_.has_pending_jobs()) {
@@ -77,28 +183,31 @@ void ThreadPool::worker_loop(std::stop_token stop_token) {
                 continue; // Jobs appeared — keep processing
             }
 
+            switch (options_.idle_strategy) {
+            case IdleStrategy::YIELD:
+                idle_poll(stop_token, seen_epoch);
+                continue;
+            case IdleStrategy::SPIN_THEN_BLOCK:
+                if (idle_poll(stop_token, seen_epoch)) continue;
+                break;
+            case IdleStrategy::BLOCK:
+                break;
+            }
+
             // Wait for new work or shutdown signal
-            std::unique_lock lock(cv_mutex_);
-            cv_.wait(lock, stop_token, [this] {
-                return draining_.load(std::memory_order_acquire) ||
+            std::unique_lock lock(wake_->cv_mutex);
+            wake_->sleepers.fetch_add(1);
+            wake_->cv.wait(lock, stop_token, [this, seen_epoch] {
+                return wake_->epoch.load() != seen_epoch ||
+                       draining_.load(std::memory_order_acquire) ||
                        !running_.load(std::memory_order_acquire);
             });
+            wake_->sleepers.fetch_sub(1);
             continue;
         }
 
         // Execute the job outside any scheduler/client lock
-        const std::string cid = job->client_id;
-        const uint64_t jid = job->job_id;
-
-        auto start = std::chrono::steady_clock::now();
-        if (job->task) {
-            job->task();
-        }
-        auto end = std::chrono::steady_clock::now();
-        auto duration =
-            std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-        scheduler_.record_execution(cid, jid, duration);
+        scheduler_.execute(job);
     }
 }
 
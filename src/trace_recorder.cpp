@@ -0,0 +1,224 @@
+#include "job_system/trace_recorder.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace job_system {
+
+namespace {
+
+constexpr char MAGIC[8] = {'J', 'S', 'T', 'R', 'A', 'C', 'E', '1'};
+
+constexpr uint8_t TAG_CLIENT    = 'C';
+constexpr uint8_t TAG_ARRIVAL   = 'A';
+constexpr uint8_t TAG_EXECUTION = 'E';
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder(const std::string& path) : path_(path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    buffer_.reserve(FLUSH_BYTES + 64);
+    buffer_.insert(buffer_.end(), std::begin(MAGIC), std::end(MAGIC));
+}
+
+TraceRecorder::~TraceRecorder() {
+    std::lock_guard lock(mutex_);
+    flush_locked();
+    std::fclose(file_);
+}
+
+void TraceRecorder::start(std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock(mutex_);
+    if (started_) return;
+    last_ts_ = now;
+    started_ = true;
+}
+
+void TraceRecorder::record_arrival(const ClientState& client, size_t weight, uint64_t job_id,
+                                   uint32_t cost_hint, Priority priority,
+                                   std::chrono::steady_clock::time_point deadline,
+                                   std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock(mutex_);
+    const uint32_t idx = client_index(client, weight);
+    buffer_.push_back(TAG_ARRIVAL);
+    put_varint(take_delta_ns(now));
+    put_varint(idx);
+    put_varint(job_id);
+    put_varint(cost_hint);
+    put_varint(static_cast<uint64_t>(priority));
+    if (deadline == std::chrono::steady_clock::time_point{}) {
+        put_varint(0);
+    } else {
+        auto rel = std::chrono::duration_cast<std::chrono::microseconds>(
+            deadline - now);
+        put_varint(zigzag(rel.count()) + 1);
+    }
+    ++records_;
+    ++pending_;
+    if (buffer_.size() >= FLUSH_BYTES) flush_locked();
+}
+
+void TraceRecorder::record_execution(const std::string& client_id,
+                                     uint64_t job_id,
+                                     std::chrono::microseconds duration,
+                                     std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock(mutex_);
+    auto it = client_index_.find(client_id);
+    if (it == client_index_.end()) return; // submitted before recording began
+    buffer_.push_back(TAG_EXECUTION);
+    put_varint(take_delta_ns(now));
+    put_varint(it->second);
+    put_varint(job_id);
+    put_varint(static_cast<uint64_t>(duration.count() > 0 ? duration.count() : 0));
+    ++records_;
+    ++pending_;
+    if (buffer_.size() >= FLUSH_BYTES) flush_locked();
+}
+
+void TraceRecorder::flush() {
+    std::lock_guard lock(mutex_);
+    flush_locked();
+    if (write_failed_) {
+        throw std::runtime_error("Cannot write trace file: " + path_ + " (" +
+                                 std::to_string(lost_) + " records lost)");
+    }
+}
+
+uint64_t TraceRecorder::records_written() const {
+    std::lock_guard lock(mutex_);
+    return records_;
+}
+
+uint64_t TraceRecorder::records_lost() const {
+    std::lock_guard lock(mutex_);
+    return lost_;
+}
+
+uint32_t TraceRecorder::client_index(const ClientState& client, size_t weight) {
+    auto it = client_index_.find(client.client_id);
+    if (it != client_index_.end()) return it->second;
+
+    const auto idx = static_cast<uint32_t>(client_index_.size());
+    client_index_.emplace(client.client_id, idx);
+    buffer_.push_back(TAG_CLIENT);
+    put_varint(idx);
+    put_varint(weight);
+    put_varint(client.max_queue_depth());
+    put_varint(static_cast<uint64_t>(client.overflow_strategy()));
+    put_varint(client.client_id.size());
+    buffer_.insert(buffer_.end(), client.client_id.begin(), client.client_id.end());
+    return idx;
+}
+
+uint64_t TraceRecorder::take_delta_ns(std::chrono::steady_clock::time_point now) {
+    if (!started_) {
+        last_ts_ = now; // recorded without start(): the first record is at 0
+        started_ = true;
+    }
+    const auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_ts_);
+    last_ts_ = now;
+    return static_cast<uint64_t>(delta.count() > 0 ? delta.count() : 0);
+}
+
+void TraceRecorder::put_varint(uint64_t v) {
+    while (v >= 0x80) {
+        buffer_.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    buffer_.push_back(static_cast<uint8_t>(v));
+}
+
+void TraceRecorder::flush_locked() {
+    if (buffer_.empty()) return;
+    // Records after a failed write could not be read past the torn one
+    if (write_failed_ || std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size() ||
+        std::fflush(file_) != 0) {
+        write_failed_ = true;
+        lost_ += pending_;
+    }
+    buffer_.clear();
+    pending_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// TraceReader
+// ---------------------------------------------------------------------------
+
+TraceReader::TraceReader(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                                    std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(MAGIC) ||
+        std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a job_system trace: " + path);
+    }
+
+    size_t pos = sizeof(MAGIC);
+    auto get = [&]() -> uint64_t {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) throw std::runtime_error("Truncated trace: " + path);
+            const uint8_t b = data[pos++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw std::runtime_error("Malformed varint in trace: " + path);
+    };
+
+    uint64_t ts = 0;
+    while (pos < data.size()) {
+        const uint8_t tag = data[pos++];
+        if (tag == TAG_CLIENT) {
+            TraceClient c;
+            const auto idx = get();
+            c.weight = static_cast<size_t>(get());
+            c.max_queue_depth = static_cast<size_t>(get());
+            c.overflow_strategy = static_cast<OverflowStrategy>(get());
+            const auto len = static_cast<size_t>(get());
+            if (pos + len > data.size()) throw std::runtime_error("Truncated trace: " + path);
+            c.name.assign(reinterpret_cast<const char*>(data.data() + pos), len);
+            pos += len;
+            if (idx != clients_.size()) throw std::runtime_error("Bad client index in trace: " + path);
+            clients_.push_back(std::move(c));
+        } else if (tag == TAG_ARRIVAL || tag == TAG_EXECUTION) {
+            TraceEvent ev;
+            ts += get();
+            ev.timestamp_ns = ts;
+            ev.client = static_cast<uint32_t>(get());
+            ev.job_id = get();
+            if (ev.client >= clients_.size()) throw std::runtime_error("Unknown client in trace: " + path);
+            if (tag == TAG_ARRIVAL) {
+                ev.type = TraceEvent::Type::ARRIVAL;
+                ev.cost_hint = static_cast<uint32_t>(get());
+                ev.priority = static_cast<Priority>(get());
+                const uint64_t dl = get();
+                ev.has_deadline = dl != 0;
+                ev.deadline_us = dl ? unzigzag(dl - 1) : 0;
+            } else {
+                ev.type = TraceEvent::Type::EXECUTION;
+                ev.duration_us = get();
+            }
+            events_.push_back(ev);
+        } else {
+            throw std::runtime_error("Unknown record tag in trace: " + path);
+        }
+    }
+}
+
+} // namespace job_system
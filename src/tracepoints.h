@@ -0,0 +1,130 @@
+#pragma once
+
+// Static tracepoints on the scheduler hot paths.
+//
+//   JOB_SYSTEM_TRACE(name, args...)   — up to 4 scalar arguments
+//
+// Built with JOB_SYSTEM_TRACEPOINTS=0 every tracepoint expands to nothing and
+// its arguments are not evaluated. Built with JOB_SYSTEM_TRACEPOINTS=1 (the
+// CMake default) each one is a USDT probe in provider "job_system": a single
+// `nop` in the instruction stream plus an ELF .note.stapsdt entry describing
+// where the arguments live. perf, bpftrace, SystemTap and gdb find the probes
+// in the note and patch the nop only while attached, so an unattached probe
+// costs the nop and keeping its arguments in registers.
+//
+// <sys/sdt.h> (systemtap-sdt-dev) is used when available. Otherwise x86-64
+// ELF builds emit the same note format directly; other targets fall back to
+// no-op tracepoints. The probe list and argument meanings are in
+// docs/TRACEPOINTS.md.
+
+#ifndef JOB_SYSTEM_TRACEPOINTS
+#define JOB_SYSTEM_TRACEPOINTS 0
+#endif
+
+#if JOB_SYSTEM_TRACEPOINTS && __has_include(<sys/sdt.h>)
+
+#include <sys/sdt.h>
+#define JOB_SYSTEM_TRACE(...) JOB_SYSTEM_TRACE_N_(__VA_ARGS__)
+#define JOB_SYSTEM_TRACE_SDT_ 1
+
+#elif JOB_SYSTEM_TRACEPOINTS && defined(__x86_64__) && defined(__ELF__) && \
+    (defined(__GNUC__) || defined(__clang__))
+
+#include <type_traits>
+
+// Argument descriptor for the note: "<size>@<operand>", size negative for
+// signed types. %n prints the negated constant, as <sys/sdt.h> does.
+#define JOB_SYSTEM_SDT_SIZE_(x)                                                  \
+    ((std::is_signed_v<std::decay_t<decltype(x)>> ? 1 : -1) *                    \
+     static_cast<int>(sizeof(x)))
+#define JOB_SYSTEM_SDT_IN_(n, x) [s##n] "n"(JOB_SYSTEM_SDT_SIZE_(x)), [a##n] "nor"(x)
+#define JOB_SYSTEM_SDT_FMT_(n) "%n[s" #n "]@%[a" #n "]"
+
+#define JOB_SYSTEM_SDT_ASM_(name, args)                                          \
+    "990: nop\n"                                                                 \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                \
+    ".balign 4\n"                                                                \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                           \
+    "991: .asciz \"stapsdt\"\n"                                                  \
+    "992: .balign 4\n"                                                           \
+    "993: .8byte 990b\n"                                                         \
+    ".8byte _.stapsdt.base\n"                                                    \
+    ".8byte 0\n"                                                                 \
+    ".asciz \"job_system\"\n"                                                    \
+    ".asciz \"" #name "\"\n"                                                     \
+    ".asciz \"" args "\"\n"                                                      \
+    "994: .balign 4\n"                                                           \
+    ".popsection\n"                                                              \
+    ".ifndef _.stapsdt.base\n"                                                   \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"      \
+    ".weak _.stapsdt.base\n"                                                     \
+    ".hidden _.stapsdt.base\n"                                                   \
+    "_.stapsdt.base: .space 1\n"                                                 \
+    ".size _.stapsdt.base, 1\n"                                                  \
+    ".popsection\n"                                                              \
+    ".endif\n"
+
+#define JOB_SYSTEM_SDT0_(name) __asm__ __volatile__(JOB_SYSTEM_SDT_ASM_(name, ""))
+#define JOB_SYSTEM_SDT1_(name, a1)                                               \
+    __asm__ __volatile__(JOB_SYSTEM_SDT_ASM_(name, JOB_SYSTEM_SDT_FMT_(1))       \
+                         : : JOB_SYSTEM_SDT_IN_(1, a1))
+#define JOB_SYSTEM_SDT2_(name, a1, a2)                                           \
+    __asm__ __volatile__(                                                        \
+        JOB_SYSTEM_SDT_ASM_(name, JOB_SYSTEM_SDT_FMT_(1) " "                     \
+                                      JOB_SYSTEM_SDT_FMT_(2))                    \
+        : : JOB_SYSTEM_SDT_IN_(1, a1), JOB_SYSTEM_SDT_IN_(2, a2))
+#define JOB_SYSTEM_SDT3_(name, a1, a2, a3)                                       \
+    __asm__ __volatile__(                                                        \
+        JOB_SYSTEM_SDT_ASM_(name, JOB_SYSTEM_SDT_FMT_(1) " "                     \
+                                      JOB_SYSTEM_SDT_FMT_(2) " "                 \
+                                      JOB_SYSTEM_SDT_FMT_(3))                    \
+        : : JOB_SYSTEM_SDT_IN_(1, a1), JOB_SYSTEM_SDT_IN_(2, a2),                \
+            JOB_SYSTEM_SDT_IN_(3, a3))
+#define JOB_SYSTEM_SDT4_(name, a1, a2, a3, a4)                                   \
+    __asm__ __volatile__(                                                        \
+        JOB_SYSTEM_SDT_ASM_(name, JOB_SYSTEM_SDT_FMT_(1) " "                     \
+                                      JOB_SYSTEM_SDT_FMT_(2) " "                 \
+                                      JOB_SYSTEM_SDT_FMT_(3) " "                 \
+                                      JOB_SYSTEM_SDT_FMT_(4))                    \
+        : : JOB_SYSTEM_SDT_IN_(1, a1), JOB_SYSTEM_SDT_IN_(2, a2),                \
+            JOB_SYSTEM_SDT_IN_(3, a3), JOB_SYSTEM_SDT_IN_(4, a4))
+
+#define JOB_SYSTEM_TRACE(...) JOB_SYSTEM_TRACE_N_(__VA_ARGS__)
+#define JOB_SYSTEM_TRACE_SDT_ 0
+
+#else
+
+#define JOB_SYSTEM_TRACE(...) ((void)0)
+
+#endif
+
+#ifdef JOB_SYSTEM_TRACE_SDT_
+// Dispatch on argument count to <sys/sdt.h>'s STAP_PROBEn or the built-in
+// JOB_SYSTEM_SDTn_
+#define JOB_SYSTEM_TRACE_PICK_(_0, _1, _2, _3, _4, N, ...) N
+#define JOB_SYSTEM_TRACE_CAT_(a, b) a##b
+#define JOB_SYSTEM_TRACE_SELECT_(n) JOB_SYSTEM_TRACE_CAT_(JOB_SYSTEM_TRACE_IMPL_, n)
+#define JOB_SYSTEM_TRACE_N_(...)                                                 \
+    JOB_SYSTEM_TRACE_SELECT_(                                                    \
+        JOB_SYSTEM_TRACE_PICK_(__VA_ARGS__, 4, 3, 2, 1, 0, ~))(__VA_ARGS__)
+#if JOB_SYSTEM_TRACE_SDT_
+#define JOB_SYSTEM_TRACE_IMPL_0(name) STAP_PROBE(job_system, name)
+#define JOB_SYSTEM_TRACE_IMPL_1(name, ...) STAP_PROBE1(job_system, name, __VA_ARGS__)
+#define JOB_SYSTEM_TRACE_IMPL_2(name, ...) STAP_PROBE2(job_system, name, __VA_ARGS__)
+#define JOB_SYSTEM_TRACE_IMPL_3(name, ...) STAP_PROBE3(job_system, name, __VA_ARGS__)
+#define JOB_SYSTEM_TRACE_IMPL_4(name, ...) STAP_PROBE4(job_system, name, __VA_ARGS__)
+#else
+#define JOB_SYSTEM_TRACE_IMPL_0(name) JOB_SYSTEM_SDT0_(name)
+#define JOB_SYSTEM_TRACE_IMPL_1(name, ...) JOB_SYSTEM_SDT1_(name, __VA_ARGS__)
+#define JOB_SYSTEM_TRACE_IMPL_2(name, ...) JOB_SYSTEM_SDT2_(name, __VA_ARGS__)
+#define JOB_SYSTEM_TRACE_IMPL_3(name, ...) JOB_SYSTEM_SDT3_(name, __VA_ARGS__)
+#define JOB_SYSTEM_TRACE_IMPL_4(name, ...) JOB_SYSTEM_SDT4_(name, __VA_ARGS__)
+#endif
+#endif
+
+namespace job_system::trace_ids {
+
+// lock_wait_begin / lock_wait_end argument: which lock is being acquired
+enum : int { REGISTRY_SHARED = 1, REGISTRY_EXCLUSIVE = 2, POLICY = 3, CLIENT = 4 };
+
+} // namespace job_system::trace_ids
@@ -1,48 +1,55 @@
 #include "job_system/wrr_policy.h"
 
+#include <algorithm>
+
 namespace job_system {
 
-void WeightedRoundRobinPolicy::on_client_registered(
-    const std::string& /*client_id*/, size_t /*weight*/) {
-    // WRR reads weight directly from ClientState — nothing to initialise
+void WeightedRoundRobinPolicy::on_client_registered(size_t slot, size_t /*weight*/) {
+    // WRR reads weight from the registry's column — only the debt to reset
+    if (debt_.size() <= slot) debt_.resize(slot + 1);
+    debt_[slot] = 0;
 }
 
-std::optional<Job> WeightedRoundRobinPolicy::select_next_job(
-    const std::vector<std::string>& client_order,
-    const ClientMap& clients) {
-    const size_t n = client_order.size();
+bool WeightedRoundRobinPolicy::select_next_job(const ClientRegistry& clients, Job& out) {
+    const size_t n = clients.slot_count();
 
     for (size_t scanned = 0; scanned < n; ++scanned) {
-        auto& client = clients.at(client_order[rr_index_]);
-
-        // Lazy init / refill quota when we arrive at a new client
-        if (rr_remaining_ == 0) {
-            rr_remaining_ = client->weight;
-        }
-
-        std::lock_guard client_lock(client->mutex);
-        if (client->any_queued()) {
-            Job job = client->dequeue_highest();
-            --rr_remaining_;
+        // Empty clients and free slots read depth 0 and are skipped without
+        // touching their ClientState
+        if (clients.depth(rr_index_) > 0) {
+            // Lazy init / refill quota when we arrive at a new client
             if (rr_remaining_ == 0) {
-                rr_index_ = (rr_index_ + 1) % n; // quota exhausted → rotate
+                rr_remaining_ = clients.weight(rr_index_);
+                size_t& debt = debt_[rr_index_];
+                const size_t paid = std::min(debt, rr_remaining_ - 1);
+                rr_remaining_ -= paid;
+                debt -= paid;
+            }
+
+            if (clients.dequeue(rr_index_, out)) {
+                --rr_remaining_;
+                if (rr_remaining_ == 0) {
+                    if (++rr_index_ == n) rr_index_ = 0; // quota exhausted → rotate
+                }
+                return true;
             }
-            client->submit_cv_.notify_one();
-            return job;
         }
 
         // Client empty — work-conserving skip
         rr_remaining_ = 0;
-        rr_index_ = (rr_index_ + 1) % n;
+        if (++rr_index_ == n) rr_index_ = 0;
     }
 
-    return std::nullopt;
+    return false;
+}
+
+void WeightedRoundRobinPolicy::on_job_run_inline(size_t slot, const Job& /*job*/) {
+    ++debt_[slot];
 }
 
-void WeightedRoundRobinPolicy::on_client_unregistered(
-    const std::string& /*client_id*/) {
-    rr_index_ = 0;
-    rr_remaining_ = 0;
+void WeightedRoundRobinPolicy::on_client_unregistered(size_t slot) {
+    debt_[slot] = 0;
+    if (slot == rr_index_) rr_remaining_ = 0; // the slot's next client starts afresh
 }
 
 } // namespace job_system
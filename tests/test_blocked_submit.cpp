@@ -0,0 +1,287 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/completion_queue.h"
+#include "job_system/drr_policy.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+class BlockRecorder : public IMetricsObserver {
+public:
+    void on_submit_blocked(const std::string&, uint64_t job_id, uint64_t blocking_task_id,
+                           std::chrono::microseconds) override {
+        blocked_job.store(job_id);
+        blocking_task.store(blocking_task_id);
+        ++calls;
+    }
+    std::atomic<uint64_t> blocked_job{0};
+    std::atomic<uint64_t> blocking_task{0};
+    std::atomic<int> calls{0};
+};
+
+template <typename Pred>
+bool wait_for(Pred pred) {
+    const auto until = std::chrono::steady_clock::now() + 5s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > until) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+// TaskBlockedBehindLowerPriorityIsDetected: a CRITICAL task that fills a BLOCK
+// client with a LOW job and then submits again stalls its (only) worker. The
+// stall is visible while it lasts, counted as an in-task block and a priority
+// inversion, and reported to the observer with the blocked task's id.
+TEST(BlockedSubmit, TaskBlockedBehindLowerPriorityIsDetected) {
+    Scheduler sched;
+    sched.register_client("t");
+    sched.register_client("q", 1, /*max_depth=*/1, OverflowStrategy::BLOCK);
+    auto recorder = std::make_shared<BlockRecorder>();
+    sched.set_observer(recorder);
+
+    std::atomic<uint64_t> task_id{0};
+    sched.submit("t", [&] {
+        task_id = sched.current_job_id();
+        sched.submit("q", [] {}, 1, Priority::LOW);
+        sched.submit("q", [] {}); // queue full: waits for space
+    }, 1, Priority::CRITICAL);
+
+    ManualExecutor exec(sched);
+    std::thread worker([&] { exec.step(); });
+
+    ASSERT_TRUE(wait_for([&] { return sched.get_global_metrics().tasks_blocked_in_submit == 1; }));
+    auto m = sched.get_client_metrics("q");
+    EXPECT_EQ(m.blocked_submits, 1u);
+    EXPECT_EQ(m.blocked_in_task, 1u);
+    EXPECT_EQ(m.priority_inversions, 1u);
+
+    EXPECT_EQ(sched.drain_client("q"), 1u); // frees the slot
+    worker.join();
+
+    EXPECT_EQ(sched.get_global_metrics().tasks_blocked_in_submit, 0u);
+    EXPECT_EQ(recorder->calls.load(), 1);
+    EXPECT_EQ(recorder->blocking_task.load(), task_id.load());
+    EXPECT_EQ(recorder->blocked_job.load(), 3u);
+    EXPECT_EQ(sched.get_client_metrics("q").queue_depth, 1u);
+}
+
+// ExternalProducerIsNotAnInTaskBlock: a plain producer thread waiting for
+// space is counted as blocked but not as a stalled task
+TEST(BlockedSubmit, ExternalProducerIsNotAnInTaskBlock) {
+    Scheduler sched;
+    sched.register_client("q", 1, /*max_depth=*/1, OverflowStrategy::BLOCK);
+    auto recorder = std::make_shared<BlockRecorder>();
+    sched.set_observer(recorder);
+    sched.submit("q", [] {});
+
+    std::thread producer([&] { sched.submit("q", [] {}); });
+    ASSERT_TRUE(wait_for([&] { return sched.get_client_metrics("q").blocked_submits == 1; }));
+    EXPECT_EQ(sched.get_global_metrics().tasks_blocked_in_submit, 0u);
+    sched.drain_client("q");
+    producer.join();
+
+    const auto m = sched.get_client_metrics("q");
+    EXPECT_EQ(m.blocked_in_task, 0u);
+    EXPECT_EQ(m.priority_inversions, 0u);
+    EXPECT_EQ(recorder->blocking_task.load(), 0u);
+}
+
+// HelpWhileBlockedAvoidsSelfDeadlock: a task submitting to its own full client
+// on a single worker runs the queued jobs itself instead of sleeping forever
+TEST(BlockedSubmit, HelpWhileBlockedAvoidsSelfDeadlock) {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+    sched.register_client("q", 1, /*max_depth=*/1, OverflowStrategy::BLOCK);
+    sched.set_help_while_blocked(true);
+
+    std::vector<std::string> order;
+    sched.submit("q", [&] {
+        order.push_back("T");
+        sched.submit("q", [&] { order.push_back("A"); });
+        sched.submit("q", [&] { order.push_back("B"); }); // runs A
+        sched.submit("q", [&] { order.push_back("C"); }); // runs B
+        order.push_back("T end");
+    });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.run_until_idle(), 2u); // T, then C
+    EXPECT_EQ(order, (std::vector<std::string>{"T", "A", "B", "T end", "C"}));
+
+    const auto m = sched.get_client_metrics("q");
+    EXPECT_EQ(m.blocked_in_task, 2u);
+    EXPECT_EQ(m.helped_jobs, 2u);
+    EXPECT_EQ(m.blocked_time_us, 0u);
+    EXPECT_EQ(m.executed, 4u);
+    EXPECT_EQ(sched.get_global_metrics().tasks_blocked_in_submit, 0u);
+}
+
+// HelpWhileBlockedOnThreadPool: with help enabled, a fan-out far larger than
+// the queue bound completes on a single-worker pool
+TEST(BlockedSubmit, HelpWhileBlockedOnThreadPool) {
+    Scheduler sched;
+    sched.register_client("q", 1, /*max_depth=*/4, OverflowStrategy::BLOCK);
+    sched.set_help_while_blocked(true);
+    std::atomic<int> done{0};
+    sched.submit("q", [&] {
+        for (int i = 0; i < 100; ++i) sched.submit("q", [&] { ++done; });
+    });
+
+    ThreadPool pool(sched, 1);
+    ASSERT_TRUE(wait_for([&] { return done.load() == 100; }));
+    pool.shutdown();
+    EXPECT_EQ(sched.get_client_metrics("q").helped_jobs, 96u);
+}
+
+// HelpWhileBlockedForExternalProducer: a producer thread outside the pool runs
+// the queued job instead of sleeping, so a full queue with no workers does
+// not stall it
+TEST(BlockedSubmit, HelpWhileBlockedForExternalProducer) {
+    Scheduler sched;
+    sched.register_client("q", 1, /*max_depth=*/1, OverflowStrategy::BLOCK);
+    sched.set_help_while_blocked(true);
+    const auto producer = std::this_thread::get_id();
+    std::thread::id ran_on;
+    sched.submit("q", [&] { ran_on = std::this_thread::get_id(); });
+    sched.submit("q", [] {});
+
+    EXPECT_EQ(ran_on, producer);
+    const auto m = sched.get_client_metrics("q");
+    EXPECT_EQ(m.blocked_submits, 1u);
+    EXPECT_EQ(m.blocked_in_task, 0u);
+    EXPECT_EQ(m.helped_jobs, 1u);
+    EXPECT_EQ(m.queue_depth, 1u);
+}
+
+// CallerRunsExecutesNextJobInline: at capacity the producer runs the client's
+// next job (highest priority, then oldest) and its own job takes the slot
+TEST(CallerRuns, ExecutesNextJobInline) {
+    Scheduler sched;
+    sched.register_client("q", 1, /*max_depth=*/2, OverflowStrategy::CALLER_RUNS);
+    std::vector<std::string> ran;
+    sched.submit("q", [&] { ran.push_back("a"); });
+    sched.submit("q", [&] { ran.push_back("b"); }, 1, Priority::HIGH);
+    sched.submit("q", [&] { ran.push_back("c"); }); // runs b
+    sched.submit("q", [&] { ran.push_back("d"); }); // runs a
+    EXPECT_EQ(ran, (std::vector<std::string>{"b", "a"}));
+
+    const auto m = sched.get_client_metrics("q");
+    EXPECT_EQ(m.queue_depth, 2u);
+    EXPECT_EQ(m.overflow_count, 2u);
+    EXPECT_EQ(m.helped_jobs, 2u);
+    EXPECT_EQ(m.executed, 2u);
+    EXPECT_EQ(m.submitted, 4u);
+}
+
+// CallerRunsChargesThePolicy: jobs a client's producer ran inline count
+// against that client's next turn, under both WRR and DRR
+TEST(CallerRuns, ChargesThePolicy) {
+    auto run = [](std::unique_ptr<ISchedulingPolicy> policy, size_t weight) {
+        auto clock = std::make_shared<ManualClock>();
+        Scheduler sched(std::move(policy), clock);
+        sched.register_client("X", weight, /*max_depth=*/4, OverflowStrategy::CALLER_RUNS);
+        sched.register_client("Y", weight);
+        std::vector<std::string> order;
+        for (int i = 1; i <= 6; ++i) {
+            sched.submit("X", [&order, i] { order.push_back("x" + std::to_string(i)); });
+            sched.submit("Y", [&order, i] { order.push_back("y" + std::to_string(i)); });
+        }
+        // x1 and x2 ran inline: X owes two of its three jobs per turn
+        EXPECT_EQ(order, (std::vector<std::string>{"x1", "x2"}));
+        order.clear();
+        ManualExecutor exec(sched);
+        exec.step(4);
+        return order;
+    };
+    const std::vector<std::string> expected = {"x3", "y1", "y2", "y3"};
+    EXPECT_EQ(run(std::make_unique<WeightedRoundRobinPolicy>(), 3), expected);
+    EXPECT_EQ(run(std::make_unique<DeficitRoundRobinPolicy>(3), 1), expected);
+}
+
+// CallerRunsInlineFailureStaysWithItsJob: a queued task that throws when the
+// producer runs it inline is reported as that job's failure; the submit that
+// ran it returns normally and its own job stays admitted
+TEST(CallerRuns, InlineFailureStaysWithItsJob) {
+    class FailureRecorder : public IMetricsObserver {
+    public:
+        void on_job_failed(const std::string& client_id, uint64_t job_id) override {
+            failed_client = client_id;
+            failed_job = job_id;
+            ++calls;
+        }
+        std::string failed_client;
+        uint64_t failed_job{0};
+        int calls{0};
+    };
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(),
+                    std::make_shared<ManualClock>());
+    sched.register_client("q", 1, /*max_depth=*/1, OverflowStrategy::CALLER_RUNS);
+    auto recorder = std::make_shared<FailureRecorder>();
+    sched.set_observer(recorder);
+
+    CompletionQueue cq(4);
+    sched.submit(cq, 7, "q", [] { throw std::runtime_error("queued task failed"); });
+    bool ran = false;
+    EXPECT_NO_THROW(sched.submit("q", [&] { ran = true; })); // runs the throwing task
+    EXPECT_EQ(recorder->calls, 1);
+    EXPECT_EQ(recorder->failed_client, "q");
+
+    std::vector<Completion> done(4);
+    ASSERT_EQ(cq.harvest(done), 1u);
+    EXPECT_EQ(done[0].user_tag, 7u);
+    EXPECT_EQ(done[0].status, CompletionStatus::FAILED);
+    EXPECT_EQ(done[0].job_id, recorder->failed_job);
+
+    // Same without a completion queue: nothing else would report it
+    sched.submit("q", [] { throw std::runtime_error("plain task failed"); }); // runs ours
+    EXPECT_TRUE(ran);
+    EXPECT_NO_THROW(sched.submit("q", [] {}));
+    EXPECT_EQ(recorder->calls, 2);
+
+    const auto m = sched.get_client_metrics("q");
+    EXPECT_EQ(m.helped_jobs, 3u);
+    EXPECT_EQ(m.executed, 3u);
+    EXPECT_EQ(m.queue_depth, 1u);
+}
+
+// TrySubmitTakesOnlyFreeSlots: try_submit() fills a bounded queue and then
+// refuses, leaving the queued jobs alone whatever the overflow strategy
+TEST(TrySubmit, TakesOnlyFreeSlots) {
+    for (auto strategy : {OverflowStrategy::REJECT, OverflowStrategy::BLOCK,
+                          OverflowStrategy::DROP_OLDEST, OverflowStrategy::DROP_NEWEST,
+                          OverflowStrategy::CALLER_RUNS}) {
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(),
+                        std::make_shared<ManualClock>());
+        sched.register_client("A", 1, 2, strategy);
+        int ran = 0;
+        EXPECT_TRUE(sched.try_submit("A", [&] { ++ran; }));
+        EXPECT_TRUE(sched.try_submit("A", [&] { ++ran; }));
+        EXPECT_FALSE(sched.try_submit("A", [&] { ran += 100; }));
+        EXPECT_EQ(ran, 0); // nothing run inline
+        EXPECT_EQ(sched.get_client_metrics("A").queue_depth, 2u);
+        EXPECT_EQ(sched.get_client_metrics("A").overflow_count, 0u);
+
+        ManualExecutor exec(sched);
+        EXPECT_EQ(exec.run_until_idle(), 2u);
+        EXPECT_EQ(ran, 2);
+    }
+    Scheduler sched;
+    EXPECT_THROW(sched.try_submit("nobody", [] {}), std::runtime_error);
+}
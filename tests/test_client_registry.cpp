@@ -0,0 +1,171 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/client_registry.h"
+#include "job_system/clock.h"
+#include "job_system/drr_policy.h"
+#include "job_system/scheduler.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+
+namespace {
+
+std::shared_ptr<ClientState> make_client(const std::string& id) {
+    return std::make_shared<ClientState>(id);
+}
+
+} // namespace
+
+// IndexSurvivesChurn: names keep resolving to their slots while the
+// open-addressing index grows and entries are deleted out of probe runs
+TEST(ClientRegistry, IndexSurvivesChurn) {
+    constexpr size_t N = 2000;
+    ClientRegistry registry;
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(registry.add(make_client("c" + std::to_string(i)), i + 1), i);
+    }
+    for (size_t i = 0; i < N; i += 2) registry.remove(registry.find("c" + std::to_string(i)));
+    EXPECT_EQ(registry.size(), N / 2);
+    EXPECT_EQ(registry.slot_count(), N);
+
+    for (size_t i = 0; i < N; ++i) {
+        const size_t slot = registry.find("c" + std::to_string(i));
+        if (i % 2 == 0) {
+            EXPECT_EQ(slot, ClientRegistry::NO_SLOT);
+            EXPECT_EQ(registry.state(i), nullptr);
+            EXPECT_EQ(registry.weight(i), 0u);
+        } else {
+            ASSERT_EQ(slot, i);
+            EXPECT_EQ(registry.state(slot)->client_id, "c" + std::to_string(i));
+            EXPECT_EQ(registry.weight(slot), i + 1);
+        }
+    }
+
+    // Freed slots are reused before the columns grow
+    for (size_t i = 0; i < N / 2; ++i) registry.add(make_client("d" + std::to_string(i)), 1);
+    EXPECT_EQ(registry.slot_count(), N);
+    EXPECT_EQ(registry.size(), N);
+    for (size_t i = 0; i < N / 2; ++i) {
+        EXPECT_NE(registry.find("d" + std::to_string(i)), ClientRegistry::NO_SLOT);
+    }
+}
+
+// StaleHandleDoesNotResolve: a reused slot gets a new generation, so the
+// handle of the client that held it before no longer resolves
+TEST(ClientRegistry, StaleHandleDoesNotResolve) {
+    ClientRegistry registry;
+    auto a = make_client("A");
+    const size_t slot = registry.add(a, 1);
+    const ClientHandle old_handle = a->handle;
+    EXPECT_EQ(registry.at(old_handle), a);
+    EXPECT_TRUE(registry.contains(*a));
+
+    registry.remove(slot);
+    EXPECT_EQ(registry.at(old_handle), nullptr);
+    EXPECT_FALSE(registry.contains(*a));
+
+    auto b = make_client("B");
+    EXPECT_EQ(registry.add(b, 1), slot);
+    EXPECT_NE(b->handle, old_handle);
+    EXPECT_EQ(ClientRegistry::slot_of(b->handle), slot);
+    EXPECT_EQ(registry.at(old_handle), nullptr);
+    EXPECT_EQ(registry.at(b->handle), b);
+}
+
+// DepthColumnTracksQueues: the depth column follows pushes published with
+// sync_depth() and dequeues
+TEST(ClientRegistry, DepthColumnTracksQueues) {
+    ClientRegistry registry;
+    auto client = make_client("A");
+    const size_t slot = registry.add(client, 1);
+    EXPECT_EQ(registry.depth(slot), 0u);
+    {
+        std::lock_guard lock(client->mutex);
+        for (int i = 0; i < 3; ++i) {
+            Job job;
+            job.task = [] {};
+            client->push(std::move(job));
+        }
+        registry.sync_depth(*client);
+    }
+    EXPECT_EQ(registry.depth(slot), 3u);
+
+    Job out;
+    EXPECT_TRUE(registry.dequeue(slot, out));
+    EXPECT_EQ(registry.depth(slot), 2u);
+    EXPECT_TRUE(registry.dequeue(slot, out));
+    EXPECT_TRUE(registry.dequeue(slot, out));
+    EXPECT_EQ(registry.depth(slot), 0u);
+    EXPECT_FALSE(registry.dequeue(slot, out));
+}
+
+// ReusedSlotStartsFresh: a client registered into a freed slot inherits
+// neither the executions of a job dequeued from its predecessor nor the
+// predecessor's policy state
+TEST(ClientRegistry, ReusedSlotStartsFresh) {
+    for (bool drr : {false, true}) {
+        std::unique_ptr<ISchedulingPolicy> policy;
+        if (drr) {
+            policy = std::make_unique<DeficitRoundRobinPolicy>(5); // one job per turn
+        } else {
+            policy = std::make_unique<WeightedRoundRobinPolicy>();
+        }
+        Scheduler sched(std::move(policy), std::make_shared<ManualClock>());
+        sched.register_client("A", 3);
+        sched.register_client("B", 1);
+        for (int i = 0; i < 4; ++i) sched.submit("A", [] {}, 5);
+
+        Job stale;
+        ASSERT_TRUE(sched.select_next_job(stale));
+        sched.unregister_client("A");
+        sched.register_client("C", 1);
+        sched.execute(stale); // A's job; must not count for C
+        EXPECT_EQ(sched.get_client_metrics("C").executed, 0u);
+        EXPECT_EQ(sched.get_client_metrics("C").weight, 1u);
+
+        // A left credit for two more turns in its slot; C and B have equal
+        // weights and costs, so they alternate from the start
+        std::vector<char> order;
+        for (int i = 0; i < 3; ++i) sched.submit("B", [&] { order.push_back('B'); }, 5);
+        for (int i = 0; i < 4; ++i) sched.submit("C", [&] { order.push_back('C'); }, 5);
+        Job job;
+        while (sched.select_next_job(job)) sched.execute(job);
+        ASSERT_EQ(order.size(), 7u);
+        for (size_t i = 1; i < 6; ++i) EXPECT_NE(order[i], order[i - 1]) << "drr=" << drr;
+        EXPECT_EQ(sched.get_client_metrics("B").executed, 3u);
+        EXPECT_EQ(sched.get_client_metrics("C").executed, 4u);
+    }
+}
+
+// UnregisterReleasesBlockedSubmitter: a BLOCK submitter asleep on a full
+// queue wakes up when its client is unregistered and fails as for an
+// unknown client
+TEST(ClientRegistry, UnregisterReleasesBlockedSubmitter) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(),
+                    std::make_shared<ManualClock>());
+    sched.register_client("A", 1, 1, OverflowStrategy::BLOCK);
+    sched.submit("A", [] {});
+
+    std::atomic<bool> threw{false};
+    std::thread submitter([&] {
+        try {
+            sched.submit("A", [] {});
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+    });
+    while (sched.get_client_metrics("A").blocked_submits == 0) std::this_thread::yield();
+
+    EXPECT_EQ(sched.unregister_client("A"), 1u);
+    submitter.join();
+    EXPECT_TRUE(threw.load());
+    EXPECT_FALSE(sched.has_pending_jobs());
+}
@@ -0,0 +1,109 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/client_state.h"
+#include "job_system/clock.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+Job job_at(Priority priority) {
+    Job job;
+    job.task = [] {};
+    job.set_priority(priority);
+    return job;
+}
+
+} // namespace
+
+// IdleClientHoldsNoQueues: queues are materialised per priority level on
+// first push and stay for later jobs; only bounded clients carry limits
+TEST(CompactClient, IdleClientHoldsNoQueues) {
+    ClientState idle("idle");
+    EXPECT_EQ(idle.limits, nullptr);
+    EXPECT_EQ(idle.max_queue_depth(), 0u);
+    EXPECT_EQ(idle.overflow_strategy(), OverflowStrategy::REJECT);
+    for (const auto& q : idle.queues) EXPECT_EQ(q, nullptr);
+    EXPECT_FALSE(idle.any_queued());
+    EXPECT_EQ(idle.total_queued(), 0u);
+
+    idle.push(job_at(Priority::HIGH));
+    idle.push(job_at(Priority::HIGH));
+    const auto high = static_cast<size_t>(Priority::HIGH);
+    for (size_t level = 0; level < idle.queues.size(); ++level) {
+        EXPECT_EQ(idle.queues[level] != nullptr, level == high);
+    }
+    EXPECT_EQ(idle.total_queued(), 2u);
+
+    Job out;
+    idle.dequeue_highest(out);
+    idle.dequeue_highest(out);
+    EXPECT_FALSE(idle.any_queued());
+    EXPECT_NE(idle.queues[high], nullptr);
+
+    ClientState bounded("bounded", 8, OverflowStrategy::DROP_OLDEST);
+    ASSERT_NE(bounded.limits, nullptr);
+    EXPECT_EQ(bounded.max_queue_depth(), 8u);
+    EXPECT_EQ(bounded.overflow_strategy(), OverflowStrategy::DROP_OLDEST);
+    EXPECT_EQ(bounded.limits->space_cv, nullptr); // only BLOCK clients wait
+}
+
+// SharedCondVarWakesEveryClient: more BLOCK clients than condition
+// variables in the pool, each with a submitter asleep on a full queue; every
+// dequeue wakes the right submitter, whichever clients share its slot
+TEST(CompactClient, SharedCondVarWakesEveryClient) {
+    constexpr int CLIENTS = 40;
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(),
+                    std::make_shared<ManualClock>());
+    for (int i = 0; i < CLIENTS; ++i) {
+        const std::string id = "c" + std::to_string(i);
+        sched.register_client(id, 1, 1, OverflowStrategy::BLOCK);
+        sched.submit(id, [] {});
+    }
+
+    std::atomic<int> admitted{0};
+    std::vector<std::thread> submitters;
+    for (int i = 0; i < CLIENTS; ++i) {
+        submitters.emplace_back([&, i] {
+            sched.submit("c" + std::to_string(i), [] {});
+            ++admitted;
+        });
+    }
+    auto blocked = [&] {
+        uint64_t n = 0;
+        for (int i = 0; i < CLIENTS; ++i)
+            n += sched.get_client_metrics("c" + std::to_string(i)).blocked_submits;
+        return n;
+    };
+    while (blocked() < CLIENTS) std::this_thread::yield();
+    EXPECT_EQ(admitted.load(), 0);
+
+    ManualExecutor exec(sched);
+    const auto give_up = std::chrono::steady_clock::now() + 10s;
+    while (admitted.load() < CLIENTS && std::chrono::steady_clock::now() < give_up) {
+        exec.step();
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(admitted.load(), CLIENTS);
+    if (admitted.load() < CLIENTS) sched.drain_all_clients(); // release stragglers
+    for (auto& t : submitters) t.join();
+
+    exec.run_until_idle();
+    EXPECT_EQ(sched.get_global_metrics().tasks_blocked_in_submit, 0u);
+    for (int i = 0; i < CLIENTS; ++i) {
+        const auto m = sched.get_client_metrics("c" + std::to_string(i));
+        EXPECT_EQ(m.submitted, 2u);
+        EXPECT_EQ(m.queue_depth, 0u);
+    }
+}
@@ -0,0 +1,171 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/event_log.h"
+#include "job_system/job.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/task.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+// Counts heap allocations made by this test binary
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+} // namespace
+
+void* operator new(std::size_t n) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+} // namespace
+
+// OneCacheLine: a Job is exactly one aligned cache line, and closures of up
+// to three words are stored in it without allocating
+TEST(CompactJob, OneCacheLine) {
+    EXPECT_EQ(sizeof(Job), 64u);
+    EXPECT_EQ(alignof(Job), 64u);
+
+    uint64_t a = 1, b = 2, c = 3;
+    auto three_words = [&a, b, c] { a += b + c; };
+    auto four_words = [&a, b, c, d = a] { a += b + c + d; };
+    EXPECT_TRUE(Task::stored_inline<decltype(three_words)>);
+    EXPECT_FALSE(Task::stored_inline<decltype(four_words)>);
+
+    const uint64_t before = g_allocations.load();
+    Job job;
+    job.task = three_words;
+    Job moved = std::move(job);
+    moved.run();
+    EXPECT_EQ(g_allocations.load() - before, 0u);
+    EXPECT_EQ(a, 6u);
+    EXPECT_FALSE(job.task);
+
+    Task boxed(four_words);
+    Task boxed_moved = std::move(boxed);
+    boxed_moved();
+    EXPECT_EQ(a, 6u + 2 + 3 + 1);
+}
+
+// PackedFields: priority and cost share one word; cost is clamped to 24
+// bits, and lineage / completion fields cost nothing until used
+TEST(CompactJob, PackedFields) {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+    sched.register_client("A");
+
+    sched.submit("A", [] {}, UINT32_MAX, Priority::CRITICAL);
+    Job job;
+    ASSERT_TRUE(sched.select_next_job(job));
+    EXPECT_EQ(job.priority(), Priority::CRITICAL);
+    EXPECT_EQ(job.cost_hint(), Job::MAX_COST_HINT);
+    EXPECT_FALSE(job.has_deadline());
+    EXPECT_EQ(job.extras, nullptr);
+    EXPECT_EQ(job.parent_id(), 0u);
+    EXPECT_EQ(job.root_id(), job.job_id);
+
+    // Lineage is kept only for an attached event log
+    uint64_t parent = 0;
+    auto spawn = [&] {
+        sched.submit("A", [&] {
+            parent = sched.current_job_id();
+            sched.submit("A", [] {});
+        });
+    };
+    ManualExecutor exec(sched);
+    spawn();
+    EXPECT_EQ(exec.step(), 1u);
+    ASSERT_TRUE(sched.select_next_job(job));
+    EXPECT_EQ(job.extras, nullptr);
+    EXPECT_EQ(job.parent_id(), 0u);
+
+    const auto log_path = std::filesystem::temp_directory_path() / "job_system_packed_fields.bin";
+    sched.set_event_log(std::make_shared<EventLog>(log_path.string()));
+    spawn();
+    EXPECT_EQ(exec.step(), 1u);
+    ASSERT_TRUE(sched.select_next_job(job));
+    ASSERT_NE(job.extras, nullptr);
+    EXPECT_EQ(job.parent_id(), parent);
+    EXPECT_EQ(job.root_id(), parent);
+    sched.set_event_log(nullptr);
+    std::filesystem::remove(log_path);
+}
+
+// TimestampsRoundTrip: enqueue time and deadline come back from the 32-bit
+// fields at microsecond resolution, also across the ~71 minute wrap of the
+// tick counter; deadlines beyond the 32-bit range never expire
+TEST(CompactJob, TimestampsRoundTrip) {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+    sched.register_client("A");
+    ManualExecutor exec(sched);
+
+    for (auto skip : {0min, 70min, 2min}) {
+        clock->advance(skip);
+        const auto submitted = clock->now();
+        sched.submit("A", [] {}, 1, Priority::NORMAL, submitted + 5ms);
+        sched.submit("A", [] {}, 1, Priority::NORMAL, submitted + 2h);
+        clock->advance(3ms);
+
+        Job job;
+        ASSERT_TRUE(sched.select_next_job(job));
+        EXPECT_EQ(sched.enqueue_time(job), submitted);
+        EXPECT_EQ(sched.deadline(job), submitted + 5ms);
+        sched.execute(job);
+
+        ASSERT_TRUE(sched.select_next_job(job));
+        EXPECT_FALSE(job.has_deadline());
+        EXPECT_EQ(sched.deadline(job), std::chrono::steady_clock::time_point{});
+        sched.execute(job);
+
+        sched.submit("A", [] {}, 1, Priority::NORMAL, clock->now() + 1ms);
+        clock->advance(2ms);
+        EXPECT_EQ(exec.step(), 0u);
+    }
+    EXPECT_EQ(sched.get_client_metrics("A").expired_count, 3u);
+    EXPECT_EQ(sched.get_client_metrics("A").executed, 6u);
+}
+
+// DequeueFillsCallerSlot: select_next_job() moves a job into the caller's
+// slot and execute() empties it again, releasing the task's captures
+TEST(CompactJob, DequeueFillsCallerSlot) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    auto token = std::make_shared<int>(0);
+    sched.submit("A", [token] { ++*token; });
+    EXPECT_EQ(token.use_count(), 2);
+
+    Job slot;
+    ASSERT_TRUE(sched.select_next_job(slot));
+    EXPECT_EQ(token.use_count(), 2);
+    sched.execute(slot);
+    EXPECT_EQ(*token, 1);
+    EXPECT_EQ(token.use_count(), 1);
+    EXPECT_FALSE(slot.task);
+    EXPECT_FALSE(sched.select_next_job(slot));
+
+    // The optional-returning overload remains for convenience
+    sched.submit("A", [] {});
+    std::optional<Job> job = sched.select_next_job();
+    ASSERT_TRUE(job.has_value());
+    sched.execute(*job);
+    EXPECT_EQ(sched.total_jobs_processed(), 2u);
+}
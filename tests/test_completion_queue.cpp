@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/completion_queue.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+Completion by_tag(const std::vector<Completion>& all, uint64_t tag) {
+    auto it = std::find_if(all.begin(), all.end(), [&](const Completion& c) { return c.user_tag == tag; });
+    EXPECT_NE(it, all.end()) << "no completion tagged " << tag;
+    return it == all.end() ? Completion{} : *it;
+}
+
+} // namespace
+
+// EveryOutcomePostsOneRecord: run, throw, expire, cancel, drain and drop each
+// post exactly one completion carrying the submitter's tag
+TEST(CompletionQueue, EveryOutcomePostsOneRecord) {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+    sched.register_client("A");
+    sched.register_client("full", 1, /*max_depth=*/1, OverflowStrategy::DROP_NEWEST);
+    CompletionQueue cq(16);
+
+    sched.submit(cq, 1, "A", [&] { clock->advance(250us); });
+    sched.submit(cq, 2, "A", [] { throw std::runtime_error("task failed"); });
+    sched.submit(cq, 3, "A", [] {}, 1, Priority::NORMAL, clock->now() + 1us);
+    sched.submit(cq, 4, "A", [] {});
+    sched.submit(cq, 5, "full", [] {});
+    sched.submit(cq, 6, "full", [] {}); // dropped on arrival
+    EXPECT_EQ(cq.outstanding(), 6u);
+
+    std::array<Completion, 16> buf;
+    ASSERT_EQ(cq.harvest(buf), 1u);
+    EXPECT_EQ(buf[0].user_tag, 6u);
+    EXPECT_EQ(buf[0].status, CompletionStatus::DROPPED);
+    EXPECT_EQ(buf[0].job_id, 6u);
+
+    EXPECT_TRUE(sched.cancel_job(4));
+    EXPECT_EQ(sched.drain_client("full"), 1u);
+    ManualExecutor exec(sched);
+    exec.step(2); // runs 1 and 2; the clock passes 3's deadline
+    exec.run_until_idle();
+
+    std::vector<Completion> all(buf.begin(), buf.begin() + cq.harvest(buf));
+    ASSERT_EQ(all.size(), 5u);
+    EXPECT_EQ(by_tag(all, 1).status, CompletionStatus::COMPLETED);
+    EXPECT_EQ(by_tag(all, 1).duration_us, 250u);
+    EXPECT_EQ(by_tag(all, 2).status, CompletionStatus::FAILED);
+    EXPECT_EQ(by_tag(all, 3).status, CompletionStatus::EXPIRED);
+    EXPECT_EQ(by_tag(all, 4).status, CompletionStatus::CANCELLED);
+    EXPECT_EQ(by_tag(all, 5).status, CompletionStatus::CANCELLED);
+    EXPECT_EQ(cq.outstanding(), 0u);
+    EXPECT_EQ(cq.harvest(buf), 0u);
+}
+
+// SlotsAreReservedUntilHarvested: submits beyond capacity are refused until
+// completions are harvested; a refused REJECT submit gives its slot back
+TEST(CompletionQueue, SlotsAreReservedUntilHarvested) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    sched.register_client("tiny", 1, /*max_depth=*/1, OverflowStrategy::REJECT);
+    CompletionQueue cq(3); // rounded up to 4
+    EXPECT_EQ(cq.capacity(), 4u);
+
+    sched.submit(cq, 0, "tiny", [] {});
+    EXPECT_THROW(sched.submit(cq, 1, "tiny", [] {}), QueueFullException);
+    EXPECT_THROW(sched.submit(cq, 1, "nobody", [] {}), std::runtime_error);
+    EXPECT_EQ(cq.outstanding(), 1u);
+    for (uint64_t t = 1; t <= 3; ++t) sched.submit(cq, t, "A", [] {});
+    EXPECT_THROW(sched.submit(cq, 4, "A", [] {}), QueueFullException);
+
+    ManualExecutor(sched).run_until_idle();
+    EXPECT_THROW(sched.submit(cq, 4, "A", [] {}), QueueFullException); // posted, not harvested
+
+    std::array<Completion, 2> buf;
+    EXPECT_EQ(cq.harvest(buf), 2u);
+    sched.submit(cq, 4, "A", [] {});
+    sched.submit(cq, 5, "A", [] {});
+    EXPECT_EQ(cq.outstanding(), 4u);
+}
+
+// WaitCollectsBatchesFromThePool: a consumer that only ever wait()s collects
+// every completion of a multi-worker run, each exactly once, across laps of
+// the ring
+TEST(CompletionQueue, WaitCollectsBatchesFromThePool) {
+    Scheduler sched;
+    sched.register_client("A");
+    sched.register_client("B");
+    ThreadPool pool(sched, 4);
+    CompletionQueue cq(64);
+    constexpr uint64_t N = 5000;
+
+    std::set<uint64_t> tags;
+    std::array<Completion, 32> buf;
+    uint64_t next = 0;
+    while (tags.size() < N) {
+        // Keep the ring full, then collect at least 8 (or whatever is left)
+        while (next < N && cq.outstanding() < cq.capacity()) {
+            sched.submit(cq, next, next % 2 ? "A" : "B", [] {});
+            ++next;
+        }
+        const size_t got = cq.wait(buf, 8);
+        ASSERT_GT(got, 0u);
+        for (size_t i = 0; i < got; ++i) {
+            EXPECT_EQ(buf[i].status, CompletionStatus::COMPLETED);
+            EXPECT_TRUE(tags.insert(buf[i].user_tag).second) << buf[i].user_tag;
+        }
+    }
+    EXPECT_EQ(*tags.rbegin(), N - 1);
+    EXPECT_EQ(cq.outstanding(), 0u);
+    pool.shutdown();
+}
+
+// WaitNeverBlocksOnNothing: with fewer outstanding jobs than requested, wait()
+// returns once those have arrived
+TEST(CompletionQueue, WaitNeverBlocksOnNothing) {
+    Scheduler sched;
+    sched.register_client("A");
+    CompletionQueue cq(8);
+    std::array<Completion, 8> buf;
+    EXPECT_EQ(cq.wait(buf, 4), 0u);
+
+    sched.submit(cq, 7, "A", [] { std::this_thread::sleep_for(5ms); });
+    ThreadPool pool(sched, 1);
+    ASSERT_EQ(cq.wait(buf, 4), 1u);
+    EXPECT_EQ(buf[0].user_tag, 7u);
+    pool.shutdown();
+}
@@ -0,0 +1,257 @@
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#if defined(__unix__)
+#include <sys/resource.h>
+#endif
+
+#include "job_system/clock.h"
+#include "job_system/event_log.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string temp_log_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+struct ReadBack {
+    std::vector<std::string> clients;
+    std::vector<LogEvent> events;
+};
+
+ReadBack read_log(const std::string& path) {
+    EventLogReader reader(path);
+    ReadBack out;
+    reader.for_each([&](const LogEvent& ev) { out.events.push_back(ev); });
+    out.clients = reader.clients();
+    return out;
+}
+
+} // namespace
+
+// LifecycleTransitionsRoundTrip: every outcome a job can have is logged with
+// the scheduler's clock and read back in order
+TEST(EventLog, LifecycleTransitionsRoundTrip) {
+    const std::string path = temp_log_path("job_system_event_log_lifecycle.bin");
+    auto clock = std::make_shared<ManualClock>();
+    const auto t0 = clock->now();
+    {
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+        sched.register_client("A", 1, 1, OverflowStrategy::REJECT);
+        sched.register_client("B", 1, 1, OverflowStrategy::DROP_OLDEST);
+        sched.register_client("C");
+        sched.set_event_log(std::make_shared<EventLog>(path));
+
+        sched.submit("A", [] {});                                        // 1 runs
+        EXPECT_THROW(sched.submit("A", [] {}), QueueFullException);      // 2 rejected
+        sched.submit("B", [] {});                                        // 3 dropped
+        sched.submit("B", [] {}, 1, Priority::HIGH);                     // 4 expires
+        sched.submit("C", [] {}, 1, Priority::NORMAL, clock->now() + 1h); // 5 cancelled
+        ASSERT_TRUE(sched.cancel_job(5));
+
+        clock->advance(10us);
+        ManualExecutor exec(sched);
+        exec.step(); // runs job 1
+
+        sched.set_event_log(nullptr); // flushed on destruction
+    }
+
+    const ReadBack log = read_log(path);
+    ASSERT_EQ(log.clients.size(), 3u);
+
+    std::vector<std::pair<EventType, uint64_t>> seq;
+    for (const auto& ev : log.events) seq.emplace_back(ev.type, ev.job_id);
+    const std::vector<std::pair<EventType, uint64_t>> expected = {
+        {EventType::SUBMIT, 1}, {EventType::REJECT, 2}, {EventType::SUBMIT, 3},
+        {EventType::DROP, 3},   {EventType::SUBMIT, 4}, {EventType::SUBMIT, 5},
+        {EventType::CANCEL, 5}, {EventType::START, 1},  {EventType::COMPLETE, 1}};
+    EXPECT_EQ(seq, expected);
+
+    for (const auto& ev : log.events) {
+        const uint64_t rel_ns =
+            ev.timestamp_ns - static_cast<uint64_t>(t0.time_since_epoch().count());
+        if (ev.type == EventType::START || ev.type == EventType::COMPLETE) {
+            EXPECT_EQ(rel_ns, 10000u);
+        } else {
+            EXPECT_EQ(rel_ns, 0u);
+        }
+    }
+    EXPECT_EQ(log.clients[log.events[1].client], "A");
+    EXPECT_EQ(log.events[1].extra, static_cast<uint64_t>(OverflowStrategy::REJECT));
+    EXPECT_EQ(log.clients[log.events[3].client], "B");
+    EXPECT_EQ(log.events[4].extra, static_cast<uint64_t>(Priority::HIGH));
+    std::filesystem::remove(path);
+}
+
+// ExpireAndDrainAreLogged: deadline expiry at dequeue and drain_client()
+// discards each produce one event per job
+TEST(EventLog, ExpireAndDrainAreLogged) {
+    const std::string path = temp_log_path("job_system_event_log_expire.bin");
+    auto clock = std::make_shared<ManualClock>();
+    {
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+        sched.register_client("A");
+        sched.register_client("B");
+        auto log = std::make_shared<EventLog>(path);
+        sched.set_event_log(log);
+
+        sched.submit("A", [] {}, 1, Priority::NORMAL, clock->now() + 1ms);
+        for (int i = 0; i < 3; ++i) sched.submit("B", [] {});
+        clock->advance(2ms);
+        EXPECT_EQ(sched.drain_client("B"), 3u);
+        ManualExecutor exec(sched);
+        EXPECT_EQ(exec.step(), 0u); // A's job expires
+        EXPECT_EQ(log->records_written(), 8u);
+    }
+
+    std::map<EventType, int> counts;
+    for (const auto& ev : read_log(path).events) ++counts[ev.type];
+    EXPECT_EQ(counts[EventType::SUBMIT], 4);
+    EXPECT_EQ(counts[EventType::CANCEL], 3);
+    EXPECT_EQ(counts[EventType::EXPIRE], 1);
+    std::filesystem::remove(path);
+}
+
+// ConcurrentThreadsProduceCompleteLog: with many producers, workers and tiny
+// per-thread buffers (many interleaved chunks), every job has exactly one
+// SUBMIT, START and COMPLETE, in time order
+TEST(EventLog, ConcurrentThreadsProduceCompleteLog) {
+    const std::string path = temp_log_path("job_system_event_log_concurrent.bin");
+    constexpr int PRODUCERS = 4;
+    constexpr int JOBS = 2000;
+    {
+        Scheduler sched;
+        for (int p = 0; p < PRODUCERS; ++p) sched.register_client("c" + std::to_string(p));
+        sched.set_event_log(std::make_shared<EventLog>(path, 256));
+
+        ThreadPool pool(sched, 4);
+        std::vector<std::jthread> producers;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&sched, p] {
+                for (int i = 0; i < JOBS; ++i) sched.submit("c" + std::to_string(p), [] {});
+            });
+        }
+        producers.clear();
+        pool.shutdown();
+    }
+
+    struct Seen {
+        int submit = 0, start = 0, complete = 0;
+        uint64_t submit_ts = 0, start_ts = 0, complete_ts = 0;
+        uint32_t start_thread = 0, complete_thread = 0;
+    };
+    std::map<uint64_t, Seen> jobs;
+    const ReadBack log = read_log(path);
+    for (const auto& ev : log.events) {
+        auto& s = jobs[ev.job_id];
+        switch (ev.type) {
+        case EventType::SUBMIT:   ++s.submit;   s.submit_ts = ev.timestamp_ns; break;
+        case EventType::START:    ++s.start;    s.start_ts = ev.timestamp_ns;
+                                  s.start_thread = ev.thread; break;
+        case EventType::COMPLETE: ++s.complete; s.complete_ts = ev.timestamp_ns;
+                                  s.complete_thread = ev.thread; break;
+        default: ADD_FAILURE() << "unexpected " << event_type_name(ev.type);
+        }
+    }
+    EXPECT_EQ(log.clients.size(), static_cast<size_t>(PRODUCERS));
+    ASSERT_EQ(jobs.size(), static_cast<size_t>(PRODUCERS * JOBS));
+    for (const auto& [id, s] : jobs) {
+        ASSERT_EQ(s.submit, 1) << id;
+        ASSERT_EQ(s.start, 1) << id;
+        ASSERT_EQ(s.complete, 1) << id;
+        EXPECT_LE(s.submit_ts, s.start_ts) << id;
+        EXPECT_LE(s.start_ts, s.complete_ts) << id;
+        EXPECT_EQ(s.start_thread, s.complete_thread) << id;
+    }
+    std::filesystem::remove(path);
+}
+
+// InterleavedLogsKeepOneBufferPerThread: a thread alternating between logs,
+// and outliving some of them, keeps one thread index per log and loses no
+// records
+TEST(EventLog, InterleavedLogsKeepOneBufferPerThread) {
+    const std::string path_a = temp_log_path("job_system_event_log_interleaved_a.bin");
+    const std::string path_b = temp_log_path("job_system_event_log_interleaved_b.bin");
+    const auto ts = std::chrono::steady_clock::now();
+    for (int round = 0; round < 50; ++round) {
+        EventLog gone(temp_log_path("job_system_event_log_interleaved_tmp.bin"));
+        gone.record(EventType::SUBMIT, "tmp", 1, 0, ts);
+    }
+    {
+        EventLog a(path_a, 64);
+        EventLog b(path_b, 64);
+        std::jthread other([&] { a.record(EventType::SUBMIT, "A", 1000, 0, ts); });
+        other.join();
+        for (uint64_t i = 0; i < 100; ++i) {
+            a.record(EventType::SUBMIT, "A", i, 0, ts);
+            b.record(EventType::SUBMIT, "B", i, 0, ts);
+            EventLog gone(temp_log_path("job_system_event_log_interleaved_tmp.bin"));
+            gone.record(EventType::SUBMIT, "tmp", i, 0, ts);
+        }
+    }
+    const ReadBack log_a = read_log(path_a);
+    const ReadBack log_b = read_log(path_b);
+    ASSERT_EQ(log_a.events.size(), 101u);
+    ASSERT_EQ(log_b.events.size(), 100u);
+    for (const auto& ev : log_a.events) EXPECT_EQ(ev.thread, ev.job_id == 1000 ? 0u : 1u);
+    for (const auto& ev : log_b.events) EXPECT_EQ(ev.thread, 0u);
+    std::filesystem::remove(path_a);
+    std::filesystem::remove(path_b);
+    std::filesystem::remove(temp_log_path("job_system_event_log_interleaved_tmp.bin"));
+}
+
+// WriteFailureIsReported: a log that cannot be written fails loudly instead
+// of leaving a silently truncated file
+TEST(EventLog, WriteFailureIsReported) {
+    if (std::filesystem::exists("/dev/full")) {
+        EXPECT_THROW(EventLog("/dev/full"), std::runtime_error);
+    }
+#if defined(__unix__)
+    // Chunks past a 4 KiB file size limit fail with EFBIG
+    const std::string path = temp_log_path("job_system_event_log_full.bin");
+    rlimit saved{};
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &saved), 0);
+    const auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit small = saved;
+    small.rlim_cur = 4096;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &small), 0);
+    {
+        EventLog log(path, 1024);
+        const auto ts = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < 2000; ++i) log.record(EventType::SUBMIT, "A", i, 0, ts);
+        EXPECT_THROW(log.flush(), std::runtime_error);
+        EXPECT_GT(log.records_lost(), 0u);
+        EXPECT_LT(log.records_lost(), 2000u);
+    }
+    ::setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, old_handler);
+    std::filesystem::remove(path);
+#endif
+}
+
+// RejectsForeignFile: the reader refuses files without the event log magic
+TEST(EventLog, RejectsForeignFile) {
+    const std::string path = temp_log_path("job_system_event_log_foreign.bin");
+    std::ofstream(path, std::ios::binary) << "JSTRACE1 not an event log";
+    EXPECT_THROW(EventLogReader{path}, std::runtime_error);
+    EXPECT_THROW(EventLogReader{temp_log_path("job_system_no_such_log.bin")},
+                 std::runtime_error);
+    std::filesystem::remove(path);
+}
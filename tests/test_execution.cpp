@@ -0,0 +1,242 @@
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/execution.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+
+// Counts heap allocations made by this test binary
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+} // namespace
+
+void* operator new(std::size_t n) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Outcome {
+    int values = 0, errors = 0, stops = 0;
+    std::exception_ptr error;
+    uint64_t running_job = 0; // Scheduler::current_job_id() inside set_value
+};
+
+struct RecordingReceiver {
+    Outcome* out;
+    Scheduler* sched;
+    void set_value() && noexcept {
+        ++out->values;
+        out->running_job = sched->current_job_id();
+    }
+    void set_error(std::exception_ptr e) && noexcept {
+        ++out->errors;
+        out->error = std::move(e);
+    }
+    void set_stopped() && noexcept { ++out->stops; }
+};
+
+} // namespace
+
+// ScheduleEnqueuesOnStartAndCompletesOnWorker: connect() does nothing; start()
+// queues one job for the client; set_value() runs inside that job
+TEST(Execution, ScheduleEnqueuesOnStartAndCompletesOnWorker) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    Outcome out;
+    auto op = sched.get_scheduler("A").schedule().connect(RecordingReceiver{&out, &sched});
+    EXPECT_EQ(sched.get_client_metrics("A").submitted, 0u);
+
+    op.start();
+    EXPECT_EQ(sched.get_client_metrics("A").queue_depth, 1u);
+    EXPECT_EQ(out.values, 0);
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.step(), 1u);
+    EXPECT_EQ(out.values, 1);
+    EXPECT_EQ(out.running_job, 1u);
+    EXPECT_EQ(sched.get_client_metrics("A").executed, 1u);
+}
+
+// SchedulerPriorityAndEquality: the sender's job carries the scheduler's
+// priority; schedulers compare equal by client and priority
+TEST(Execution, SchedulerPriorityAndEquality) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    std::vector<std::string> order;
+    sched.submit("A", [&] { order.push_back("normal"); });
+
+    struct Push {
+        std::vector<std::string>* order;
+        void set_value() && noexcept { order->push_back("sender"); }
+        void set_error(std::exception_ptr) && noexcept {}
+        void set_stopped() && noexcept {}
+    };
+    const ClientScheduler high = sched.get_scheduler("A", Priority::HIGH);
+    auto op = high.schedule().connect(Push{&order});
+    op.start();
+    ManualExecutor(sched).run_until_idle();
+    EXPECT_EQ(order, (std::vector<std::string>{"sender", "normal"}));
+
+    EXPECT_EQ(high, sched.get_scheduler("A", Priority::HIGH));
+    EXPECT_FALSE(high == sched.get_scheduler("A"));
+    EXPECT_THROW(sched.get_scheduler("nobody"), std::runtime_error);
+}
+
+// DiscardedJobsCompleteWithStopped: dropped and drained jobs stop their
+// receivers; a REJECT client's overflow is an error
+TEST(Execution, DiscardedJobsCompleteWithStoppedOrError) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("drop", 1, 1, OverflowStrategy::DROP_NEWEST);
+    sched.register_client("reject", 1, 1, OverflowStrategy::REJECT);
+    sched.submit("drop", [] {});
+    sched.submit("reject", [] {});
+
+    Outcome dropped, rejected, drained;
+    auto op1 = sched.get_scheduler("drop").schedule().connect(RecordingReceiver{&dropped, &sched});
+    op1.start();
+    EXPECT_EQ(dropped.stops, 1);
+
+    auto op2 = sched.get_scheduler("reject").schedule().connect(RecordingReceiver{&rejected, &sched});
+    op2.start();
+    ASSERT_EQ(rejected.errors, 1);
+    EXPECT_THROW(std::rethrow_exception(rejected.error), QueueFullException);
+
+    sched.register_client("idle");
+    auto op3 = sched.get_scheduler("idle").schedule().connect(RecordingReceiver{&drained, &sched});
+    op3.start();
+    EXPECT_EQ(drained.stops, 0);
+    EXPECT_EQ(sched.unregister_client("idle"), 1u);
+    EXPECT_EQ(drained.stops, 1);
+    EXPECT_EQ(dropped.values + rejected.values + drained.values, 0);
+}
+
+// StartAllocatesNoMoreThanSubmit: starting a schedule sender costs the same
+// heap allocations as submitting a small lambda
+TEST(Execution, StartAllocatesNoMoreThanSubmit) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    ManualExecutor exec(sched);
+    const ClientScheduler cs = sched.get_scheduler("A");
+    Outcome out;
+    constexpr int N = 64;
+
+    uint64_t submit_allocs = 0, start_allocs = 0;
+    int sink = 0;
+    for (int i = 0; i < N; ++i) {
+        const uint64_t before = g_allocations.load();
+        sched.submit("A", [&sink] { ++sink; });
+        submit_allocs += g_allocations.load() - before;
+        exec.step();
+    }
+    for (int i = 0; i < N; ++i) {
+        auto op = cs.schedule().connect(RecordingReceiver{&out, &sched});
+        const uint64_t before = g_allocations.load();
+        op.start();
+        start_allocs += g_allocations.load() - before;
+        exec.step();
+    }
+    EXPECT_EQ(out.values, N);
+    EXPECT_LE(start_allocs, submit_allocs);
+}
+
+// BulkVisitsEveryIndexOnce: bulk splits into the scheduler's chunk count,
+// runs them in parallel on the pool and completes after the last one
+TEST(Execution, BulkVisitsEveryIndexOnce) {
+    Scheduler sched;
+    sched.register_client("A");
+    ThreadPool pool(sched, 4);
+    constexpr size_t N = 10'000;
+    std::vector<std::atomic<int>> hits(N);
+
+    const auto cs = sched.get_scheduler("A").with_bulk_chunks(8);
+    auto result = sync_wait(bulk(cs.schedule(), N, [&](size_t i) { ++hits[i]; }));
+    ASSERT_TRUE(result.has_value());
+    for (size_t i = 0; i < N; ++i) ASSERT_EQ(hits[i].load(), 1) << i;
+    EXPECT_EQ(sched.get_client_metrics("A").executed, 1u + 8u); // schedule + chunks
+
+    // Chained bulk and an empty shape
+    std::atomic<int> second{0};
+    EXPECT_TRUE(sync_wait(bulk(bulk(cs.schedule(), 3, [&](int) { ++second; }), 0,
+                               [&](int) { ++second; })));
+    EXPECT_EQ(second.load(), 3);
+    pool.shutdown();
+}
+
+// BulkDeliversFirstError: an exception from f fails the whole bulk
+TEST(Execution, BulkDeliversFirstError) {
+    Scheduler sched;
+    sched.register_client("A");
+    ThreadPool pool(sched, 2);
+    auto sender = bulk(sched.get_scheduler("A").with_bulk_chunks(4).schedule(), 100, [](int i) {
+        if (i == 42) throw std::runtime_error("bad index");
+    });
+    EXPECT_THROW(sync_wait(std::move(sender)), std::runtime_error);
+    pool.shutdown();
+}
+
+// BulkStoppedWhenChunksDrained: chunks removed before they run complete the
+// bulk with set_stopped()
+TEST(Execution, BulkStoppedWhenChunksDrained) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    Outcome out;
+    auto op = bulk(sched.get_scheduler("A").with_bulk_chunks(4).schedule(), 8, [](int) {})
+                  .connect(RecordingReceiver{&out, &sched});
+    op.start();
+    ManualExecutor exec(sched);
+    exec.step(); // schedule job → submits 4 chunks
+    exec.step(); // one chunk runs
+    EXPECT_EQ(sched.drain_client("A"), 3u);
+    EXPECT_EQ(out.stops, 1);
+    EXPECT_EQ(out.values + out.errors, 0);
+}
+
+// CallerRunsFailureDoesNotCompleteTwice: a CALLER_RUNS submit made by start()
+// or by bulk's launch can run an unrelated queued task that throws. The
+// sender's own job is queued regardless, so its receiver completes once,
+// with the value, and every bulk index still runs exactly once.
+TEST(Execution, CallerRunsFailureDoesNotCompleteTwice) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A", 1, 1, OverflowStrategy::CALLER_RUNS);
+    auto boom = [] { throw std::runtime_error("unrelated task"); };
+    constexpr int N = 8;
+    std::vector<int> hits(N);
+
+    Outcome out;
+    sched.submit("A", boom);
+    auto op = bulk(sched.get_scheduler("A").with_bulk_chunks(4).schedule(), N,
+                   [&](int i) { ++hits[i]; })
+                  .connect(RecordingReceiver{&out, &sched});
+    op.start(); // runs `boom` inline; the schedule job is queued
+    EXPECT_EQ(out.values + out.errors + out.stops, 0);
+
+    // Runs the schedule job inline; its launch runs this `boom` inline while
+    // submitting the first chunk, then each chunk submit runs the previous one
+    sched.submit("A", boom, 1, Priority::LOW);
+    EXPECT_EQ(out.values + out.errors + out.stops, 0);
+    ManualExecutor(sched).run_until_idle();
+
+    EXPECT_EQ(out.values, 1);
+    EXPECT_EQ(out.errors + out.stops, 0);
+    for (int i = 0; i < N; ++i) EXPECT_EQ(hits[i], 1) << i;
+    EXPECT_EQ(sched.get_client_metrics("A").executed, 2u + 1u + 4u); // booms + schedule + chunks
+}
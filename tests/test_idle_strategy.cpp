@@ -0,0 +1,100 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+class IdleStrategyTest : public ::testing::TestWithParam<IdleStrategy> {};
+
+// JobSubmittedToIdlePoolRunsWithoutShutdown: workers that have gone idle must
+// be woken by submit() itself, not by a later shutdown()
+TEST_P(IdleStrategyTest, JobSubmittedToIdlePoolRunsWithoutShutdown) {
+    Scheduler sched;
+    sched.register_client("A");
+    ThreadPoolOptions opts;
+    opts.idle_strategy = GetParam();
+    opts.spin_duration = 10us;
+    ThreadPool pool(sched, 2, opts);
+
+    for (int i = 0; i < 3; ++i) {
+        std::this_thread::sleep_for(20ms); // every worker is idle (parked for BLOCK)
+        std::promise<void> ran;
+        auto fut = ran.get_future();
+        sched.submit("A", [&ran] { ran.set_value(); });
+        ASSERT_EQ(fut.wait_for(2s), std::future_status::ready) << "round " << i;
+    }
+    pool.shutdown();
+}
+
+// GracefulShutdownDrains: a non-blocking idle loop still honours GRACEFUL
+TEST_P(IdleStrategyTest, GracefulShutdownDrains) {
+    Scheduler sched;
+    sched.register_client("A");
+    ThreadPoolOptions opts;
+    opts.idle_strategy = GetParam();
+    ThreadPool pool(sched, 2, opts);
+
+    std::atomic<int> done{0};
+    for (int i = 0; i < 200; ++i)
+        sched.submit("A", [&done] { done.fetch_add(1, std::memory_order_relaxed); });
+    pool.shutdown();
+    EXPECT_EQ(done.load(), 200);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllStrategies, IdleStrategyTest,
+                         ::testing::Values(IdleStrategy::BLOCK,
+                                           IdleStrategy::SPIN_THEN_BLOCK,
+                                           IdleStrategy::YIELD));
+
+// InvalidAffinityThrows: CPUs outside the process's allowed set are rejected
+// before any worker starts
+TEST(ThreadPoolAffinity, InvalidAffinityThrows) {
+#if defined(__linux__)
+    Scheduler sched;
+    ThreadPoolOptions opts;
+    opts.cpu_affinity = {-1};
+    EXPECT_THROW(ThreadPool(sched, 1, opts), std::invalid_argument);
+    opts.cpu_affinity = {CPU_SETSIZE};
+    EXPECT_THROW(ThreadPool(sched, 1, opts), std::invalid_argument);
+#else
+    GTEST_SKIP() << "CPU affinity is Linux-only";
+#endif
+}
+
+// PinnedWorkerRunsOnRequestedCpu: jobs execute on the CPU the worker was pinned to
+TEST(ThreadPoolAffinity, PinnedWorkerRunsOnRequestedCpu) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed)) ++cpu;
+
+    Scheduler sched;
+    sched.register_client("A");
+    ThreadPoolOptions opts;
+    opts.cpu_affinity = {cpu};
+    ThreadPool pool(sched, 1, opts);
+
+    std::promise<int> ran_on;
+    auto fut = ran_on.get_future();
+    sched.submit("A", [&ran_on] { ran_on.set_value(sched_getcpu()); });
+    ASSERT_EQ(fut.wait_for(2s), std::future_status::ready);
+    EXPECT_EQ(fut.get(), cpu);
+    pool.shutdown();
+#else
+    GTEST_SKIP() << "CPU affinity is Linux-only";
+#endif
+}
@@ -0,0 +1,163 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/drr_policy.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Submits the same mixed workload (weights, priorities, cost hints) into
+// `sched`, appending each job's tag to `order` when it runs
+void submit_mixed_workload(Scheduler& sched, std::vector<std::string>& order) {
+    sched.register_client("A", 3);
+    sched.register_client("B", 1);
+    sched.register_client("C", 2);
+    const Priority prios[] = {Priority::LOW, Priority::NORMAL, Priority::HIGH,
+                              Priority::CRITICAL};
+    for (int i = 0; i < 12; ++i) {
+        for (const char* c : {"A", "B", "C"}) {
+            std::string tag = std::string(c) + std::to_string(i);
+            sched.submit(c, [&order, tag] { order.push_back(tag); },
+                         static_cast<uint32_t>(1 + i % 3), prios[(i + c[0]) % 4]);
+        }
+    }
+}
+
+} // namespace
+
+// RunsOnCallingThread: step() executes the job synchronously on the caller
+TEST(ManualExecutor, RunsOnCallingThread) {
+    Scheduler sched;
+    sched.register_client("A");
+    std::thread::id ran_on;
+    sched.submit("A", [&] { ran_on = std::this_thread::get_id(); });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.step(), 1u);
+    EXPECT_EQ(ran_on, std::this_thread::get_id());
+    EXPECT_EQ(sched.get_client_metrics("A").executed, 1u);
+}
+
+// StepRunsAtMostN: step(n) stops at n jobs and at an empty scheduler
+TEST(ManualExecutor, StepRunsAtMostN) {
+    Scheduler sched;
+    sched.register_client("A");
+    int ran = 0;
+    for (int i = 0; i < 5; ++i) sched.submit("A", [&] { ++ran; });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.step(3), 3u);
+    EXPECT_EQ(ran, 3);
+    EXPECT_EQ(exec.step(10), 2u);
+    EXPECT_EQ(exec.step(), 0u);
+    EXPECT_EQ(exec.executed(), 5u);
+}
+
+// NestedSubmitsRunUntilIdle: jobs submitted by jobs are picked up by the same
+// run_until_idle() call
+TEST(ManualExecutor, NestedSubmitsRunUntilIdle) {
+    Scheduler sched;
+    sched.register_client("A");
+    int ran = 0;
+    std::function<void(int)> spawn = [&](int depth) {
+        ++ran;
+        if (depth > 0) {
+            sched.submit("A", [&, depth] { spawn(depth - 1); });
+            sched.submit("A", [&, depth] { spawn(depth - 1); });
+        }
+    };
+    sched.submit("A", [&] { spawn(4); });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.run_until_idle(), 31u);
+    EXPECT_EQ(ran, 31);
+    EXPECT_FALSE(sched.has_pending_jobs());
+}
+
+// ManualClockDrivesDeadlines: a job only expires once the injected clock has
+// moved past its deadline, regardless of wall time. Job timestamps have
+// microsecond resolution.
+TEST(ManualExecutor, ManualClockDrivesDeadlines) {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+    sched.register_client("A");
+
+    bool first = false, second = false;
+    sched.submit("A", [&] { first = true; }, 1, Priority::NORMAL, clock->now() + 10ms);
+    sched.submit("A", [&] { second = true; }, 1, Priority::NORMAL, clock->now() + 10ms);
+
+    ManualExecutor exec(sched);
+    clock->advance(10ms); // exactly at the deadline: still runnable
+    EXPECT_EQ(exec.step(), 1u);
+    EXPECT_TRUE(first);
+
+    clock->advance(1us);
+    EXPECT_EQ(exec.step(), 0u);
+    EXPECT_FALSE(second);
+    EXPECT_EQ(sched.get_client_metrics("A").expired_count, 1u);
+}
+
+// ManualClockMeasuresExecution: execution time is taken from the injected
+// clock, so a job that advances it by 250µs records exactly 250µs
+TEST(ManualExecutor, ManualClockMeasuresExecution) {
+    auto clock = std::make_shared<ManualClock>();
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+    sched.register_client("A");
+    sched.submit("A", [&] { clock->advance(250us); });
+    sched.submit("A", [&] { clock->advance(750us); });
+
+    ManualExecutor exec(sched);
+    exec.run_until_idle();
+    EXPECT_DOUBLE_EQ(sched.get_client_metrics("A").avg_execution_time_us, 500.0);
+}
+
+// MatchesSingleWorkerPool: with the workload queued up front, the manual
+// executor runs jobs in exactly the order a one-worker ThreadPool does
+class ManualExecutorOrder : public ::testing::TestWithParam<bool> {};
+
+TEST_P(ManualExecutorOrder, MatchesSingleWorkerPool) {
+    auto make_policy = [&]() -> std::unique_ptr<ISchedulingPolicy> {
+        if (GetParam()) return std::make_unique<DeficitRoundRobinPolicy>();
+        return std::make_unique<WeightedRoundRobinPolicy>();
+    };
+
+    std::vector<std::string> threaded;
+    {
+        Scheduler sched(make_policy());
+        submit_mixed_workload(sched, threaded);
+        ThreadPool pool(sched, 1);
+        pool.shutdown();
+    }
+
+    std::vector<std::string> manual;
+    {
+        Scheduler sched(make_policy(), std::make_shared<ManualClock>());
+        submit_mixed_workload(sched, manual);
+        ManualExecutor exec(sched);
+        exec.run_until_idle();
+    }
+
+    ASSERT_EQ(threaded.size(), 36u);
+    EXPECT_EQ(manual, threaded);
+}
+
+INSTANTIATE_TEST_SUITE_P(Policies, ManualExecutorOrder, ::testing::Values(false, true),
+                         [](const auto& info) { return info.param ? "DRR" : "WRR"; });
+
+// NullClockThrows: the clock constructor rejects a null clock
+TEST(ManualExecutor, NullClockThrows) {
+    EXPECT_THROW(Scheduler(std::make_unique<WeightedRoundRobinPolicy>(), nullptr),
+                 std::invalid_argument);
+}
@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/manual_executor.h"
+#include "job_system/map_reduce.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+
+namespace {
+
+// Lines of words drawn from a skewed vocabulary
+std::vector<std::string> make_lines(size_t lines, size_t words_per_line, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::geometric_distribution<int> word(0.01);
+    std::vector<std::string> out(lines);
+    for (auto& line : out) {
+        for (size_t w = 0; w < words_per_line; ++w) {
+            if (w) line += ' ';
+            line += "w" + std::to_string(word(rng));
+        }
+    }
+    return out;
+}
+
+void split_words(std::string_view line, MapReduce<std::string, uint64_t>::Emitter& out) {
+    size_t start = 0;
+    while (start < line.size()) {
+        size_t end = std::min(line.find(' ', start), line.size());
+        if (end > start) out.emit(std::string(line.substr(start, end - start)), 1);
+        start = end + 1;
+    }
+}
+
+uint64_t sum(const std::string&, std::vector<uint64_t>& counts) {
+    return std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+}
+
+std::map<std::string, uint64_t> serial_count(const std::vector<std::string>& lines) {
+    std::map<std::string, uint64_t> counts;
+    for (const auto& line : lines) {
+        size_t start = 0;
+        while (start < line.size()) {
+            size_t end = std::min(line.find(' ', start), line.size());
+            if (end > start) ++counts[line.substr(start, end - start)];
+            start = end + 1;
+        }
+    }
+    return counts;
+}
+
+std::map<std::string, uint64_t> as_map(const std::vector<std::pair<std::string, uint64_t>>& v) {
+    std::map<std::string, uint64_t> m;
+    for (const auto& [k, c] : v) EXPECT_TRUE(m.emplace(k, c).second) << "duplicate key " << k;
+    return m;
+}
+
+class MapReduceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sched.register_client("mr");
+        pool = std::make_unique<ThreadPool>(sched, 4);
+        // Unique per test and process: ctest runs each test as its own
+        // process, possibly in parallel
+        const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+        spill_dir = std::filesystem::temp_directory_path() /
+                    ("job_system_mr_test_" + std::string(test->name()) + "_" +
+                     std::to_string(std::random_device{}()));
+        std::filesystem::create_directories(spill_dir);
+    }
+    void TearDown() override {
+        pool->shutdown();
+        std::filesystem::remove_all(spill_dir);
+    }
+    bool spill_dir_empty() const { return std::filesystem::is_empty(spill_dir); }
+
+    Scheduler sched;
+    std::unique_ptr<ThreadPool> pool;
+    std::filesystem::path spill_dir;
+};
+
+// A count whose codec reads back the key of every record but, from the
+// tenth record on, only half of the value: a spill file cut mid-record
+struct Chopped {
+    uint64_t n{0};
+};
+std::atomic<int> chopped_reads{0};
+
+} // namespace
+
+template <>
+struct job_system::SpillCodec<Chopped> {
+    static size_t write(std::FILE* f, const Chopped& c) { return SpillCodec<uint64_t>::write(f, c.n); }
+    static bool read(std::FILE* f, Chopped& c) {
+        if (chopped_reads.fetch_add(1) < 10) return SpillCodec<uint64_t>::read(f, c.n);
+        uint32_t half = 0;
+        std::fread(&half, sizeof half, 1, f);
+        return false;
+    }
+};
+
+// WordCountMatchesSerial: without a combiner every emitted record reaches a
+// reduce task, and each key is reduced exactly once
+TEST_F(MapReduceTest, WordCountMatchesSerial) {
+    const auto lines = make_lines(2000, 20, 1);
+    MapReduce<std::string, uint64_t> mr(sched.get_scheduler("mr").with_bulk_chunks(4));
+    const auto counts = mr.run(lines.begin(), lines.end(), split_words, sum);
+
+    EXPECT_EQ(as_map(counts), serial_count(lines));
+    const auto& st = mr.stats();
+    EXPECT_EQ(st.input_records, 2000u);
+    EXPECT_EQ(st.emitted, 2000u * 20u);
+    EXPECT_EQ(st.shuffled, st.emitted);
+    EXPECT_EQ(st.output_keys, counts.size());
+    EXPECT_EQ(st.map_tasks, 16u);
+    EXPECT_EQ(st.reduce_tasks, 16u);
+    EXPECT_EQ(st.spills, 0u);
+}
+
+// CombinerShrinksTheShuffle: map tasks fold repeated keys, so at most one
+// record per key and map task is shuffled
+TEST_F(MapReduceTest, CombinerShrinksTheShuffle) {
+    const auto lines = make_lines(2000, 20, 2);
+    MapReduceOptions opts;
+    opts.map_tasks = 8;
+    opts.partitions = 5;
+    MapReduce<std::string, uint64_t> mr(sched.get_scheduler("mr").with_bulk_chunks(4), opts);
+    mr.set_combiner([](uint64_t a, uint64_t b) { return a + b; });
+    const auto counts = mr.run(lines.begin(), lines.end(), split_words, sum);
+
+    EXPECT_EQ(as_map(counts), serial_count(lines));
+    const auto& st = mr.stats();
+    EXPECT_EQ(st.reduce_tasks, 5u);
+    EXPECT_LE(st.shuffled, 8u * counts.size());
+    EXPECT_LT(st.shuffled, st.emitted / 4);
+}
+
+// SpillsUnderMemoryLimit: a small per-task limit sends records through spill
+// files, with and without a combiner; results are unchanged and the files
+// are gone afterwards
+TEST_F(MapReduceTest, SpillsUnderMemoryLimit) {
+    const auto lines = make_lines(1000, 20, 3);
+    const auto expect = serial_count(lines);
+    for (bool combine : {false, true}) {
+        MapReduceOptions opts;
+        opts.memory_limit_bytes = 4096;
+        opts.spill_dir = spill_dir.string();
+        MapReduce<std::string, uint64_t> mr(sched.get_scheduler("mr").with_bulk_chunks(4), opts);
+        if (combine) mr.set_combiner([](uint64_t a, uint64_t b) { return a + b; });
+        const auto counts = mr.run(lines.begin(), lines.end(), split_words, sum);
+
+        EXPECT_EQ(as_map(counts), expect) << combine;
+        EXPECT_GT(mr.stats().spills, 0u) << combine;
+        EXPECT_GT(mr.stats().spilled_bytes, 0u) << combine;
+        EXPECT_TRUE(spill_dir_empty()) << combine;
+    }
+}
+
+// SpillsHoldNoDescriptors: with many partitions spilling, the number of open
+// files stays flat instead of growing with map tasks × partitions
+TEST_F(MapReduceTest, SpillsHoldNoDescriptors) {
+    const std::filesystem::path fds = "/proc/self/fd";
+    if (!std::filesystem::exists(fds)) GTEST_SKIP() << "no /proc/self/fd";
+    auto open_files = [&] {
+        return std::distance(std::filesystem::directory_iterator(fds),
+                             std::filesystem::directory_iterator());
+    };
+    const auto lines = make_lines(1000, 20, 7);
+    MapReduceOptions opts;
+    opts.map_tasks = 8;
+    opts.partitions = 256;
+    opts.memory_limit_bytes = 4096;
+    opts.spill_dir = spill_dir.string();
+    MapReduce<std::string, uint64_t> mr(sched.get_scheduler("mr").with_bulk_chunks(4), opts);
+    const auto before = open_files();
+    std::atomic<long> most{0};
+    auto map = [&](const std::string& line, MapReduce<std::string, uint64_t>::Emitter& out) {
+        split_words(line, out);
+        const long now = static_cast<long>(open_files());
+        for (long m = most.load(); now > m && !most.compare_exchange_weak(m, now);) {}
+    };
+    const auto counts = mr.run(lines.begin(), lines.end(), map, sum);
+
+    EXPECT_EQ(as_map(counts), serial_count(lines));
+    EXPECT_GT(mr.stats().spills, 0u);
+    EXPECT_LT(most.load() - before, 16); // a few per thread, not 8 × 256
+    EXPECT_TRUE(spill_dir_empty());
+}
+
+// MapErrorIsRethrownAndSpillsRemoved: an exception from map fails run() and
+// leaves no spill files behind
+TEST_F(MapReduceTest, MapErrorIsRethrownAndSpillsRemoved) {
+    const auto lines = make_lines(1000, 20, 4);
+    MapReduceOptions opts;
+    opts.memory_limit_bytes = 1024;
+    opts.spill_dir = spill_dir.string();
+    MapReduce<std::string, uint64_t> mr(sched.get_scheduler("mr").with_bulk_chunks(4), opts);
+    auto map = [&](const std::string& line, MapReduce<std::string, uint64_t>::Emitter& out) {
+        split_words(line, out);
+        if (line == lines[900]) throw std::runtime_error("bad line");
+    };
+    EXPECT_THROW(mr.run(lines.begin(), lines.end(), map, sum), std::runtime_error);
+    EXPECT_TRUE(spill_dir_empty());
+}
+
+// TruncatedSpillFailsRun: a spill record that does not read back in full
+// fails run() instead of being dropped from the reduce input
+TEST_F(MapReduceTest, TruncatedSpillFailsRun) {
+    const auto lines = make_lines(1000, 20, 6);
+    MapReduceOptions opts;
+    opts.memory_limit_bytes = 1024;
+    opts.spill_dir = spill_dir.string();
+    using Chop = MapReduce<std::string, Chopped>;
+    Chop mr(sched.get_scheduler("mr").with_bulk_chunks(4), opts);
+    auto map = [](const std::string& line, Chop::Emitter& out) {
+        for (size_t start = 0; start < line.size();) {
+            const size_t end = std::min(line.find(' ', start), line.size());
+            out.emit(line.substr(start, end - start), Chopped{1});
+            start = end + 1;
+        }
+    };
+    auto reduce = [](const std::string&, std::vector<Chopped>& v) {
+        return Chopped{static_cast<uint64_t>(v.size())};
+    };
+    chopped_reads = 0;
+    try {
+        mr.run(lines.begin(), lines.end(), map, reduce);
+        ADD_FAILURE() << "run() ignored a truncated spill file";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("Truncated spill file"), std::string::npos)
+            << e.what();
+    }
+    EXPECT_TRUE(spill_dir_empty());
+}
+
+// SpillWriteFailureThrows: a write the device refuses (a full disk) is an
+// error, not just fewer bytes in the stats
+TEST(MapReduce, SpillWriteFailureThrows) {
+    std::FILE* f = std::fopen("/dev/full", "wb");
+    if (!f) GTEST_SKIP() << "no /dev/full";
+    std::setvbuf(f, nullptr, _IONBF, 0); // fail at fwrite rather than at fclose
+    EXPECT_THROW(SpillCodec<std::string>::write(f, "record"), std::runtime_error);
+    EXPECT_THROW(SpillCodec<uint64_t>::write(f, 42), std::runtime_error);
+    std::fclose(f);
+}
+
+// TasksRunAsJobsOfTheClient: map and reduce tasks are submitted to the
+// client, and a run started from one of its tasks completes on a single
+// executor thread
+TEST(MapReduce, TasksRunAsJobsOfTheClient) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("mr");
+    const auto lines = make_lines(100, 10, 5);
+    std::map<std::string, uint64_t> got;
+    sched.submit("mr", [&] {
+        MapReduce<std::string, uint64_t> mr(sched.get_scheduler("mr").with_bulk_chunks(2));
+        got = as_map(mr.run(lines.begin(), lines.end(), split_words, sum));
+    });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.step(), 1u);
+    EXPECT_EQ(got, serial_count(lines));
+    EXPECT_EQ(sched.get_client_metrics("mr").submitted, 1u + 2u); // one helper per phase
+}
+
+// MemoryLimitNeedsCodec: spilling a type without a SpillCodec is refused up front
+TEST(MapReduce, MemoryLimitNeedsCodec) {
+    Scheduler sched;
+    sched.register_client("mr");
+    MapReduceOptions opts;
+    opts.memory_limit_bytes = 1 << 20;
+    using Unspillable = MapReduce<int, std::vector<int>>;
+    EXPECT_THROW(Unspillable(sched.get_scheduler("mr"), opts), std::invalid_argument);
+    EXPECT_NO_THROW(Unspillable(sched.get_scheduler("mr")));
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/execution.h"
+#include "job_system/manual_executor.h"
+#include "job_system/parallel.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+
+namespace {
+
+std::vector<int> random_ints(size_t n, int max, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(0, max);
+    std::vector<int> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+class ParallelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sched.register_client("A");
+        pool = std::make_unique<ThreadPool>(sched, 4);
+    }
+    void TearDown() override { pool->shutdown(); }
+
+    Scheduler sched;
+    std::unique_ptr<ThreadPool> pool;
+};
+
+} // namespace
+
+// MatchesSerialAlgorithms: every algorithm agrees with its STL counterpart
+// for empty, tiny, odd-sized and large ranges
+TEST_F(ParallelTest, MatchesSerialAlgorithms) {
+    const auto cs = sched.get_scheduler("A").with_bulk_chunks(4);
+    for (size_t n : {size_t{0}, size_t{1}, size_t{7}, size_t{100'003}}) {
+        const auto in = random_ints(n, 1000, static_cast<unsigned>(n));
+
+        std::vector<int> out(n), expect(n);
+        par::transform(cs, in.begin(), in.end(), out.begin(), [](int x) { return x * 3 + 1; });
+        std::transform(in.begin(), in.end(), expect.begin(), [](int x) { return x * 3 + 1; });
+        EXPECT_EQ(out, expect) << n;
+
+        par::transform(cs, in.begin(), in.end(), expect.begin(), out.begin(), std::minus<>());
+        std::transform(in.begin(), in.end(), expect.begin(), expect.begin(), std::minus<>());
+        EXPECT_EQ(out, expect) << n;
+
+        EXPECT_EQ(par::reduce(cs, in.begin(), in.end(), int64_t{5}),
+                  std::accumulate(in.begin(), in.end(), int64_t{5}))
+            << n;
+
+        par::inclusive_scan(cs, in.begin(), in.end(), out.begin());
+        std::inclusive_scan(in.begin(), in.end(), expect.begin());
+        EXPECT_EQ(out, expect) << n;
+
+        std::vector<int> inplace = in;
+        par::inclusive_scan(cs, inplace.begin(), inplace.end(), inplace.begin(),
+                            [](int a, int b) { return std::max(a, b); });
+        std::inclusive_scan(in.begin(), in.end(), expect.begin(),
+                            [](int a, int b) { return std::max(a, b); });
+        EXPECT_EQ(inplace, expect) << n;
+
+        std::vector<std::atomic<int>> hits(n);
+        par::for_each(cs, hits.begin(), hits.end(), [](std::atomic<int>& h) { ++h; });
+        EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](auto& h) { return h == 1; })) << n;
+    }
+}
+
+// SortsAnyRunCount: odd run counts leave an unpaired run in a merge round;
+// duplicates and a custom comparator must survive the merge-path splits
+TEST_F(ParallelTest, SortsAnyRunCount) {
+    for (size_t chunks : {size_t{2}, size_t{3}, size_t{4}, size_t{7}}) {
+        const auto cs = sched.get_scheduler("A").with_bulk_chunks(chunks);
+        for (size_t n : {size_t{500}, size_t{10'000}, size_t{200'001}}) {
+            auto v = random_ints(n, 50, static_cast<unsigned>(n + chunks));
+            auto expect = v;
+            par::sort(cs, v.begin(), v.end(), std::greater<>());
+            std::sort(expect.begin(), expect.end(), std::greater<>());
+            ASSERT_EQ(v, expect) << "chunks=" << chunks << " n=" << n;
+        }
+    }
+}
+
+// WorkIsChargedToTheClient: helpers are ordinary jobs of the given client at
+// its priority; other clients see none of them
+TEST_F(ParallelTest, WorkIsChargedToTheClient) {
+    sched.register_client("B");
+    const auto cs = sched.get_scheduler("A").with_bulk_chunks(4);
+    std::vector<int> v(40'000, 1);
+    EXPECT_EQ(par::reduce(cs, v.begin(), v.end(), 0), 40'000);
+    EXPECT_EQ(sched.get_client_metrics("A").submitted, 3u);
+    EXPECT_EQ(sched.get_client_metrics("B").submitted, 0u);
+}
+
+// CallerFinishesWithoutWorkers: a call from inside a task of a single-threaded
+// executor completes on the calling task; the queued helpers run later and
+// find nothing to do
+TEST(Parallel, CallerFinishesWithoutWorkers) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    const auto cs = sched.get_scheduler("A").with_bulk_chunks(4);
+    std::vector<int> v(1000);
+    std::iota(v.begin(), v.end(), 0);
+    int64_t sum = 0;
+    sched.submit("A", [&] { sum = par::reduce(cs, v.begin(), v.end(), int64_t{0}); });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.step(), 1u);
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    EXPECT_EQ(exec.run_until_idle(), 3u);
+}
+
+// RejectedHelpersOnlyCostParallelism: a full REJECT client leaves every chunk
+// to the caller
+TEST(Parallel, RejectedHelpersOnlyCostParallelism) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A", 1, /*max_depth=*/1, OverflowStrategy::REJECT);
+    const auto cs = sched.get_scheduler("A").with_bulk_chunks(4);
+    std::vector<int> v(5000, 2);
+    par::transform(cs, v.begin(), v.end(), v.begin(), [](int x) { return x * x; });
+    EXPECT_TRUE(std::all_of(v.begin(), v.end(), [](int x) { return x == 4; }));
+    EXPECT_EQ(sched.get_client_metrics("A").queue_depth, 1u);
+}
+
+// HelpersOnlyTakeFreeSlots: a full client keeps its queued job whatever its
+// overflow strategy; the call neither blocks, evicts nor runs it inline
+TEST(Parallel, HelpersOnlyTakeFreeSlots) {
+    for (auto strategy : {OverflowStrategy::BLOCK, OverflowStrategy::DROP_OLDEST,
+                          OverflowStrategy::CALLER_RUNS}) {
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(),
+                        std::make_shared<ManualClock>());
+        sched.register_client("A", 1, /*max_depth=*/2, strategy);
+        int queued_ran = 0;
+        sched.submit("A", [&] { ++queued_ran; });
+        const auto cs = sched.get_scheduler("A").with_bulk_chunks(4);
+        std::vector<int> v(5000, 3);
+        par::transform(cs, v.begin(), v.end(), v.begin(), [](int x) { return x + 1; });
+        EXPECT_TRUE(std::all_of(v.begin(), v.end(), [](int x) { return x == 4; }));
+        EXPECT_EQ(queued_ran, 0);
+        EXPECT_EQ(sched.get_client_metrics("A").queue_depth, 2u); // one helper
+        EXPECT_EQ(sched.get_client_metrics("A").overflow_count, 0u);
+
+        ManualExecutor exec(sched);
+        EXPECT_EQ(exec.run_until_idle(), 2u);
+        EXPECT_EQ(queued_ran, 1);
+    }
+}
+
+// FirstExceptionIsRethrown: an exception from the callable is rethrown by the
+// call once every started chunk has finished
+TEST_F(ParallelTest, FirstExceptionIsRethrown) {
+    const auto cs = sched.get_scheduler("A").with_bulk_chunks(4);
+    std::vector<int> v(10'000);
+    std::iota(v.begin(), v.end(), 0);
+    EXPECT_THROW(par::for_each(cs, v.begin(), v.end(), [](int x) {
+                     if (x == 6'000) throw std::runtime_error("bad element");
+                 }),
+                 std::runtime_error);
+    EXPECT_THROW(par::sort(cs, v.begin(), v.end(), [](int a, int b) -> bool {
+                     if (a == 42 || b == 42) throw std::logic_error("no 42");
+                     return a < b;
+                 }),
+                 std::logic_error);
+}
@@ -0,0 +1,119 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/completion_queue.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/submit_buffer.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+
+namespace {
+
+struct Order {
+    uint64_t id;
+    uint32_t qty;
+    uint16_t venue;
+};
+
+std::vector<Order> g_orders;
+std::vector<size_t> g_sizes;
+
+void record_order(const std::byte* payload) { g_orders.push_back(load_payload<Order>(payload)); }
+
+void record_nonzero(const std::byte* payload) {
+    size_t n = 0;
+    while (n < Job::RAW_PAYLOAD_BYTES && payload[n] != std::byte{0}) ++n;
+    g_sizes.push_back(n);
+}
+
+void fail(const std::byte*) { throw std::runtime_error("raw handler failed"); }
+
+class RawJobTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_orders.clear();
+        g_sizes.clear();
+        sched.register_client("A");
+    }
+    Scheduler sched{std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>()};
+};
+
+} // namespace
+
+// PayloadIsCopiedInline: the handler sees the value as it was at submit
+// time, in priority order with closure jobs of the same client
+TEST_F(RawJobTest, PayloadIsCopiedInline) {
+    Order order{42, 7, 3};
+    sched.submit_raw("A", &record_order, order);
+    order.qty = 0; // the job holds its own copy
+    sched.submit_raw("A", &record_order, Order{43, 1, 1}, 1, Priority::HIGH);
+    bool closure_ran = false;
+    sched.submit("A", [&] { closure_ran = true; });
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.run_until_idle(), 3u);
+    EXPECT_TRUE(closure_ran);
+    ASSERT_EQ(g_orders.size(), 2u);
+    EXPECT_EQ(g_orders[0].id, 43u);
+    EXPECT_EQ(g_orders[1].id, 42u);
+    EXPECT_EQ(g_orders[1].qty, 7u);
+    EXPECT_EQ(g_orders[1].venue, 3u);
+}
+
+// ByteSpanPayloadIsZeroPadded: up to RAW_PAYLOAD_BYTES bytes are accepted
+// and the rest of the payload reads as zero; larger payloads are refused
+TEST_F(RawJobTest, ByteSpanPayloadIsZeroPadded) {
+    std::array<std::byte, Job::RAW_PAYLOAD_BYTES + 1> bytes;
+    bytes.fill(std::byte{0xAB});
+    sched.submit_raw("A", &record_nonzero, std::span(bytes).first(5));
+    sched.submit_raw("A", &record_nonzero, std::span(bytes).first(Job::RAW_PAYLOAD_BYTES));
+    sched.submit_raw("A", &record_nonzero, std::span<const std::byte>{});
+    EXPECT_THROW(sched.submit_raw("A", &record_nonzero, std::span<const std::byte>(bytes)),
+                 std::invalid_argument);
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.run_until_idle(), 3u);
+    EXPECT_EQ(g_sizes, (std::vector<size_t>{5, Job::RAW_PAYLOAD_BYTES, 0}));
+}
+
+// OutcomesMatchClosureJobs: raw jobs report to completion queues, fail,
+// cancel and pass through a SubmitBuffer like any other job
+TEST_F(RawJobTest, OutcomesMatchClosureJobs) {
+    CompletionQueue cq(8);
+    auto raw_job = [&](Job::RawHandler handler, uint64_t tag) {
+        Job job;
+        job.set_raw(handler, std::as_bytes(std::span(&tag, 1)));
+        job.set_completion(&cq, tag);
+        return job;
+    };
+    sched.submit("A", raw_job(&record_order, 1));
+    sched.submit("A", raw_job(&fail, 2));
+    sched.submit("A", raw_job(&record_order, 3));
+    EXPECT_TRUE(sched.cancel_job(3));
+    SubmitBuffer buf(sched);
+    const uint64_t buffered = buf.submit_raw("A", &record_order, Order{9, 9, 9});
+    buf.flush();
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.run_until_idle(), 3u);
+    std::array<Completion, 8> out;
+    ASSERT_EQ(cq.harvest(out), 3u);
+    EXPECT_EQ(out[0].user_tag, 3u);
+    EXPECT_EQ(out[0].status, CompletionStatus::CANCELLED);
+    EXPECT_EQ(out[1].user_tag, 1u);
+    EXPECT_EQ(out[1].status, CompletionStatus::COMPLETED);
+    EXPECT_EQ(out[2].user_tag, 2u);
+    EXPECT_EQ(out[2].status, CompletionStatus::FAILED);
+    ASSERT_EQ(g_orders.size(), 2u);
+    EXPECT_EQ(g_orders[1].id, 9u);
+    EXPECT_GT(buffered, 3u);
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/event_log.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/spawn_tree.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string temp_log_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<LogEvent> read_events(const std::string& path) {
+    EventLogReader reader(path);
+    std::vector<LogEvent> out;
+    reader.for_each([&](const LogEvent& ev) { out.push_back(ev); });
+    return out;
+}
+
+} // namespace
+
+// LineagePropagatesThroughNestedSubmits: jobs submitted from a running task
+// get it as their parent; grandchildren keep the original root. Submits from
+// outside any task, or to a different scheduler, start a new tree.
+TEST(SpawnTree, LineagePropagatesThroughNestedSubmits) {
+    const std::string path = temp_log_path("job_system_spawn_lineage.bin");
+    std::map<uint64_t, uint64_t> seen_id; // tag → current_job_id() inside the task
+    {
+        auto clock = std::make_shared<ManualClock>();
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+        Scheduler other(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+        sched.register_client("A");
+        other.register_client("A");
+        sched.set_event_log(std::make_shared<EventLog>(path));
+        EXPECT_EQ(sched.current_job_id(), 0u);
+
+        sched.submit("A", [&] {                                   // 1
+            seen_id[1] = sched.current_job_id();
+            EXPECT_EQ(other.current_job_id(), 0u);
+            sched.submit("A", [&] {                               // 3
+                seen_id[3] = sched.current_job_id();
+                sched.submit("A", [&] { seen_id[5] = sched.current_job_id(); }); // 5
+            });
+            sched.submit("A", [&] { seen_id[4] = sched.current_job_id(); });     // 4
+            other.submit("A", [] {});                             // other's own tree
+        });
+        sched.submit("A", [] {});                                 // 2
+        ManualExecutor exec(sched);
+        EXPECT_EQ(exec.run_until_idle(), 5u);
+        EXPECT_EQ(sched.current_job_id(), 0u);
+        sched.set_event_log(nullptr);
+    }
+
+    EXPECT_EQ(seen_id, (std::map<uint64_t, uint64_t>{{1, 1}, {3, 3}, {4, 4}, {5, 5}}));
+
+    std::map<uint64_t, uint64_t> parent_of;
+    for (const auto& ev : read_events(path)) {
+        if (ev.type == EventType::SPAWN) parent_of[ev.job_id] = ev.extra;
+    }
+    EXPECT_EQ(parent_of, (std::map<uint64_t, uint64_t>{{3, 1}, {4, 1}, {5, 3}}));
+    std::filesystem::remove(path);
+}
+
+// CriticalPathSplitsQueueAndRun: with a manual clock, the tree's latency,
+// shape and the critical path's per-hop queue and run times are exact, and
+// queue + run along the path adds up to the end-to-end latency
+TEST(SpawnTree, CriticalPathSplitsQueueAndRun) {
+    const std::string path = temp_log_path("job_system_spawn_critical.bin");
+    auto clock = std::make_shared<ManualClock>();
+    const auto t0 = clock->now();
+    {
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+        sched.register_client("A");
+        sched.set_event_log(std::make_shared<EventLog>(path));
+
+        // t=0 root(1); runs at 5, spawns 2 at 7 and 3 at 8, done at 9.
+        // 2 runs 19–22. 3 runs at 22, spawns 4 at 26. 4 runs 27–33.
+        sched.submit("A", [&] {
+            clock->advance(2us);
+            sched.submit("A", [&] { clock->advance(3us); });
+            clock->advance(1us);
+            sched.submit("A", [&] {
+                clock->advance(4us);
+                sched.submit("A", [&] { clock->advance(6us); });
+                clock->advance(1us);
+            });
+            clock->advance(1us);
+        });
+        ManualExecutor exec(sched);
+        clock->advance(5us);
+        exec.step();
+        clock->advance(10us);
+        EXPECT_EQ(exec.run_until_idle(), 3u);
+        sched.set_event_log(nullptr);
+    }
+
+    SpawnTreeAnalyzer analyzer;
+    for (const auto& ev : read_events(path)) analyzer.add(ev);
+    const auto trees = analyzer.trees();
+    ASSERT_EQ(trees.size(), 1u);
+    const SpawnTree& t = trees[0];
+    EXPECT_EQ(t.root_id, 1u);
+    EXPECT_EQ(t.submit_ns, static_cast<uint64_t>(t0.time_since_epoch().count()));
+    EXPECT_EQ(t.latency_ns(), 33000u);
+    EXPECT_EQ(t.size, 4u);
+    EXPECT_EQ(t.depth, 2u);
+    EXPECT_EQ(t.max_fanout, 2u);
+
+    ASSERT_EQ(t.critical_path.size(), 3u);
+    const std::vector<uint64_t> ids = {t.critical_path[0].job_id, t.critical_path[1].job_id,
+                                       t.critical_path[2].job_id};
+    EXPECT_EQ(ids, (std::vector<uint64_t>{1, 3, 4}));
+    EXPECT_EQ(t.critical_path[0].queue_ns, 5000u);
+    EXPECT_EQ(t.critical_path[0].run_ns, 3000u);
+    EXPECT_EQ(t.critical_path[1].queue_ns, 14000u);
+    EXPECT_EQ(t.critical_path[1].run_ns, 4000u);
+    EXPECT_EQ(t.critical_path[2].queue_ns, 1000u);
+    EXPECT_EQ(t.critical_path[2].run_ns, 6000u);
+    EXPECT_EQ(t.path_queue_ns() + t.path_run_ns(), t.latency_ns());
+
+    auto fanouts = analyzer.fanouts();
+    std::sort(fanouts.begin(), fanouts.end());
+    EXPECT_EQ(fanouts, (std::vector<uint32_t>{1, 2}));
+    std::filesystem::remove(path);
+}
+
+// OrphansStartTheirOwnTree: when the log begins after a parent was submitted,
+// its children are grouped under the oldest ancestor the log knows about
+TEST(SpawnTree, OrphansStartTheirOwnTree) {
+    SpawnTreeAnalyzer analyzer;
+    auto ev = [](EventType type, uint64_t ts, uint64_t job, uint64_t extra = 0) {
+        LogEvent e;
+        e.type = type;
+        e.timestamp_ns = ts;
+        e.job_id = job;
+        e.extra = extra;
+        return e;
+    };
+    // Parent 7 was submitted before logging started
+    analyzer.add(ev(EventType::SPAWN, 10, 8, 7));
+    analyzer.add(ev(EventType::SUBMIT, 10, 8));
+    analyzer.add(ev(EventType::START, 12, 8));
+    analyzer.add(ev(EventType::SPAWN, 13, 9, 8));
+    analyzer.add(ev(EventType::SUBMIT, 13, 9));
+    analyzer.add(ev(EventType::COMPLETE, 14, 8));
+    analyzer.add(ev(EventType::START, 20, 9));
+    analyzer.add(ev(EventType::COMPLETE, 25, 9));
+
+    const auto trees = analyzer.trees();
+    ASSERT_EQ(trees.size(), 1u);
+    EXPECT_EQ(trees[0].root_id, 8u);
+    EXPECT_EQ(trees[0].size, 2u);
+    EXPECT_EQ(trees[0].latency_ns(), 15u);
+    EXPECT_EQ(trees[0].path_queue_ns(), 9u);
+    EXPECT_EQ(trees[0].path_run_ns(), 6u);
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/completion_queue.h"
+#include "job_system/event_log.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/submit_buffer.h"
+#include "job_system/thread_pool.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+int discard_hook_calls = 0;
+struct CountsDiscard {
+    void operator()() const {}
+    void on_discard() const { ++discard_hook_calls; }
+};
+
+} // namespace
+
+// IdsComeFromReservedBlocks: each buffer hands out consecutive ids from its
+// own block, distinct from other buffers and from direct submits, and jobs
+// reach the queue only when flushed
+TEST(SubmitBuffer, IdsComeFromReservedBlocks) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("A");
+    SubmitBufferOptions opts;
+    opts.id_block = 4;
+    SubmitBuffer a(sched, opts);
+    SubmitBuffer b(sched, opts);
+
+    std::vector<uint64_t> from_a, from_b;
+    for (int i = 0; i < 3; ++i) from_a.push_back(a.submit("A", [] {}));
+    for (int i = 0; i < 3; ++i) from_b.push_back(b.submit("A", [] {}));
+    for (int i = 0; i < 3; ++i) from_a.push_back(a.submit("A", [] {}));
+    EXPECT_EQ(from_a, (std::vector<uint64_t>{1, 2, 3, 4, 9, 10}));
+    EXPECT_EQ(from_b, (std::vector<uint64_t>{5, 6, 7}));
+    EXPECT_EQ(a.pending(), 6u);
+    EXPECT_EQ(sched.get_client_metrics("A").queue_depth, 0u);
+
+    EXPECT_EQ(a.flush(), 6u);
+    EXPECT_EQ(a.pending(), 0u);
+    EXPECT_EQ(a.flush(), 0u);
+    EXPECT_EQ(sched.get_client_metrics("A").queue_depth, 6u);
+    EXPECT_EQ(sched.get_client_metrics("A").submitted, 6u);
+    EXPECT_TRUE(sched.cancel_job(10));
+    EXPECT_FALSE(sched.cancel_job(7)); // still buffered in b
+}
+
+// FlushesWhenFullInOrder: reaching max_jobs flushes every client's batch;
+// each client runs its jobs in submission order, and jobs buffered by a
+// task keep it as their parent
+TEST(SubmitBuffer, FlushesWhenFullInOrder) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "job_system_submit_buffer.bin").string();
+    std::vector<std::string> ran;
+    std::map<uint64_t, uint64_t> parent_of;
+    {
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(),
+                        std::make_shared<ManualClock>());
+        sched.register_client("A");
+        sched.register_client("B");
+        sched.set_event_log(std::make_shared<EventLog>(path));
+        SubmitBufferOptions opts;
+        opts.max_jobs = 4;
+        SubmitBuffer buf(sched, opts);
+        auto queued = [&] {
+            return sched.get_client_metrics("A").queue_depth +
+                   sched.get_client_metrics("B").queue_depth;
+        };
+
+        const uint64_t parent = buf.submit("A", [&] {
+            ran.push_back("a0");
+            buf.submit("B", [&] { ran.push_back("b-child"); });
+            buf.flush();
+        });
+        buf.submit("B", [&] { ran.push_back("b0"); });
+        buf.submit("A", [&] { ran.push_back("a1"); });
+        EXPECT_EQ(queued(), 0u);
+        buf.submit("B", [&] { ran.push_back("b1"); }); // fourth: flushes
+        EXPECT_EQ(buf.pending(), 0u);
+        EXPECT_EQ(buf.flushes(), 1u);
+        EXPECT_EQ(queued(), 4u);
+
+        ManualExecutor exec(sched);
+        EXPECT_EQ(exec.run_until_idle(), 5u);
+        sched.set_event_log(nullptr);
+
+        EventLogReader reader(path);
+        reader.for_each([&](const LogEvent& ev) {
+            if (ev.type == EventType::SPAWN) parent_of[ev.job_id] = ev.extra;
+        });
+        ASSERT_EQ(parent_of.size(), 1u);
+        EXPECT_EQ(parent_of.begin()->second, parent);
+    }
+    std::filesystem::remove(path);
+
+    auto pos = [&](const char* s) { return std::find(ran.begin(), ran.end(), s) - ran.begin(); };
+    ASSERT_EQ(ran.size(), 5u);
+    EXPECT_LT(pos("a0"), pos("a1"));
+    EXPECT_LT(pos("b0"), pos("b1"));
+    EXPECT_LT(pos("b1"), pos("b-child"));
+}
+
+// TimerBoundsLatency: with max_delay set, a lone buffered job is flushed by
+// the timer without any further call on the buffer
+TEST(SubmitBuffer, TimerBoundsLatency) {
+    Scheduler sched;
+    sched.register_client("A");
+    ThreadPool pool(sched, 2);
+    SubmitBufferOptions opts;
+    opts.max_jobs = 1000;
+    opts.max_delay = 2ms;
+    SubmitBuffer buf(sched, opts);
+
+    for (int round = 0; round < 3; ++round) {
+        std::atomic<bool> ran{false};
+        buf.submit("A", [&] { ran = true; });
+        const auto give_up = std::chrono::steady_clock::now() + 5s;
+        while (!ran && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(1ms);
+        }
+        EXPECT_TRUE(ran) << round;
+        EXPECT_EQ(buf.pending(), 0u);
+    }
+    pool.shutdown();
+}
+
+// RefusedAtFlushAreDropped: a batch that does not fit goes through the
+// client's overflow strategy job by job; jobs refused there, or for an
+// unknown client, are reported as DROPPED instead of throwing
+TEST(SubmitBuffer, RefusedAtFlushAreDropped) {
+    Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), std::make_shared<ManualClock>());
+    sched.register_client("small", 1, /*max_depth=*/2, OverflowStrategy::REJECT);
+    sched.register_client("gone");
+    CompletionQueue cq(8);
+    SubmitBuffer buf(sched);
+
+    for (uint64_t tag = 1; tag <= 3; ++tag) {
+        Job job;
+        job.task = [] {};
+        job.set_completion(&cq, tag);
+        buf.submit("small", std::move(job));
+    }
+    Job orphan;
+    orphan.task = CountsDiscard{};
+    buf.submit("gone", std::move(orphan));
+    sched.unregister_client("gone");
+
+    EXPECT_EQ(buf.flush(), 4u);
+    EXPECT_EQ(buf.refused(), 2u);
+    EXPECT_EQ(sched.get_client_metrics("small").queue_depth, 2u);
+    EXPECT_EQ(sched.get_client_metrics("small").overflow_count, 1u);
+    EXPECT_EQ(discard_hook_calls, 1);
+
+    std::array<Completion, 8> out;
+    ASSERT_EQ(cq.harvest(out), 1u);
+    EXPECT_EQ(out[0].user_tag, 3u);
+    EXPECT_EQ(out[0].status, CompletionStatus::DROPPED);
+
+    ManualExecutor exec(sched);
+    EXPECT_EQ(exec.run_until_idle(), 2u);
+    EXPECT_EQ(cq.harvest(out), 2u);
+}
+
+// ManyProducersRunEveryJob: producer threads with their own buffers feed a
+// pool; every job runs exactly once and all ids are distinct
+TEST(SubmitBuffer, ManyProducersRunEveryJob) {
+    constexpr int kProducers = 4;
+    constexpr int kJobsEach = 5000;
+    Scheduler sched;
+    sched.register_client("A");
+    sched.register_client("B");
+    ThreadPool pool(sched, 4);
+
+    std::atomic<int> ran{0};
+    std::mutex ids_mutex;
+    std::set<uint64_t> ids;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            SubmitBufferOptions opts;
+            opts.max_jobs = 64;
+            opts.max_delay = 1ms;
+            SubmitBuffer buf(sched, opts);
+            std::vector<uint64_t> mine;
+            for (int i = 0; i < kJobsEach; ++i) {
+                mine.push_back(buf.submit((i + p) % 3 ? "A" : "B", [&] { ++ran; }));
+            }
+            buf.flush();
+            std::lock_guard lock(ids_mutex);
+            ids.insert(mine.begin(), mine.end());
+        });
+    }
+    for (auto& t : producers) t.join();
+    pool.shutdown(); // graceful: drains
+
+    EXPECT_EQ(ran.load(), kProducers * kJobsEach);
+    EXPECT_EQ(ids.size(), static_cast<size_t>(kProducers * kJobsEach));
+    EXPECT_EQ(sched.get_client_metrics("A").submitted + sched.get_client_metrics("B").submitted,
+              static_cast<uint64_t>(kProducers * kJobsEach));
+}
+
+// RejectsBadOptions: a zero flush threshold or id block is refused
+TEST(SubmitBuffer, RejectsBadOptions) {
+    Scheduler sched;
+    SubmitBufferOptions no_jobs;
+    no_jobs.max_jobs = 0;
+    EXPECT_THROW(SubmitBuffer(sched, no_jobs), std::invalid_argument);
+    SubmitBufferOptions no_ids;
+    no_ids.id_block = 0;
+    EXPECT_THROW(SubmitBuffer(sched, no_ids), std::invalid_argument);
+}
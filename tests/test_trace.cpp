@@ -0,0 +1,147 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "job_system/clock.h"
+#include "job_system/manual_executor.h"
+#include "job_system/scheduler.h"
+#include "job_system/thread_pool.h"
+#include "job_system/trace_recorder.h"
+#include "job_system/wrr_policy.h"
+
+using namespace job_system;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string temp_trace_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+// ArrivalsAndExecutionsRoundTrip: every submit and execution is read back with
+// its client, priority, cost and deadline intact
+TEST(Trace, ArrivalsAndExecutionsRoundTrip) {
+    const std::string path = temp_trace_path("job_system_trace_roundtrip.bin");
+    {
+        Scheduler sched;
+        sched.register_client("A", 3, 10, OverflowStrategy::DROP_NEWEST);
+        sched.register_client("B");
+        sched.set_trace_recorder(std::make_shared<TraceRecorder>(path));
+
+        auto deadline = std::chrono::steady_clock::now() + 60s;
+        sched.submit("A", [] {}, 7, Priority::HIGH, deadline);
+        sched.submit("B", [] {}, 1, Priority::LOW);
+        sched.submit("A", [] {});
+
+        ThreadPool pool(sched, 1);
+        pool.shutdown();
+    } // recorder flushed with the scheduler
+
+    TraceReader reader(path);
+    ASSERT_EQ(reader.clients().size(), 2u);
+    EXPECT_EQ(reader.clients()[0].name, "A");
+    EXPECT_EQ(reader.clients()[0].weight, 3u);
+    EXPECT_EQ(reader.clients()[0].max_queue_depth, 10u);
+    EXPECT_EQ(reader.clients()[0].overflow_strategy, OverflowStrategy::DROP_NEWEST);
+    EXPECT_EQ(reader.clients()[1].name, "B");
+
+    int arrivals = 0, executions = 0;
+    uint64_t last_ts = 0;
+    for (const auto& ev : reader.events()) {
+        EXPECT_GE(ev.timestamp_ns, last_ts); // timestamps are monotonic
+        last_ts = ev.timestamp_ns;
+        if (ev.type == TraceEvent::Type::ARRIVAL) {
+            ++arrivals;
+            if (ev.job_id == 1) {
+                EXPECT_EQ(ev.client, 0u);
+                EXPECT_EQ(ev.cost_hint, 7u);
+                EXPECT_EQ(ev.priority, Priority::HIGH);
+                EXPECT_TRUE(ev.has_deadline);
+                EXPECT_NEAR(static_cast<double>(ev.deadline_us), 60e6, 1e6);
+            } else {
+                EXPECT_FALSE(ev.has_deadline);
+            }
+        } else {
+            ++executions;
+        }
+    }
+    EXPECT_EQ(arrivals, 3);
+    EXPECT_EQ(executions, 3);
+    std::remove(path.c_str());
+}
+
+// RejectedArrivalsAreRecorded: the trace captures offered load, not just
+// admitted jobs
+TEST(Trace, RejectedArrivalsAreRecorded) {
+    const std::string path = temp_trace_path("job_system_trace_rejected.bin");
+    {
+        Scheduler sched;
+        sched.register_client("A", 1, 1, OverflowStrategy::REJECT);
+        sched.set_trace_recorder(std::make_shared<TraceRecorder>(path));
+        sched.submit("A", [] {});
+        EXPECT_THROW(sched.submit("A", [] {}), QueueFullException);
+        sched.drain_client("A");
+    }
+
+    TraceReader reader(path);
+    EXPECT_EQ(reader.events().size(), 2u);
+    std::remove(path.c_str());
+}
+
+// ManualClockTraceIsDeterministic: timestamps and deadlines come from the
+// Scheduler's clock, so a trace taken under a ManualClock is exact
+TEST(Trace, ManualClockTraceIsDeterministic) {
+    const std::string path = temp_trace_path("job_system_trace_manual.bin");
+    {
+        auto clock = std::make_shared<ManualClock>();
+        Scheduler sched(std::make_unique<WeightedRoundRobinPolicy>(), clock);
+        sched.register_client("A");
+        sched.set_trace_recorder(std::make_shared<TraceRecorder>(path));
+        clock->advance(5ms);
+        sched.submit("A", [] {}, 1, Priority::NORMAL, clock->now() + 2s);
+        clock->advance(3ms);
+        sched.submit("A", [&] { clock->advance(1ms); });
+        ManualExecutor exec(sched);
+        EXPECT_EQ(exec.run_until_idle(), 2u);
+    }
+
+    TraceReader reader(path);
+    ASSERT_EQ(reader.events().size(), 4u);
+    const auto& ev = reader.events();
+    EXPECT_EQ(ev[0].timestamp_ns, 5'000'000u);
+    EXPECT_EQ(ev[0].deadline_us, 2'000'000);
+    EXPECT_EQ(ev[1].timestamp_ns, 8'000'000u);
+    EXPECT_EQ(ev[2].type, TraceEvent::Type::EXECUTION);
+    EXPECT_EQ(ev[2].timestamp_ns, 8'000'000u);
+    EXPECT_EQ(ev[3].timestamp_ns, 9'000'000u);
+    EXPECT_EQ(ev[3].duration_us, 1000u);
+    std::remove(path.c_str());
+}
+
+// WriteFailureIsReported: a trace that cannot be written fails flush()
+// instead of leaving a silently truncated file
+TEST(Trace, WriteFailureIsReported) {
+    if (!std::filesystem::exists("/dev/full")) GTEST_SKIP() << "no /dev/full";
+    TraceRecorder recorder("/dev/full");
+    EXPECT_THROW(recorder.flush(), std::runtime_error);
+    EXPECT_THROW(recorder.flush(), std::runtime_error); // stays failed
+}
+
+// BadFileThrows: non-trace input is rejected up front
+TEST(Trace, BadFileThrows) {
+    const std::string path = temp_trace_path("job_system_trace_bad.bin");
+    {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        std::fputs("not a trace", f);
+        std::fclose(f);
+    }
+    EXPECT_THROW(TraceReader{path}, std::runtime_error);
+    std::remove(path.c_str());
+}